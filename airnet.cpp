@@ -0,0 +1,851 @@
+#include "airnet.h"
+#include "constants.h"
+#include <algorithm>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+/*
+* FlowNetwork - airflow network class constructor
+*/
+FlowNetwork::FlowNetwork() : windStage("wind pressures") {
+	finalized = false;
+	for(int z=0; z < NUM_BASE_ZONES; z++)
+		addZone();
+	for(int i=0; i < NUM_GROUPS; i++)
+		groupC[i] = 1;
+	for(int i=0; i < 4; i++) {
+		wallCp[i] = 0;
+		roofCp[i] = 0;
+		wallWeight[i] = 0;
+		roofCpTheta[i] = 0;
+		for(int j=0; j < 4; j++)
+			wallCpTheta[i][j] = 0;
+	}
+	for(int a=0; a < WIND_ANGLES; a++) {
+		for(int i=0; i < 4; i++) {
+			wallCpTable[a][i] = 0;
+			roofCpTable[a][i] = 0;
+		}
+	}
+	dPwind = 0;
+	roofPitch = 0;
+}
+
+/*
+* addZone - adds a zone to the network
+* @return index of the zone
+*/
+int FlowNetwork::addZone() {
+	P.push_back(0);
+	temp.push_back(airTempRef);
+	density.push_back(airDensityRef);
+	refHeight.push_back(0);
+	dPtemp.push_back(0);
+	first.push_back(vector<int>(NUM_ELEMENT_TYPES + 1, 0));
+	coupled.push_back(vector<int>());
+	finalized = false;
+	return P.size() - 1;
+}
+
+/*
+* add - adds a flow element to the network. Optional properties (cp, vc, group, etc.) are set by
+* the caller using the returned index before finalize() is called.
+* @param elementType - elementType
+* @param elementZone - zone whose mass balance the element belongs to
+* @param otherZone - zone on the other side of the element (ZONE_OUTSIDE for the envelope)
+* @param elementRole - elementRole
+* @param inputIndex - index of the element in the input data
+* @param C - flow coefficient (m3/s/Pa^n) or fan flow (m3/s)
+* @param exponent - pressure exponent
+* @param h - element height (m), bottom of cracks and openings
+* @param hTop - top of cracks and openings (m)
+* @return index of the element
+*/
+int FlowNetwork::add(int elementType, int elementZone, int otherZone, int elementRole, int inputIndex, double C, double exponent, double h, double hTop) {
+	type.push_back(elementType);
+	zone.push_back(elementZone);
+	other.push_back(otherZone);
+	role.push_back(elementRole);
+	link.push_back(inputIndex);
+	cp.push_back(CP_NONE);
+	wall.push_back(0);
+	vc.push_back(VC_NONE);
+	group.push_back(GROUP_NONE);
+	on.push_back(1);
+	coef.push_back(C);
+	n.push_back(exponent);
+	hLow.push_back(h);
+	hHigh.push_back(hTop);
+	cpFixed.push_back(0);
+	tFix.push_back(0);
+	height.push_back(0);
+	width.push_back(0);
+	finalized = false;
+	return type.size() - 1;
+}
+
+template <class T> static void permute(vector<T>& v, vector<int>& order) {
+	vector<T> sorted(order.size());
+	for(size_t i=0; i < order.size(); i++)
+		sorted[i] = v[order[i]];
+	v.swap(sorted);
+}
+
+/*
+* finalize - sorts the element tables by zone and type and sizes the working tables.
+* Must be called after the last element is added and before the network is solved.
+*/
+void FlowNetwork::finalize() {
+	int numElements = type.size();
+	vector<int> order(numElements);
+	vector<int> key(numElements);
+
+	for(int e=0; e < numElements; e++) {
+		order[e] = e;
+		key[e] = zone[e] * NUM_ELEMENT_TYPES + type[e];
+	}
+	stable_sort(order.begin(), order.end(), [&key](int a, int b) { return key[a] < key[b]; });
+
+	permute(type, order);
+	permute(zone, order);
+	permute(other, order);
+	permute(role, order);
+	permute(link, order);
+	permute(cp, order);
+	permute(wall, order);
+	permute(vc, order);
+	permute(group, order);
+	permute(on, order);
+	permute(coef, order);
+	permute(n, order);
+	permute(hLow, order);
+	permute(hHigh, order);
+	permute(cpFixed, order);
+	permute(tFix, order);
+	permute(height, order);
+	permute(width, order);
+
+	// first[z][t] is the first element of zone z with type >= t
+	int e = 0;
+	for(int z=0; z < numZones(); z++) {
+		for(int t=0; t < NUM_ELEMENT_TYPES; t++) {
+			first[z][t] = e;
+			while(e < numElements && zone[e] == z && type[e] == t)
+				e++;
+		}
+		first[z][NUM_ELEMENT_TYPES] = e;
+	}
+
+	for(int z=0; z < numZones(); z++)
+		coupled[z].clear();
+	for(int e=0; e < numElements; e++) {
+		if(other[e] != ZONE_OUTSIDE)
+			coupled[other[e]].push_back(e);
+	}
+
+	Cp.assign(numElements, 0);
+	kIn.assign(numElements, 0);
+	kOut.assign(numElements, 0);
+	logKIn.assign(numElements, 0);
+	logKOut.assign(numElements, 0);
+	dP0.assign(numElements, 0);
+	dP1.assign(numElements, 0);
+	dP.assign(numElements, 0);
+	dPt.assign(numElements, 0);
+	Abottom.assign(numElements, 0);
+	Atop.assign(numElements, 0);
+	m.assign(numElements, 0);
+	mIn.assign(numElements, 0);
+	mOut.assign(numElements, 0);
+	dmdP.assign(numElements, 0);
+	windStage.invalidate();
+	finalized = true;
+}
+
+/*
+* setCpTheta - sets the wall and roof pressure coefficients for wind perpendicular to each face
+* @param rowHouse - house is in a row
+* @param roofPeakPerpendicular - roof peak is perpendicular to the front of the house (wall 1)
+* @param pitch - roof pitch (degrees)
+*/
+void FlowNetwork::setCpTheta(bool rowHouse, bool roofPeakPerpendicular, double pitch) {
+	roofPitch = pitch;
+	windStage.invalidate();
+
+	// the following are some typical pressure coefficients for rectangular houses
+	for(int i=0; i < 4; i++) {
+		wallCpTheta[i][0] = .6;
+		wallCpTheta[i][1] = -.3;
+	}
+	// here the variation of each wall Cp with wind angle is accounted for:
+	if(rowHouse) {
+		wallCpTheta[0][2] = -.2;
+		wallCpTheta[0][3] = -.2;
+		wallCpTheta[1][2] = -.2;
+		wallCpTheta[1][3] = -.2;
+		wallCpTheta[2][2] = -.65;
+		wallCpTheta[2][3] = -.65;
+		wallCpTheta[3][2] = -.65;
+		wallCpTheta[3][3] = -.65;
+	} else {
+		// for isolated houses
+		for(int i=0; i < 4; i++) {
+			wallCpTheta[i][2] = -.65;
+			wallCpTheta[i][3] = -.65;
+		}
+	}
+
+	// the following are some typical pressure coefficients for pitched roofs
+	if(roofPitch < 10) {
+		roofCpTheta[0] = -.8;
+		roofCpTheta[1] = -.4;
+	} else if(roofPitch > 30) {
+		roofCpTheta[0] = .3;
+		roofCpTheta[1] = -.5;
+	} else {
+		roofCpTheta[0] = -.4;
+		roofCpTheta[1] = -.4;
+	}
+	if(rowHouse) {
+		roofCpTheta[2] = -.2;
+		roofCpTheta[3] = -.2;
+	} else {
+		// for isolated houses
+		roofCpTheta[2] = -.6;
+		roofCpTheta[3] = -.6;
+	}
+	if(roofPeakPerpendicular) {
+		roofCpTheta[2] = roofCpTheta[0];
+		roofCpTheta[3] = roofCpTheta[1];
+		if(rowHouse) {
+			roofCpTheta[0] = -.2;
+			roofCpTheta[1] = -.2;
+		} else {
+			// for isolated houses
+			roofCpTheta[0] = -.6;
+			roofCpTheta[1] = -.6;
+		}
+	}
+
+	// the Cps only depend on the wind direction from here on
+	for(int angle=0; angle < WIND_ANGLES; angle++) {
+		f_CpTheta(wallCpTheta, angle, wallCpTable[angle]);
+		f_roofCpTheta(roofCpTheta, angle, roofCpTable[angle], roofPitch);
+	}
+}
+
+/*
+* setWind - sets the wind pressure on every element. Outside air density must be set first.
+* @param windSpeed - wind speed at eave height (m/s)
+* @param windAngle - wind direction (degrees)
+* @param Sw - square of the wall shelter factors
+*/
+void FlowNetwork::setWind(double windSpeed, int windAngle, double* Sw) {
+	double CpWalls = 0;
+
+	windStage.input(windSpeed);
+	windStage.input(windAngle);
+	windStage.input(density[ZONE_OUTSIDE]);
+	for(int i=0; i < 4; i++)
+		windStage.input(Sw[i]);
+	if(windStage.reuse())
+		return;
+	windStage.keep();
+
+	dPwind = density[ZONE_OUTSIDE] / 2 * pow(windSpeed, 2);
+	if(windAngle >= 0 && windAngle < WIND_ANGLES) {
+		for(int i=0; i < 4; i++) {
+			wallCp[i] = wallCpTable[windAngle][i];
+			roofCp[i] = roofCpTable[windAngle][i];
+		}
+	} else {
+		f_CpTheta(wallCpTheta, windAngle, wallCp);
+		f_roofCpTheta(roofCpTheta, windAngle, roofCp, roofPitch);
+	}
+
+	for(int i=0; i < 4; i++)
+		CpWalls = CpWalls + Sw[i] * wallCp[i] * wallWeight[i];			// Shielding weighted Cp
+
+	for(int e=0; e < size(); e++) {
+		switch(cp[e]) {
+		case CP_FIXED:
+			Cp[e] = cpFixed[e];
+			break;
+		case CP_WALL:
+			Cp[e] = Sw[wall[e]] * wallCp[wall[e]];
+			break;
+		case CP_ROOF:
+			Cp[e] = Sw[wall[e]] * roofCp[wall[e]];
+			break;
+		case CP_WALLS:
+			Cp[e] = CpWalls;
+			break;
+		default:
+			Cp[e] = 0;
+		}
+	}
+}
+
+/*
+* setZone - sets the air temperature and density of a zone
+* @param zone - zone index
+* @param temperature - air temperature (deg K)
+* @param airDensity - air density (kg/m3)
+*/
+void FlowNetwork::setZone(int z, double temperature, double airDensity) {
+	temp[z] = temperature;
+	density[z] = airDensity;
+}
+
+/*
+* prepare - computes the parts of the element flow equations that do not depend on the zone pressure
+* @param z - zone index
+*/
+void FlowNetwork::prepare(int z) {
+	for(int i=0; i < numZones(); i++)
+		dPtemp[i] = density[ZONE_OUTSIDE] * g * (temp[i] - temp[ZONE_OUTSIDE]) / temp[i];
+
+	for(int e=first[z][0]; e < first[z][NUM_ELEMENT_TYPES]; e++) {
+		int o = other[e];
+		double C = coef[e] * groupC[group[e]];
+		double stack = dPtemp[z] - dPtemp[o];
+		double exponent = 3 * n[e] - 2;
+		double corrIn = 1;
+		double corrOut = 1;
+
+		switch(vc[e]) {
+		case VC_UPSTREAM:
+			corrIn = pow(airTempRef / temp[o], exponent);
+			corrOut = pow(airTempRef / temp[z], exponent);
+			break;
+		case VC_DOWNSTREAM:
+			corrIn = pow(airTempRef / temp[z], exponent);
+			corrOut = pow(airTempRef / temp[o], exponent);
+			break;
+		case VC_FIXED:
+			corrIn = pow(airTempRef / tFix[e], exponent);
+			corrOut = corrIn;
+			break;
+		}
+		kIn[e] = density[o] * C * corrIn;
+		kOut[e] = density[z] * C * corrOut;
+		if(type[e] == FE_ORIFICE) {
+			logKIn[e] = logCoefficient(kIn[e]);
+			logKOut[e] = logCoefficient(kOut[e]);
+		}
+
+		dP0[e] = Cp[e] * dPwind - hLow[e] * stack;
+		dP1[e] = Cp[e] * dPwind - hHigh[e] * stack;
+		if(vc[e] == VC_FIXED)		// for a heated flue:  driving pressure correction
+			dP0[e] = dP0[e] - g * density[z] * hLow[e] * (1 - temp[z] / tFix[e]);
+	}
+}
+
+/*
+* zoneFlows - evaluates the flow elements owned by a zone at the current zone pressures
+* @param z - zone index
+* @param mIN - sum of flows into the zone (kg/s)
+* @param mOUT - sum of flows out of the zone (kg/s, -ve)
+* @return derivative of the zone net mass flow with respect to the zone pressure (kg/s/Pa)
+*/
+double FlowNetwork::zoneFlows(int z, double& mIN, double& mOUT) {
+	double Pz = P[z];
+	double dmdPz = 0;
+
+	// raw pointers to the element tables keep the inner loops tight
+	const int* otherZone = other.data();
+	const double* exponent = n.data();
+	const double* in = kIn.data();
+	const double* out = kOut.data();
+	const double* logIn = logKIn.data();
+	const double* logOut = logKOut.data();
+	const double* dPbottom = dP0.data();
+	const double* dPtop = dP1.data();
+	const int* open = on.data();
+	double* dPe = dP.data();
+	double* dPet = dPt.data();
+	double* Ab = Abottom.data();
+	double* At = Atop.data();
+	double* me = m.data();
+	double* meIn = mIn.data();
+	double* meOut = mOut.data();
+	double* dme = dmdP.data();
+
+	mIN = 0;
+	mOUT = 0;
+
+	// orifices: the pressure differences are found first and the power law kernel does all the powers in one call
+	int e0 = first[z][FE_ORIFICE];
+	int count = first[z][FE_ORIFICE + 1] - e0;
+	for(int e=e0; e < e0 + count; e++)
+		dPe[e] = Pz - P[otherZone[e]] + dPbottom[e];
+	powerLawFlows(count, dPe + e0, exponent + e0, in + e0, out + e0, logIn + e0, logOut + e0, me + e0, dme + e0);
+	for(int e=e0; e < e0 + count; e++) {
+		me[e] = open[e] * me[e];
+		dme[e] = open[e] * dme[e];
+		if(me[e] >= 0)
+			mIN = mIN + me[e];
+		else
+			mOUT = mOUT + me[e];
+		dmdPz = dmdPz + dme[e];
+	}
+
+	// cracks: integrated over the height of the crack with the neutral level splitting inflow and outflow
+	e0 = first[z][FE_CRACK];
+	count = first[z][FE_CRACK + 1] - e0;
+	for(int e=e0; e < e0 + count; e++) {
+		dPe[e] = Pz - P[otherZone[e]] + dPbottom[e];
+		dPet[e] = Pz - P[otherZone[e]] + dPtop[e];
+	}
+	powerLaw(count, dPe + e0, exponent + e0, Ab + e0);
+	powerLaw(count, dPet + e0, exponent + e0, At + e0);
+	for(int e=e0; e < e0 + count; e++) {
+		double dPb = dPe[e];
+		double dPt = dPet[e];
+		double Abottom = Ab[e];
+		double Atop = At[e];
+		double stack = dPtemp[z] - dPtemp[otherZone[e]];
+
+		if(stack == 0) {
+			if(dPb > 0) {
+				meIn[e] = in[e] * Abottom;
+				meOut[e] = 0;
+			} else {
+				meIn[e] = 0;
+				meOut[e] = -out[e] * Abottom;
+			}
+			dme[e] = (dPb != 0) ? exponent[e] * (meIn[e] + meOut[e]) / dPb : 0;
+		} else {
+			// F = dP|dP|^n is integrated over the height, dF/dP = (n + 1)|dP|^n
+			double K = 1 / (hHigh[e] - hLow[e]) / stack / (exponent[e] + 1);
+			double Fbottom = dPb * Abottom;
+			double Ftop = dPt * Atop;
+
+			if(max(dPb, dPt) <= 0) {				// outflow over the whole height
+				meIn[e] = 0;
+				meOut[e] = out[e] * K * (Ftop - Fbottom);
+				dme[e] = out[e] * K * (exponent[e] + 1) * (Atop - Abottom);
+			} else if(min(dPb, dPt) >= 0) {		// inflow over the whole height
+				meIn[e] = -in[e] * K * (Ftop - Fbottom);
+				meOut[e] = 0;
+				dme[e] = -in[e] * K * (exponent[e] + 1) * (Atop - Abottom);
+			} else {										// neutral level within the crack
+				meIn[e] = in[e] * abs(K) * max(Fbottom, Ftop);
+				meOut[e] = out[e] * abs(K) * min(Fbottom, Ftop);
+				dme[e] = (in[e] * max(Abottom, Atop) + out[e] * min(Abottom, Atop)) * abs(K) * (exponent[e] + 1);
+			}
+		}
+		meIn[e] = open[e] * meIn[e];
+		meOut[e] = open[e] * meOut[e];
+		dme[e] = open[e] * dme[e];
+		me[e] = meIn[e] + meOut[e];
+		mIN = mIN + meIn[e];
+		mOUT = mOUT + meOut[e];
+		dmdPz = dmdPz + dme[e];
+	}
+
+	// large openings, the derivative is found numerically
+	for(int e=first[z][FE_OPENING]; e < first[z][FE_OPENING + 1]; e++) {
+		winDoor_struct winDoor = {0};
+		double Pint = Pz - P[other[e]];
+		double stack = dPtemp[z] - dPtemp[other[e]];
+		double dPdelta = .001;
+		double mDelta;
+
+		winDoor.Bottom = hLow[e];
+		winDoor.Top = hHigh[e];
+		winDoor.High = height[e];
+		winDoor.Wide = width[e];
+		f_winDoorFlow(temp[z], temp[other[e]], density[z], density[other[e]], refHeight[z], Cp[e], n[e], Pint, stack, dPwind, winDoor);
+		mIn[e] = on[e] * winDoor.mIN;
+		mOut[e] = on[e] * winDoor.mOUT;
+		m[e] = mIn[e] + mOut[e];
+		mIN = mIN + mIn[e];
+		mOUT = mOUT + mOut[e];
+
+		Pint = Pint + dPdelta;
+		f_winDoorFlow(temp[z], temp[other[e]], density[z], density[other[e]], refHeight[z], Cp[e], n[e], Pint, stack, dPwind, winDoor);
+		mDelta = on[e] * winDoor.m;
+		dmdP[e] = (mDelta - m[e]) / dPdelta;
+		dmdPz = dmdPz + dmdP[e];
+	}
+
+	// fans
+	for(int e=first[z][FE_FAN]; e < first[z][FE_FAN + 1]; e++) {
+		if(coef[e] < 0)
+			m[e] = on[e] * density[z] * coef[e];
+		else
+			m[e] = on[e] * density[other[e]] * coef[e];
+		dmdP[e] = 0;
+		if(m[e] >= 0)
+			mIN = mIN + m[e];
+		else
+			mOUT = mOUT + m[e];
+	}
+
+	return dmdPz;
+}
+
+/*
+* coupledFlows - adds the flows through elements owned by other zones at their last evaluation
+* @param z - zone index
+* @param mIN - sum of flows into the zone (kg/s)
+* @param mOUT - sum of flows out of the zone (kg/s, -ve)
+*/
+void FlowNetwork::coupledFlows(int z, double& mIN, double& mOUT) {
+	for(size_t i=0; i < coupled[z].size(); i++) {
+		double mCoupled = -m[coupled[z][i]];
+		if(mCoupled >= 0)
+			mIN = mIN + mCoupled;
+		else
+			mOUT = mOUT + mCoupled;
+	}
+}
+
+/*
+* solve - finds the zone pressure that balances the zone mass flows.
+* Newton iteration on the zone mass balance safeguarded by bisection: the net flow into a zone always increases with P
+* so the solution stays bracketed by the pressures where the net flow changed sign.
+* The search starts from the current P[z] (clipped to the bracket) and the element flows are left at the last evaluated pressure.
+* @param z - zone index
+* @param Plow - lowest zone pressure searched (Pa)
+* @param Phigh - highest zone pressure searched (Pa)
+* @param dPmin - pressure change at which the search stops (Pa)
+* @param mFixedIn - fixed mass flows into the zone, e.g. supply registers (kg/s)
+* @param mFixedOut - fixed mass flows out of the zone, e.g. return registers (kg/s, -ve)
+* @param mIN - sum of flows into the zone (kg/s)
+* @param mOUT - sum of flows out of the zone (kg/s, -ve)
+* @return number of flow evaluations
+*/
+int FlowNetwork::solve(int z, double Plow, double Phigh, double dPmin, double mFixedIn, double mFixedOut, double& mIN, double& mOUT) {
+	const int maxIterations = 100;
+	double Pnew;
+	double dPold = Phigh - Plow;		// size of the step before last
+	double dPstep = dPold;				// size of the last step
+	double mNet, dmdPz;
+	int iterations = 0;
+
+	if(!finalized)
+		finalize();
+
+	prepare(z);
+	P[z] = min(max(P[z], Plow), Phigh);
+	do {
+		dmdPz = zoneFlows(z, mIN, mOUT);
+		coupledFlows(z, mIN, mOUT);
+		mIN = mIN + mFixedIn;
+		mOUT = mOUT + mFixedOut;
+		mNet = mIN + mOUT;
+		iterations++;
+
+		if(mNet > 0)			// too much inflow, the solution is at a lower pressure
+			Phigh = P[z];
+		else
+			Plow = P[z];
+
+		dPold = dPstep;
+		Pnew = (dmdPz > 0) ? P[z] - mNet / dmdPz : Plow - 1;
+		if(Pnew <= Plow || Pnew >= Phigh || abs(2 * mNet) > abs(dPold * dmdPz)) {
+			// Newton step leaves the bracket or is not converging quickly enough
+			Pnew = (Plow + Phigh) / 2;
+		}
+		dPstep = abs(Pnew - P[z]);
+		P[z] = Pnew;
+	} while(dPstep > dPmin && Phigh - Plow > dPmin && iterations < maxIterations);
+
+	return iterations;
+}
+
+/*
+* zoneResiduals - evaluates the net flow into each zone of a group. The elements of every zone are evaluated
+* before the coupled flows are added so flows between zones of the group are consistent.
+* @param zones - zone indices
+* @param mNet - net mass flow into each zone (kg/s)
+* @param dmdPz - derivative of mNet with respect to the pressure of the zone itself (kg/s/Pa)
+* @return largest absolute net flow (kg/s)
+*/
+double FlowNetwork::zoneResiduals(vector<int>& zones, vector<double>& mNet, vector<double>& dmdPz) {
+	double mIN, mOUT;
+	double mMax = 0;
+
+	for(size_t i=0; i < zones.size(); i++) {
+		dmdPz[i] = zoneFlows(zones[i], mIN, mOUT);
+		mNet[i] = mIN + mOUT;
+	}
+	for(size_t i=0; i < zones.size(); i++) {
+		mIN = 0;
+		mOUT = 0;
+		coupledFlows(zones[i], mIN, mOUT);
+		mNet[i] = mNet[i] + mIN + mOUT;
+		mMax = max(mMax, abs(mNet[i]));
+	}
+	return mMax;
+}
+
+/*
+* solveZones - finds the pressures of a group of zones together, the pressures of all other zones are held fixed.
+* Newton iteration on the zone mass balances: the Jacobian only has entries for zones joined by a flow element
+* so it is solved as a sparse matrix and the cost grows with the number of connections rather than the cube of the
+* number of zones. Steps that increase the largest mass imbalance are halved.
+* @param zones - zone indices
+* @param dPmin - pressure change at which the search stops (Pa)
+* @return number of Newton iterations
+*/
+int FlowNetwork::solveZones(vector<int>& zones, double dPmin) {
+	const int maxIterations = 100;
+	const double maxStep = 50;			// largest pressure change in one iteration (Pa)
+	int numSolved = zones.size();
+	vector<int> row(numZones(), -1);
+	vector<double> mNet(numSolved), dmdPz(numSolved), Pold(numSolved), dP(numSolved);
+	SparseMatrix& J = jacobian;
+	double mMax, mMaxNew;
+	int iterations = 0;
+
+	if(!finalized)
+		finalize();
+	if(numSolved == 0)
+		return 0;
+
+	for(int i=0; i < numSolved; i++) {
+		row[zones[i]] = i;
+		prepare(zones[i]);
+	}
+	mMax = zoneResiduals(zones, mNet, dmdPz);
+	if(J.size() != numSolved)
+		J.resize(numSolved);
+
+	while(iterations < maxIterations) {
+		iterations++;
+
+		// Jacobian of the net flows into the zones
+		J.clear();
+		for(int i=0; i < numSolved; i++) {
+			int z = zones[i];
+			J[i][i] = dmdPz[i];
+			for(int e=first[z][0]; e < first[z][NUM_ELEMENT_TYPES]; e++) {
+				if(row[other[e]] >= 0)
+					J[i][row[other[e]]] -= dmdP[e];
+			}
+			for(size_t c=0; c < coupled[z].size(); c++) {
+				int e = coupled[z][c];
+				J[i][i] += dmdP[e];
+				if(row[zone[e]] >= 0)
+					J[i][row[zone[e]]] -= dmdP[e];
+			}
+			if(J[i][i] <= 0)		// no pressure dependent flows (fans only or everything closed)
+				J[i][i] = 1e-9;
+			dP[i] = -mNet[i];
+			Pold[i] = P[z];
+		}
+		J.solve(dP);
+
+		double step = 0;
+		for(int i=0; i < numSolved; i++) {
+			dP[i] = min(max(dP[i], -maxStep), maxStep);
+			step = max(step, abs(dP[i]));
+		}
+
+		for(int tries=0; tries < 10; tries++) {
+			for(int i=0; i < numSolved; i++)
+				P[zones[i]] = Pold[i] + dP[i];
+			mMaxNew = zoneResiduals(zones, mNet, dmdPz);
+			if(mMaxNew <= mMax)
+				break;
+			for(int i=0; i < numSolved; i++)
+				dP[i] = dP[i] / 2;
+			step = step / 2;
+		}
+		mMax = mMaxNew;
+
+		if(step <= dPmin)
+			break;
+	}
+
+	return iterations;
+}
+
+/*
+* inOut - splits the flow through an element into its inflow and outflow parts
+* @param e - element index
+* @param mIN - flow into the zone that owns the element (kg/s)
+* @param mOUT - flow out of the zone that owns the element (kg/s, -ve)
+*/
+void FlowNetwork::inOut(int e, double& mIN, double& mOUT) {
+	if(type[e] == FE_CRACK || type[e] == FE_OPENING) {
+		mIN = mIn[e];
+		mOUT = mOut[e];
+	} else {
+		mIN = max(m[e], 0.0);
+		mOUT = min(m[e], 0.0);
+	}
+}
+
+void f_CpTheta(double CP[4][4], int& windAngle, double* wallCp) {
+	// this function takes Cps from a single wind angle perpendicular to the
+	// upwind wall and finds Cps for all the walls for any wind angle
+	
+	double CPvar = 0;
+	double Theta = 0;
+	
+	for(int i=0; i < 4; i++) {
+		Theta = windAngle * M_PI / 180;
+		
+		if(i == 1) {
+			Theta = Theta - M_PI;
+		} else if(i == 2) {
+			Theta = Theta - .5 * M_PI;
+		} else if(i == 3) {
+			Theta = Theta - 1.5 * M_PI;
+		}
+		
+		CPvar = (CP[i][0] + CP[i][1]) * pow(pow(cos(Theta),2),.25);
+		CPvar = CPvar + (CP[i][0] - CP[i][1]) * cos(Theta) * pow(abs(cos(Theta)),-.25);
+		CPvar = CPvar + (CP[i][2] + CP[i][3]) * pow(pow(sin(Theta),2),2);
+		CPvar = CPvar + (CP[i][2] - CP[i][3]) * sin(Theta);
+		
+		wallCp[i] = CPvar / 2;
+	}
+}
+
+void f_winDoorFlow(double& tempHouse, double& tempOut, double& airDensityIN, double& airDensityOUT, double& eaveHeight,
+	double& wallCp, double& n, double& Pint, double& dPtemp, double& dPwind, winDoor_struct& winDoor) {
+
+		// calculates flow through open doors or windows
+
+		double dT;
+		double Awindoor;
+		double dummy;
+		double dummy1;
+		double dummy2;
+		double Viscosity;
+		double Kwindow;
+		double Kwindownew;
+		double Topcrit;
+		double Bottomcrit;
+		double Pwindow;
+		double ReH;
+
+		dT = tempHouse - tempOut;
+		winDoor.dPbottom = 2 * (dPwind * wallCp + Pint - winDoor.Bottom * dPtemp) / airDensityOUT;
+		winDoor.dPtop = 2 * (dPwind * wallCp + Pint - winDoor.Top * dPtemp) / airDensityOUT;
+		double Bo = f_neutralLevel(dPtemp, dPwind, Pint, wallCp, eaveHeight);
+
+		// winDoor.High and winDoor.Wide are not yet read in as inputs
+		if(dT == 0) {
+			Awindoor = winDoor.High * winDoor.Wide;
+			dummy = Pint + dPwind * wallCp;
+			if(dummy >= 0) {
+				winDoor.mIN = .6 * Awindoor * sqrt(dummy * airDensityOUT * 2);
+				winDoor.mOUT = 0;
+			} else {
+				winDoor.mIN = 0;
+				winDoor.mOUT = -.6 * Awindoor * sqrt(-dummy * airDensityIN * 2);
+			}
+		} else {
+			dummy1 = winDoor.dPbottom;
+			dummy2 = winDoor.dPtop;
+			if(Bo * eaveHeight <= winDoor.Bottom) {
+				Kwindow = .6;
+				dummy = dummy2 * sqrt(abs(dummy2)) - dummy1 * sqrt(abs(dummy1));
+				if(dT > 0) {
+					winDoor.mIN = 0;
+					winDoor.mOUT = sqrt(airDensityIN * airDensityOUT) * Kwindow * winDoor.Wide * tempHouse / 3 / g / dT * dummy;
+				} else {
+					winDoor.mIN = -airDensityOUT * Kwindow * winDoor.Wide * tempHouse / 3 / g / dT * dummy;
+					winDoor.mOUT = 0;
+				}
+			} else if(Bo * eaveHeight > winDoor.Top) {
+				Kwindow = .6;
+				dummy = dummy1 * sqrt(abs(dummy1)) - dummy2 * sqrt(abs(dummy2));
+				if(dT > 0) {
+					winDoor.mIN = airDensityOUT * Kwindow * winDoor.Wide * tempHouse / 3 / g / dT * dummy;
+					winDoor.mOUT = 0;
+				} else {
+					winDoor.mIN = 0;
+					winDoor.mOUT = -sqrt(airDensityOUT * airDensityIN) * Kwindow * winDoor.Wide * tempHouse / 3 / g / dT * dummy;
+				}
+			} else {
+				Viscosity = .0000133 + .0000009 * ((tempOut + tempHouse) / 2 - C_TO_K);
+				Kwindow = .4 + .0045 * dT;
+				Topcrit = winDoor.Top - .1 * winDoor.High;
+				Bottomcrit = winDoor.Bottom + .1 * winDoor.High;
+				if(Bo * eaveHeight > Topcrit) {
+					Pwindow = Topcrit * dPtemp - dPwind * wallCp;
+				} else if(Bo * eaveHeight < Bottomcrit) {
+					Pwindow = Bottomcrit * dPtemp - dPwind * wallCp;
+				} else {
+					Pwindow = Pint;
+				}
+				dummy1 = 2 * (dPwind * wallCp + Pwindow - winDoor.Bottom * dPtemp) / airDensityOUT;
+				dummy2 = 2 * (dPwind * wallCp + Pwindow - winDoor.Top * dPtemp) / airDensityOUT;
+				do {
+					Kwindownew = Kwindow;
+					if(dT > 0) {
+						winDoor.mIN = airDensityOUT * Kwindownew * winDoor.Wide * tempHouse / 3 / g / dT * dummy1 * sqrt(abs(dummy1));
+						winDoor.mOUT = sqrt(airDensityIN * airDensityOUT) * Kwindownew * winDoor.Wide * tempHouse / 3 / g / dT * dummy2 * sqrt(abs(dummy2));
+					} else {
+						winDoor.mIN = -airDensityOUT * Kwindownew * winDoor.Wide * tempHouse / 3 / g / dT * dummy2 * sqrt(abs(dummy2));
+						winDoor.mOUT = -sqrt(airDensityIN * airDensityOUT) * Kwindownew * winDoor.Wide * tempHouse / 3 / g / dT * dummy1 * sqrt(abs(dummy1));
+					}
+					ReH = 2 * abs(winDoor.mIN / airDensityOUT + winDoor.mOUT / airDensityIN) / winDoor.Wide / Viscosity;
+					Kwindow = (.3 + .6 * .00003 * ReH) / (1 + .00003 * ReH);
+				} while(!(abs(Kwindownew - Kwindow) < .001));
+
+				if(Bo * eaveHeight > Topcrit) {
+					Kwindow = (.6 - Kwindow) / (.1 * winDoor.High) * (eaveHeight * Bo - Topcrit) + Kwindow;
+				} else if(Bo * eaveHeight < Bottomcrit) {
+					Kwindow = (.6 - Kwindow) / (.1 * winDoor.High) * (Bottomcrit - eaveHeight * Bo) + Kwindow;
+				}
+				if(dT > 0) {
+					winDoor.mIN = airDensityOUT * Kwindow * winDoor.Wide * tempHouse / 3 / g / dT * dummy1 * sqrt(abs(dummy1));
+					winDoor.mOUT = sqrt(airDensityIN * airDensityOUT) * Kwindow * winDoor.Wide * tempHouse / 3 / g / dT * dummy2 * sqrt(abs(dummy2));
+				} else {
+					winDoor.mIN = -airDensityOUT * Kwindow * winDoor.Wide * tempHouse / 3 / g / dT * dummy2 * sqrt(abs(dummy2));
+					winDoor.mOUT = -sqrt(airDensityIN * airDensityOUT) * Kwindow * winDoor.Wide * tempHouse / 3 / g / dT * dummy1 * sqrt(abs(dummy1));
+				}
+			}
+		}
+
+		winDoor.m = winDoor.mIN + winDoor.mOUT;
+}
+
+void f_roofCpTheta(double* Cproof, int& windAngle, double* Cppitch, double& roofPitch) {
+	
+	double Theta;
+	double F, C, S;
+
+	for(int i=0; i < 4; i++) {
+		Theta = windAngle * M_PI / 180;
+		if(i == 1) {
+			Theta = Theta - M_PI;
+		} else if(i == 2) {
+			Theta = Theta - .5 * M_PI;
+		} else if(i == 3) {
+			Theta = Theta - 1.5 * M_PI;
+		}
+
+		S = sin(Theta);
+		C = cos(Theta);
+		if(roofPitch < 28)
+			F = C;
+		else
+			F = pow(C,5);
+
+		Cppitch[i] = (Cproof[0] + Cproof[1]) * pow(C,2);
+		Cppitch[i] = Cppitch[i] + (Cproof[0] - Cproof[1]) * F;
+		Cppitch[i] = Cppitch[i] + (Cproof[2] + Cproof[3]) * pow(S,2);
+		Cppitch[i] = Cppitch[i] + (Cproof[2] - Cproof[3]) * S;
+		Cppitch[i] = Cppitch[i] / 2;
+	}
+}
+
+// calculates the neutral level for a surface
+double f_neutralLevel(double dPtemp, double dPwind, double Pint, double Cpr, double h) {
+	if(dPtemp != 0)
+		return((Pint + dPwind * Cpr) / dPtemp / h);
+	else
+		return(0);
+}
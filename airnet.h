@@ -0,0 +1,157 @@
+#pragma once
+#ifndef airnet_h
+#define airnet_h
+
+#include <vector>
+#include "functions.h"
+#include "gauss.h"
+#include "lazy.h"
+#include "powerlaw.h"
+
+using namespace std;
+
+// Zones of the airflow network. Outside is always zone 0 and has zero reference pressure.
+// Further zones (crawlspaces, garages, other conditioned zones) are added with addZone().
+const int WIND_ANGLES = 361;			// wind directions are whole degrees 0 - 360
+
+enum zoneIndex { ZONE_OUTSIDE = 0, ZONE_HOUSE, ZONE_ATTIC, NUM_BASE_ZONES };
+
+// Flow element types. Elements of a zone are stored contiguously by type so each type
+// is evaluated in its own tight loop.
+enum elementType {
+	FE_ORIFICE = 0,	// power law leak at a single height: m = rho * C * dP^n
+	FE_CRACK,			// power law leak distributed uniformly between hLow and hHigh (walls, pitched roof)
+	FE_OPENING,			// large opening with two way flow (open windows and doors)
+	FE_FAN,				// fixed volumetric flow, coef = q (m3/s, +ve into the zone)
+	NUM_ELEMENT_TYPES
+};
+
+// Source of the element wind pressure coefficient
+enum cpSource {
+	CP_NONE = 0,		// no wind pressure
+	CP_FIXED,			// constant Cp in cpFixed (flues)
+	CP_WALL,				// shielded wall Cp of wall[e]
+	CP_ROOF,				// shielded pitched roof Cp of wall[e]
+	CP_WALLS				// leakage weighted average of the four shielded wall Cps (crawlspace)
+};
+
+// Density-viscosity correction pow(airTempRef / T, 3n - 2) applied to the element coefficient
+enum viscosityCorrection {
+	VC_NONE = 0,		// no correction
+	VC_UPSTREAM,		// T of the air entering the element
+	VC_DOWNSTREAM,		// T of the air leaving the element (unheated flues, as in the original BASIC code)
+	VC_FIXED				// fixed element temperature tFix (heated flues), also adds the flue buoyancy
+};
+
+// Leakage coefficient groups. The element coefficient is coef * groupC[group] so
+// envelope leakage can be changed during the run (economizer pressure relief)
+enum coefGroup { GROUP_NONE = 0, GROUP_ENVELOPE, GROUP_ATTIC, NUM_GROUPS };
+
+// What an element represents, used to pass individual flows back to the caller
+enum elementRole {
+	ROLE_NONE = 0, ROLE_FLUE, ROLE_FLOOR, ROLE_CEILING, ROLE_SUPAHOFF, ROLE_RETAHOFF, ROLE_WALL,
+	ROLE_FAN, ROLE_PIPE, ROLE_WINDOOR, ROLE_ROOF, ROLE_ATTICVENT, ROLE_SOFFIT, ROLE_ATTICFAN, ROLE_ZONE, ROLE_ZONELINK
+};
+
+/*
+* FlowNetwork
+*
+* Table driven airflow network. Each flow element connects a zone to another zone (or outside)
+* and is described by structure-of-arrays tables so the number of elements is only limited by the input.
+* The pressure of one zone at a time is found from the zone mass balance with the pressures of all other zones
+* held fixed, as the house and attic leakage models always did. Groups of zones can also be solved together by
+* Newton iteration on all their pressures using a sparse Jacobian.
+* Pressures follow the REGCAP convention: P is outside minus inside pressure at floor level so a +ve flow is into the zone.
+*/
+class FlowNetwork {
+	private:
+		vector< vector<int> > first;							// index of the first element of each zone/type, built by finalize()
+		vector< vector<int> > coupled;						// elements owned by another zone that flow into this one
+		double wallCpTheta[4][4];								// Cps for wind perpendicular to each wall
+		double roofCpTheta[4];									// Cps for wind perpendicular to the roof
+		double wallCpTable[WIND_ANGLES][4];					// wall Cps for each wind direction, built by setCpTheta
+		double roofCpTable[WIND_ANGLES][4];					// pitched roof Cps for each wind direction
+		bool finalized;
+		SparseMatrix jacobian;									// kept between calls of solveZones so its elimination order is only found once
+
+		void prepare(int zone);
+		double zoneFlows(int zone, double& mIN, double& mOUT);
+		void coupledFlows(int zone, double& mIN, double& mOUT);
+		double zoneResiduals(vector<int>& zones, vector<double>& mNet, vector<double>& dmdPz);
+
+	public:
+		// Element tables
+		vector<int> type;
+		vector<int> zone;					// zone whose mass balance the element belongs to
+		vector<int> other;				// zone on the other side of the element
+		vector<int> role;
+		vector<int> link;					// index of the element in the input data (wall number, fan number, etc.)
+		vector<int> cp;					// cpSource
+		vector<int> wall;					// wall index (0-3) for CP_WALL and CP_ROOF
+		vector<int> vc;					// viscosityCorrection
+		vector<int> group;				// coefGroup
+		vector<int> on;					// 0 = element closed/off
+		vector<double> coef;				// flow coefficient (m3/s/Pa^n) or fan flow (m3/s)
+		vector<double> n;					// pressure exponent
+		vector<double> hLow;				// element height (m), bottom of cracks and openings
+		vector<double> hHigh;			// top of cracks and openings (m)
+		vector<double> cpFixed;			// Cp for CP_FIXED elements
+		vector<double> tFix;				// element air temperature for VC_FIXED (deg K)
+		vector<double> height;			// opening height (m)
+		vector<double> width;			// opening width (m)
+
+		// Per call working tables
+		vector<double> Cp;				// wind pressure coefficient
+		vector<double> kIn;				// rho * C * viscosity correction for flow into the zone
+		vector<double> kOut;				// rho * C * viscosity correction for flow out of the zone
+		vector<double> logKIn;			// log of kIn and kOut for the power law kernel (orifices)
+		vector<double> logKOut;
+		vector<double> dP0;				// pressure difference at P = 0 (bottom of cracks)
+		vector<double> dP1;				// pressure difference at P = 0 at the top of cracks
+		vector<double> dP;				// pressure difference across the element (Pa)
+		vector<double> dPt;				// pressure difference at the top of cracks (Pa)
+		vector<double> Abottom;			// |dP|^n at the bottom and top of cracks
+		vector<double> Atop;
+		vector<double> m;					// net mass flow into the zone (kg/s)
+		vector<double> mIn;				// inflow part of m (kg/s)
+		vector<double> mOut;				// outflow part of m (kg/s)
+		vector<double> dmdP;				// derivative of m with respect to the zone pressure (kg/s/Pa)
+
+		// Zone state
+		vector<double> P;					// zone pressure (Pa)
+		vector<double> temp;				// zone air temperature (deg K)
+		vector<double> density;			// zone air density (kg/m3)
+		vector<double> refHeight;		// reference height for openings (m)
+		vector<double> dPtemp;			// stack pressure gradient relative to outside (Pa/m)
+		double groupC[NUM_GROUPS];		// leakage coefficient of each coefGroup
+		double dPwind;						// wind velocity pressure (Pa)
+		double wallCp[4];					// shielded Cp of each wall for the current wind angle
+		double roofCp[4];					// pitched roof Cp on each side for the current wind angle
+		double wallWeight[4];			// wall leakage fractions used to average Cp for CP_WALLS
+		double roofPitch;
+		LazyStage windStage;				// wind pressures are only set again when the wind or the shelter changes
+
+		FlowNetwork();
+		int addZone();
+		int add(int type, int zone, int other, int role, int link, double coef, double n, double hLow, double hHigh=0);
+		void finalize();
+		void setCpTheta(bool rowHouse, bool roofPeakPerpendicular, double pitch);
+		void setWind(double windSpeed, int windAngle, double* Sw);
+		void setZone(int zone, double temperature, double airDensity);
+		int solve(int zone, double Plow, double Phigh, double dPmin, double mFixedIn, double mFixedOut, double& mIN, double& mOUT);
+		int solveZones(vector<int>& zones, double dPmin);
+		void inOut(int e, double& mIN, double& mOUT);
+		int size() { return type.size(); }
+		int numZones() { return P.size(); }
+};
+
+void f_CpTheta(double CP[4][4], int& windAngle, double* wallCp);
+
+void f_roofCpTheta(double* Cproof, int& windAngle, double* Cppitch, double& roofPitch);
+
+void f_winDoorFlow(double& tempHouse, double& tempOut, double& airDensityIN, double& airDensityOUT, double& eaveHeight,
+	double& wallCp, double& n, double& Pint, double& dPtemp, double& dPwind, winDoor_struct& winDoor);
+
+double f_neutralLevel(double dPtemp, double dPwind, double Pint, double Cpr, double h);
+
+#endif
@@ -172,4 +172,28 @@ int Config::pInt(string name) {
 	string val = pString(name);
 
 	return atoi(val.c_str());
+}
+
+string Config::pString(string name, string def) {
+	if (symbols.find(name) == symbols.end())
+		return def;
+	return pString(name);
+}
+
+bool Config::pBool(string name, bool def) {
+	if (symbols.find(name) == symbols.end())
+		return def;
+	return pBool(name);
+}
+
+double Config::pDouble(string name, double def) {
+	if (symbols.find(name) == symbols.end())
+		return def;
+	return pDouble(name);
+}
+
+int Config::pInt(string name, int def) {
+	if (symbols.find(name) == symbols.end())
+		return def;
+	return pInt(name);
 }
\ No newline at end of file
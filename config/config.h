@@ -55,6 +55,12 @@ class Config {
 		// get int config entry; value is parsed using atoi()
 		int pInt(string name);
 
+		// the same, with a default for entries older config files do not have
+		string pString(string name, string def);
+		bool pBool(string name, bool def);
+		double pDouble(string name, double def);
+		int pInt(string name, int def);
+
 		// get the symbol map (e.g. for iterating over all symbols)
 		inline map<string, string>& getSymbols() {
 			return symbols;
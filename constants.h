@@ -9,8 +9,18 @@ const double airTempRef = C_TO_K + 20;	// Reference room temp [K] = 20 deg C
 const double g = 9.81;						// Acceleration due to gravity (m/s^2)
 const double SIGMA = 5.6704E-08;			// STEFAN-BOLTZMANN CONST (W/m^2/K^4)
 const double CpAir = 1005.7;				// specific heat of air [j/kg K]
-const double dtau = 60.;					// simulation timestep (in seconds)
+// Simulation timestep, fixed at build time (make STEP_SECONDS=30). Steps shorter than a minute divide the minute, longer
+// steps are whole minutes dividing the hour. The weather and fan schedules stay minute by minute.
+#ifndef STEP_SECONDS
+#define STEP_SECONDS 60
+#endif
+static_assert((STEP_SECONDS > 0 && 60 % STEP_SECONDS == 0) || (STEP_SECONDS % 60 == 0 && 3600 % STEP_SECONDS == 0),
+	"STEP_SECONDS has to divide the minute or be whole minutes dividing the hour");
+const double dtau = STEP_SECONDS;		// simulation timestep (in seconds)
 const double rivecdt = dtau / 3600.;	// Rivec timestep is in hours. Used in calculation of relative dose and exposure.
+const int STEPS_PER_HOUR = 3600 / STEP_SECONDS;
+const int STEPS_PER_DAY = 24 * STEPS_PER_HOUR;
+const double STEP_MINUTES = dtau / 60;	// minutes in a step, the per minute sums are scaled by it
 const int ATTIC_NODES = 18;				// number of attic nodes
 const double densityWood = 530.;       // Bulk wood density - douglas fir (kg/m3)
 const double densitySheathing = 650.;  // Shething wood density - OSB (kg/m3)
@@ -0,0 +1,56 @@
+#include <fstream>
+#include "control.h"
+
+using namespace std;
+
+/*
+* ControlSettings - ControlSettings constructor, no humidity control
+* @param occupancyControl - OccContType of the building
+* @param expLimit - largest relative exposure allowed while the house is unoccupied
+*/
+ControlSettings::ControlSettings(int occupancyControl, double expLimit) {
+	this->occupancyControl = occupancyControl;
+	this->expLimit = expLimit;
+	humidityControl = -1;
+	wCutoff = 0;
+	wDiffMaxNeg = 0;
+	wDiffMaxPos = 0;
+	for(int i = 0; i < 12; i++) {
+		W25[i] = 0;
+		W75[i] = 0;
+	}
+	FirstCut = 0;
+	SecondCut = 0;
+	doseTarget = 0;
+	HiDose = 0;
+	for(int i = 0; i < 3; i++) {
+		HiMonths[i] = 0;
+		LowMonths[i] = 0;
+	}
+	HiMonthDose = 0;
+	LowMonthDose = 0;
+}
+
+/*
+* readHumidityControl - reads the humidity control file of a building if there is one
+* @param fileName - humidity control file: HumContType, then wCutoff, wDiffMaxNeg, wDiffMaxPos, the 12 monthly W25 and
+* W75 values, FirstCut, SecondCut, doseTarget, HiDose, the 3 HiMonths and LowMonths, HiMonthDose and LowMonthDose
+* @return false if the file is there but not complete or the control type is unknown
+*/
+bool ControlSettings::readHumidityControl(string fileName) {
+	ifstream file(fileName);
+
+	if(!file)
+		return true;
+	file >> humidityControl;
+	file >> wCutoff >> wDiffMaxNeg >> wDiffMaxPos;
+	for(int i = 0; i < 12; i++)
+		file >> W25[i];
+	for(int i = 0; i < 12; i++)
+		file >> W75[i];
+	file >> FirstCut >> SecondCut >> doseTarget >> HiDose;
+	file >> HiMonths[0] >> HiMonths[1] >> HiMonths[2];
+	file >> LowMonths[0] >> LowMonths[1] >> LowMonths[2];
+	file >> HiMonthDose >> LowMonthDose;
+	return file && humidityControl >= 0 && humidityControl <= 16;
+}
@@ -0,0 +1,249 @@
+#pragma once
+#ifndef control_h
+#define control_h
+#include <string>
+#include "constants.h"
+
+using namespace std;
+
+// What a ventilation controller decides from
+struct ControlInputs {
+	int hour;
+	int month;
+	int occupied;				// house occupied this hour (0/1)
+	int hcFlag;					// 1 = heating season, 2 = cooling season
+	int AHflag;					// air handler mode, 2 = cooling
+	int rivecOn;				// current decision
+	double relExp;				// relative exposure
+	double relDose;			// relative dose
+	double HROut;				// outdoor humidity ratio
+	double HRHouse;			// house humidity ratio
+	double RHHouse;			// house relative humidity (%)
+};
+
+/*
+* ControlSettings
+*
+* Per building settings of the ventilation controllers. The humidity control climate data are read from the optional
+* humidity control file of the building: the control type followed by the climate zone values.
+*/
+struct ControlSettings {
+	int occupancyControl;	// OccContType, 2 = auxiliary fan control, 3 or 4 = occupancy control
+	double expLimit;			// largest relative exposure allowed while the house is unoccupied
+	int humidityControl;		// HumContType 0 - 16, -1 = no humidity control
+	double wCutoff;			// Humidity Ratio cut-off calculated as some percentile value for the climate zone
+	double wDiffMaxNeg;		// Maximum average indoor-outdoor humidity difference, when wIn < wOut. Climate zone average.
+	double wDiffMaxPos;		// Maximum average indoor-outdoor humidity difference, when wIn > wOut. Climate zone average.
+	double W25[12];			// 25th percentiles for each month of the year, per TMY3
+	double W75[12];			// 75th percentiles for each month of the year, per TMY3
+	int FirstCut;				// Monthly Indexes assigned based on climate zone
+	int SecondCut;
+	double doseTarget;		// Targeted dose value
+	double HiDose;				// Variable high dose value for real-time humidity control, based on worst-case large, low-occupancy home
+	int HiMonths[3];
+	int LowMonths[3];
+	double HiMonthDose;
+	double LowMonthDose;
+
+	ControlSettings(int occupancyControl, double expLimit);
+	bool readHumidityControl(string fileName);
+};
+
+/*
+* VentilationController
+*
+* Base of the controllers that decide whether the RIVEC whole house ventilation runs. A controller C derives from
+* VentilationController<C> and implements a static ventilate(), so the call to it is bound at compile time and a
+* strategy is a class with no virtual functions. withControls() picks the controller of a building once and the
+* simulation loop is compiled for it.
+*/
+template <class C> class VentilationController {
+	public:
+		static int decide(const ControlSettings& settings, const ControlInputs& in) {
+			return C::ventilate(settings, in);
+		}
+
+	protected:
+		// on when the exposure or the dose is too high
+		static int exposureOrDose(const ControlInputs& in, double expLimit, double doseLimit) {
+			return (in.relExp >= expLimit || in.relDose > doseLimit) ? 1 : 0;
+		}
+};
+
+// No control, the decision stays as it is
+class NoVentilationControl : public VentilationController<NoVentilationControl> {
+	public:
+		static int ventilate(const ControlSettings& settings, const ControlInputs& in) {
+			return in.rivecOn;
+		}
+};
+
+// Auxiliary fan control (OccContType 2)
+class AuxiliaryFanControl : public VentilationController<AuxiliaryFanControl> {
+	public:
+		static int ventilate(const ControlSettings& settings, const ControlInputs& in) {
+			return exposureOrDose(in, 1.0, 1.0);
+		}
+};
+
+// Occupancy control only (OccContType 3) or auxiliary fans and occupancy control (4), the auxiliary fans are
+// accounted for with AuxFanIndex
+class OccupancyControl : public VentilationController<OccupancyControl> {
+	public:
+		static int ventilate(const ControlSettings& settings, const ControlInputs& in) {
+			if(in.occupied == 1)
+				return exposureOrDose(in, 1.0, 1.0);
+			return (in.relExp > settings.expLimit) ? 1 : 0;		// expLimit defaults to 5, based on ASHRAE 62.2-2016 Addendum C
+		}
+};
+
+// Humidity control strategies (HumContType), in humidity_control.cpp. 0 is the RIVEC v6 peak period control, the
+// others change the decision with the indoor and outdoor humidity
+template <int TYPE> class HumidityControl : public VentilationController< HumidityControl<TYPE> > {
+	public:
+		using VentilationController< HumidityControl<TYPE> >::exposureOrDose;
+		static int ventilate(const ControlSettings& settings, const ControlInputs& in);
+};
+
+/*
+* DeadBandThermostat
+*
+* Air handler mode (AHflag) of the thermostat with a 0.5 K dead band either side of the setpoint. set keeps whether the
+* house left the dead band on the side that calls for heating or cooling while the air handler was off, so the
+* equipment runs through the dead band until the house leaves it on the other side.
+*/
+class DeadBandThermostat {
+	public:
+		/*
+		* heating - air handler mode in the heating season
+		* @param tempHouse - house air temperature at the start of the step (deg K)
+		* @param setpoint - thermostat setpoint (deg K)
+		* @param AHflag - air handler mode of the last step
+		* @param set - 1 when the air handler was off and the house below the dead band, kept between steps
+		* @return air handler mode, 0 = off, 1 = heating
+		*/
+		static int heating(double tempHouse, double setpoint, int AHflag, int& set) {
+			if(tempHouse > setpoint + .5)
+				AHflag = 0;					// Heat off if building air temp above setpoint
+			if(AHflag == 0 || AHflag == 100)
+				set = (tempHouse <= setpoint - .5) ? 1 : 0;
+			if(tempHouse < setpoint - .5)
+				AHflag = 1;					// turn on air handler/heat
+			if(tempHouse >= setpoint - .5 && tempHouse <= setpoint + .5)
+				AHflag = (set == 1) ? 1 : 0;
+			return AHflag;
+		}
+
+		/*
+		* cooling - air handler mode in the cooling season
+		* @param ... - as for heating()
+		* @return air handler mode, 0 = off, 2 = cooling
+		*/
+		static int cooling(double tempHouse, double setpoint, int AHflag, int& set) {
+			if(tempHouse < setpoint - .5)
+				AHflag = 0;
+			if(AHflag == 0 || AHflag == 100)
+				set = (tempHouse >= setpoint + .5) ? 1 : 0;
+			if(tempHouse >= setpoint + .5)
+				AHflag = 2;
+			if(tempHouse < setpoint + .5 && tempHouse >= setpoint - .5)
+				AHflag = (set == 1) ? 2 : 0;
+			return AHflag;
+		}
+};
+
+/*
+* TemperatureEconomizer
+*
+* Outside air economizer that runs in the cooling season while the air conditioner is off, the house is above 21 C and
+* at least 3.33 K (6 F) warmer than outside.
+*/
+class TemperatureEconomizer {
+	public:
+		/*
+		* run - economizer decision
+		* @param AHflag - air handler mode
+		* @param hcFlag - 1 = heating season, 2 = cooling season
+		* @param tempHouse - house air temperature (deg K)
+		* @param tempOut - outdoor air temperature (deg K)
+		* @return 1 = economizer on, 0 = off
+		*/
+		static int run(int AHflag, int hcFlag, double tempHouse, double tempOut) {
+			double econodt = tempHouse - tempOut;
+			return (AHflag == 0 && econodt >= 3.33 && tempHouse > 294.15 && hcFlag == 2) ? 1 : 0;
+		}
+};
+
+/*
+* DeadBandHumidistat
+*
+* Dehumidifier control that starts above the RH setpoint plus the dead band and runs until the RH is below the setpoint
+* less the dead band.
+*/
+class DeadBandHumidistat {
+	public:
+		/*
+		* onTime - minutes the dehumidifier has run at the end of the step
+		* @param rhIn - indoor RH (%)
+		* @param setPoint - RH setpoint (%)
+		* @param deadBand - RH dead band (%)
+		* @param onTime - minutes the dehumidifier has run, 0 when it is off
+		* @return minutes the dehumidifier has run, 0 to turn it off
+		*/
+		static double onTime(double rhIn, double setPoint, double deadBand, double onTime) {
+			if(onTime > 0)
+				return (rhIn < setPoint - deadBand) ? 0 : onTime + STEP_MINUTES;
+			return (rhIn > setPoint + deadBand) ? STEP_MINUTES : 0;
+		}
+};
+
+/*
+* Controls
+*
+* The controllers of a building: the RIVEC ventilation decision, the thermostat, the economizer and the dehumidifier
+* humidistat. The simulation loop is a template on Controls, so each is called directly and the decisions of the
+* controller are compiled into the loop. Another strategy is a class with the same static functions.
+*/
+template <class V, class T = DeadBandThermostat, class E = TemperatureEconomizer, class H = DeadBandHumidistat>
+struct Controls {
+	typedef V Ventilation;
+	typedef T Thermostat;
+	typedef E Economizer;
+	typedef H Humidistat;
+};
+
+/*
+* withControls - runs the simulation loop compiled for the controllers of a building, humidity control takes the place
+* of the occupancy control
+* @param settings - controller settings of the building
+* @param simulate - simulation loop, called with a Controls object
+* @return what simulate returns
+*/
+template <class F> int withControls(const ControlSettings& settings, F simulate) {
+	switch(settings.humidityControl) {
+		case 0: return simulate(Controls< HumidityControl<0> >());
+		case 1: return simulate(Controls< HumidityControl<1> >());
+		case 2: return simulate(Controls< HumidityControl<2> >());
+		case 3: return simulate(Controls< HumidityControl<3> >());
+		case 4: return simulate(Controls< HumidityControl<4> >());
+		case 5: return simulate(Controls< HumidityControl<5> >());
+		case 6: return simulate(Controls< HumidityControl<6> >());
+		case 7: return simulate(Controls< HumidityControl<7> >());
+		case 8: return simulate(Controls< HumidityControl<8> >());
+		case 9: return simulate(Controls< HumidityControl<9> >());
+		case 10: return simulate(Controls< HumidityControl<10> >());
+		case 11: return simulate(Controls< HumidityControl<11> >());
+		case 12: return simulate(Controls< HumidityControl<12> >());
+		case 13: return simulate(Controls< HumidityControl<13> >());
+		case 14: return simulate(Controls< HumidityControl<14> >());
+		case 15: return simulate(Controls< HumidityControl<15> >());
+		case 16: return simulate(Controls< HumidityControl<16> >());
+	}
+	if(settings.occupancyControl == 2)
+		return simulate(Controls<AuxiliaryFanControl>());
+	if(settings.occupancyControl == 3 || settings.occupancyControl == 4)
+		return simulate(Controls<OccupancyControl>());
+	return simulate(Controls<NoVentilationControl>());
+}
+
+#endif
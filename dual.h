@@ -0,0 +1,158 @@
+#pragma once
+#ifndef dual_h
+#define dual_h
+
+#include <iostream>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+/*
+* Dual
+*
+* Forward mode automatic differentiation number: a value and its derivatives with respect to N input parameters.
+* The attic and house heat balance (sub_heat and HeatModel in heat.h) and the psychrometric functions are templated on
+* their scalar type, so passing Dual<N> instead of double carries the derivatives of their results through the same
+* calculation in one pass. Parameter i is seeded with Dual<N>(value, i).
+* Comparisons use the value only so branches are taken exactly as in the double calculation.
+* It is used by test_heat to check the heat balance sensitivities against finite differences. The leakage flow network
+* and the moisture balance are solved in double only, so the air flows and humidities are fixed inputs of the
+* derivatives and the simulation has no sensitivity mode.
+*/
+template <int N> class Dual {
+	public:
+		double v;			// value
+		double d[N];		// derivatives with respect to each parameter
+
+		Dual(double value=0) : v(value) {
+			for(int i=0; i < N; i++)
+				d[i] = 0;
+		}
+		// seed parameter i
+		Dual(double value, int i) : v(value) {
+			for(int k=0; k < N; k++)
+				d[k] = 0;
+			d[i] = 1;
+		}
+
+		Dual& operator+=(const Dual& a) {
+			v += a.v;
+			for(int i=0; i < N; i++)
+				d[i] += a.d[i];
+			return *this;
+		}
+		Dual& operator-=(const Dual& a) {
+			v -= a.v;
+			for(int i=0; i < N; i++)
+				d[i] -= a.d[i];
+			return *this;
+		}
+		Dual& operator*=(const Dual& a) {
+			for(int i=0; i < N; i++)
+				d[i] = d[i] * a.v + v * a.d[i];
+			v *= a.v;
+			return *this;
+		}
+		Dual& operator/=(const Dual& a) {
+			double r = 1 / a.v;
+			v *= r;
+			for(int i=0; i < N; i++)
+				d[i] = (d[i] - v * a.d[i]) * r;
+			return *this;
+		}
+		Dual& operator+=(double a) { v += a; return *this; }
+		Dual& operator-=(double a) { v -= a; return *this; }
+		Dual& operator*=(double a) {
+			v *= a;
+			for(int i=0; i < N; i++)
+				d[i] *= a;
+			return *this;
+		}
+		Dual& operator/=(double a) { return *this *= 1 / a; }
+};
+
+// value of a scalar so results can be stored in the double simulation state
+inline double value(double a) { return a; }
+template <int N> double value(const Dual<N>& a) { return a.v; }
+
+// derivative of a scalar with respect to parameter i, zero for a double
+inline double derivative(double a, int i) { return 0; }
+template <int N> double derivative(const Dual<N>& a, int i) { return a.d[i]; }
+
+template <int N> Dual<N> operator-(const Dual<N>& a) { Dual<N> r(a); r *= -1; return r; }
+template <int N> Dual<N> operator+(const Dual<N>& a) { return a; }
+
+template <int N> Dual<N> operator+(Dual<N> a, const Dual<N>& b) { return a += b; }
+template <int N> Dual<N> operator+(Dual<N> a, double b) { return a += b; }
+template <int N> Dual<N> operator+(double a, Dual<N> b) { return b += a; }
+template <int N> Dual<N> operator-(Dual<N> a, const Dual<N>& b) { return a -= b; }
+template <int N> Dual<N> operator-(Dual<N> a, double b) { return a -= b; }
+template <int N> Dual<N> operator-(double a, const Dual<N>& b) { Dual<N> r(-b); return r += a; }
+template <int N> Dual<N> operator*(Dual<N> a, const Dual<N>& b) { return a *= b; }
+template <int N> Dual<N> operator*(Dual<N> a, double b) { return a *= b; }
+template <int N> Dual<N> operator*(double a, Dual<N> b) { return b *= a; }
+template <int N> Dual<N> operator/(Dual<N> a, const Dual<N>& b) { return a /= b; }
+template <int N> Dual<N> operator/(Dual<N> a, double b) { return a /= b; }
+template <int N> Dual<N> operator/(double a, const Dual<N>& b) { Dual<N> r(a); return r /= b; }
+
+template <int N> bool operator==(const Dual<N>& a, const Dual<N>& b) { return a.v == b.v; }
+template <int N> bool operator==(const Dual<N>& a, double b) { return a.v == b; }
+template <int N> bool operator==(double a, const Dual<N>& b) { return a == b.v; }
+template <int N> bool operator!=(const Dual<N>& a, const Dual<N>& b) { return a.v != b.v; }
+template <int N> bool operator!=(const Dual<N>& a, double b) { return a.v != b; }
+template <int N> bool operator!=(double a, const Dual<N>& b) { return a != b.v; }
+template <int N> bool operator<(const Dual<N>& a, const Dual<N>& b) { return a.v < b.v; }
+template <int N> bool operator<(const Dual<N>& a, double b) { return a.v < b; }
+template <int N> bool operator<(double a, const Dual<N>& b) { return a < b.v; }
+template <int N> bool operator>(const Dual<N>& a, const Dual<N>& b) { return a.v > b.v; }
+template <int N> bool operator>(const Dual<N>& a, double b) { return a.v > b; }
+template <int N> bool operator>(double a, const Dual<N>& b) { return a > b.v; }
+template <int N> bool operator<=(const Dual<N>& a, const Dual<N>& b) { return a.v <= b.v; }
+template <int N> bool operator<=(const Dual<N>& a, double b) { return a.v <= b; }
+template <int N> bool operator<=(double a, const Dual<N>& b) { return a <= b.v; }
+template <int N> bool operator>=(const Dual<N>& a, const Dual<N>& b) { return a.v >= b.v; }
+template <int N> bool operator>=(const Dual<N>& a, double b) { return a.v >= b; }
+template <int N> bool operator>=(double a, const Dual<N>& b) { return a >= b.v; }
+
+template <int N> ostream& operator<<(ostream& os, const Dual<N>& a) { return os << a.v; }
+
+// chain rule: f(a) with f'(a) = dfda
+template <int N> Dual<N> chain(const Dual<N>& a, double f, double dfda) {
+	Dual<N> r(f);
+	for(int i=0; i < N; i++)
+		r.d[i] = dfda * a.d[i];
+	return r;
+}
+
+template <int N> Dual<N> exp(const Dual<N>& a) { double e = exp(a.v); return chain(a, e, e); }
+template <int N> Dual<N> log(const Dual<N>& a) { return chain(a, log(a.v), 1 / a.v); }
+template <int N> Dual<N> sqrt(const Dual<N>& a) { double s = sqrt(a.v); return chain(a, s, s > 0 ? .5 / s : 0); }
+template <int N> Dual<N> sin(const Dual<N>& a) { return chain(a, sin(a.v), cos(a.v)); }
+template <int N> Dual<N> cos(const Dual<N>& a) { return chain(a, cos(a.v), -sin(a.v)); }
+template <int N> Dual<N> tan(const Dual<N>& a) { double t = tan(a.v); return chain(a, t, 1 + t * t); }
+template <int N> Dual<N> abs(const Dual<N>& a) { return a.v < 0 ? -a : a; }
+template <int N> Dual<N> fabs(const Dual<N>& a) { return abs(a); }
+template <int N> bool isnan(const Dual<N>& a) { return isnan(a.v); }
+
+// pow with a constant exponent, the derivative at zero is taken as zero for exponents below one (cube root combinations)
+template <int N> Dual<N> pow(const Dual<N>& a, double b) {
+	double p = pow(a.v, b);
+	return chain(a, p, a.v != 0 ? b * p / a.v : (b == 1 ? 1 : 0));
+}
+template <int N> Dual<N> pow(const Dual<N>& a, const Dual<N>& b) {
+	double p = pow(a.v, b.v);
+	Dual<N> r = pow(a, b.v);
+	if(a.v > 0) {
+		for(int i=0; i < N; i++)
+			r.d[i] += p * log(a.v) * b.d[i];
+	}
+	return r;
+}
+template <int N> Dual<N> pow(double a, const Dual<N>& b) {
+	double p = pow(a, b.v);
+	return chain(b, p, a > 0 ? p * log(a) : 0);
+}
+
+#endif
@@ -8,13 +8,25 @@
 
 using namespace std;
 
+// Outdoor temperature curves of the capacity and EER for a dry and a wet coil
+static const PerformanceCurve CAPACITY_DRY = { 82, -.00007, -.0067 };
+static const PerformanceCurve EER_DRY = { 82, -.00007, -.0085 };
+static const PerformanceCurve CAPACITY_WET = { 95, -.00007, -.0067 };
+static const PerformanceCurve EER_WET = { 95, -.00007, -.0085 };
+
+static double curve(const PerformanceCurve& c, double tOut) {
+	return c.a * pow((tOut - c.tRef),2) + c.b * (tOut - c.tRef) + 1;
+}
+
 /*
  * Compressor - AC compressor class constructor
- *	@param EER    - rated efficiency (kbtuh/kWh)
- * @param tons   - rated capacity (tons)
- * @param charge - refrigerant charge fraction (optional)
+ * @param EER           - rated efficiency (kbtuh/kWh)
+ * @param capacity      - rated capacity (kbtuh)
+ * @param tons          - rated capacity (tons)
+ * @param charge        - refrigerant charge fraction (optional)
+ * @param capAdjustTime - minutes the capacity ramps up over after a start (optional)
  */
-Compressor::Compressor(double EER, double tons, double charge) {
+Compressor::Compressor(double EER, double capacity, double tons, double charge, double capAdjustTime) {
 	// The following corrections are for TXV only
 	chargeCapDry = (charge < .725) ? 1.2 + (charge - 1) : .925;
 	chargeEffDry = (charge < 1) ? 1.04 + (charge - 1) * .65 : 1.04 - (charge - 1) * .35;
@@ -27,92 +39,131 @@ Compressor::Compressor(double EER, double tons, double charge) {
 		chargeEffWet = 1;
 	}
 
-	capacityRated = tons;
-	efficiencyRated = EER;
-	maxMoisture = 0.3 * tons;		// maximum mass on coil is 0.3 kg per ton of cooling
-	onTime = 0;
+	this->capAdjustTime = capAdjustTime;
+	maxMoisture = .3 * tons;		// maximum mass on coil is 0.3 kg per ton of cooling
 	coilMoisture = 0;
-}							
-							
+	SHR = 0;
+	capacitySensible = 0;
+	capacityLatent = 0;
+	evaporation = 0;
+	addStage(EER, capacity, tons);
+}
+
+/*
+ * addStage - adds a compressor stage or speed, the first stage is the rated one
+ * @param EER      - efficiency of the stage (kbtuh/kWh)
+ * @param capacity - capacity of the stage (kbtuh)
+ * @param tons     - capacity of the stage (tons)
+ * @return stage index for run()
+ */
+int Compressor::addStage(double EER, double capacity, double tons) {
+	CompressorStage stage;
+
+	stage.tons = tons;
+	stage.capacityDry = (capacity * 1000) * .91;
+	stage.capacityWet = capacity * 1000;
+	stage.EER = EER;
+	stage.airflowCorrection = 1;
+	stages.push_back(stage);
+	return stages.size() - 1;
+}
+
+/*
+ * setAirflow - sets the cooling capacity air flow correction of a stage for the air handler flow
+ * @param fanFlow - air handler flow (m3/s)
+ * @param stage   - stage index
+ */
+void Compressor::setAirflow(double fanFlow, int stage) {
+	CompressorStage& s = stages[stage];
+	double fanCFM = fanFlow / .0004719;
+
+	s.airflowCorrection = 1.62 - .62 * fanCFM / (400 * s.tons) + .647 * log(fanCFM / (400 * s.tons));
+}
+
 /*
- * run - run the ac compressor model for 1 minute
- * @param compOn   - flag indicating compressor is running
+ * run - runs the compressor for a simulation step
  * @param hrReturn - return humidity ratio (unitless)
  * @param tReturn  - return temperature (deg K)
  * @param tOut     - outdoor temperature (deg K)
- * @param fanFlow  - fan air flow (m3/s)
  * @param fanHeat  - fan heat (Watts)
  * @param mAH      - fan mass flow (kg/s)
+ * @param compTime - minutes the compressor has run, 0 once the start up ramps are over
+ * @param stage    - stage index
  * @return compressor power (Watts)
  */
-double Compressor::run(bool compOn, double hrReturn, double tReturn, double tOut, double fanFlow, double fanHeat, double mAH) {
-	const int rampTime = 3;	// time to reach full SHR (minutes)
-	double hReturn;			// return air enthalpy (btu/lb)
+double Compressor::run(double hrReturn, double tReturn, double tOut, double fanHeat, double mAH, double compTime, int stage) {
+	CompressorStage& s = stages[stage];
 	double capacityTotal;	// total capacity at current conditions (btuh)
 	double EER;					// efficiency at current conditions (kbtuh/kWh)
 	double compressorPower;	// compressor power (Watts)
 
-	if(compOn) {	// compressor running
-		onTime++;
-		tOut = KtoF(tOut);			// cap and eer equations use Tout in deg F
-		tReturn = KtoF(tReturn);	// enthalpy calc uses temps in deg F
-	
-		hReturn = 0.24 * tReturn + hrReturn * (1061 + 0.444 * tReturn);
-		hReturn += fanHeat / mAH / 2326;	// add fan heat (in btu/lb)
-			
-		// Cooling capacity air flow correction term (in CFM)
-		double fanCFM = fanFlow / .0004719;
-		double fanCorr = 1.62 - .62 * fanCFM / (400 * capacityRated) + .647 * log(fanCFM / (400 * capacityRated));
-
-		// Set sensible heat ratio using humidity ratio - note only because we have small indoor dry bulb range			
-		SHR = 1 - 50 * (hrReturn - .005);
-		if(SHR < .25)
-			SHR = .25;
-		if(SHR > 1)
-			SHR = 1;
-		// SHR ramps up for first rampTime minutes of operation
-		if(onTime < rampTime) {
-			SHR += (rampTime - onTime) / rampTime * (1 - SHR);
-		}
-
-		if(SHR == 1) { // dry coil
-			capacityTotal = (capacityRated * 12000) * .91 * fanCorr * chargeCapDry * (-.00007 * pow((tOut - 82),2) - .0067 * (tOut - 82) + 1);
-			EER = efficiencyRated * fanCorr * chargeEffDry * ((-.00007) * pow((tOut - 82),2) - .0085 * (tOut - 82) + 1);
-		} else {			// wet coil
-			capacityTotal = capacityRated * 12000 * (1 + (hReturn - 30) * .025) * fanCorr * chargeCapWet * (-.00007 * pow((tOut - 95),2) - .0067 * (tOut - 95) + 1);
-			EER = efficiencyRated * fanCorr * chargeEffWet * ((-.00007) * pow((tOut - 95),2) - .0085 * (tOut - 95) + 1);
-		}
-		compressorPower = capacityTotal / EER;
-		capacitySensible = SHR * capacityTotal / 3.413 - fanHeat;
-	} else {
-		onTime = 0;					// reset on time counter
-		SHR = 1;						// so latent capacity with fan on is calculated correctly
-		compressorPower = 0;
-		capacitySensible = 0;
+	tOut = KtoF(tOut);			// cap and eer equations use Tout in deg F
+
+	// test for wet/dry coil using SHR calculation
+	SHR = 1 - 50 * (hrReturn - .005);		// using humidity ratio - note only because we have small indoor dry bulb range
+	if(SHR < .25)
+		SHR = .25;
+	if(SHR > 1)
+		SHR = 1;
+
+	if(SHR == 1) { // dry coil
+		capacityTotal = s.capacityDry * s.airflowCorrection * chargeCapDry * curve(CAPACITY_DRY, tOut);
+		EER = s.EER * s.airflowCorrection * chargeEffDry * curve(EER_DRY, tOut);
+	} else {			// wet coil
+		double tReturnF = (tReturn - 273.15) * 9 / 5 + 32;
+		double hReturn = .24 * tReturnF + hrReturn * (1061 + .444 * tReturnF);		// return air enthalpy (btu/lb)
+		hReturn += fanHeat / mAH / 2326.;														// add fan heat, converted to btu/lb
+		capacityTotal = s.capacityWet * (1 + (hReturn - 30) * .025) * s.airflowCorrection * chargeCapWet * curve(CAPACITY_WET, tOut);
+		EER = s.EER * s.airflowCorrection * chargeEffWet * curve(EER_WET, tOut);
 	}
-	
-	// Track Coil Moisture
-	double hfg = calcHfgAir(tReturn);
+	compressorPower = capacityTotal / EER;
+
+	// SHR ramps up for first three minutes of operation
+	if(compTime > 0) {
+		SHR = SHR + (3 - compTime) / 3.0 * (1 - SHR);
+	}
+	// Reduce capacity over capAdjustTime minutes (to reduce sensible spike)
+	if(compTime > 0 && compTime < capAdjustTime) {
+		capacityTotal *= (compTime / capAdjustTime);
+	}
+
+	capacitySensible = SHR * capacityTotal / 3.413;				// sensible (equals total if SHR=1)
+	capacitySensible = capacitySensible - fanHeat;				// correct the sensible cooling for fan power heating
+	capacityLatent = 0;
+	evaporation = 0;
 	if(SHR < 1) {
-		capacityLatent = (1 - SHR) * capacityTotal / 3.413;		// latent capacity Watts
-		coilMoisture += capacityLatent / hfg * dtau;					// condensation in timestep kg/s * time
-	} else {
-		if(coilMoisture > 0) {												// if moisture on coil but no latcap, then we evaporate coil moisture until Mcoil = zero
-			capacityLatent = -maxMoisture / 1800 * hfg;				// evaporation capacity J/s - this is negative latent capacity (1800 sec = 30 minutes to dry coil)
-			coilMoisture -=  maxMoisture / 1800 * dtau;				// evaporation in timestep kg/s * time
-		} else {
-			capacityLatent = 0;
-		}
+		capacityLatent = (1 - SHR) * capacityTotal / 3.413;					// latent capacity Watts
+		coilMoisture = coilMoisture + capacityLatent / 2501000 * dtau;		// condensation in timestep kg/s * time
 	}
+	trackCoil(SHR == 1);
+	return compressorPower;
+}
+
+/*
+ * idle - steps the coil with the compressor off
+ * @param fanOn - the air handler runs
+ */
+void Compressor::idle(bool fanOn) {
+	capacitySensible = 0;
+	capacityLatent = 0;
+	evaporation = 0;
+	trackCoil(fanOn);
+}
 
+/*
+ * trackCoil - limits the water on the coil
+ * @param drying - air flows over a coil without condensation, evaporating the water on it until there is none
+ */
+void Compressor::trackCoil(bool drying) {
+	if(drying && coilMoisture > 0) {
+		capacityLatent = -maxMoisture / 1800 * 2501000;					// evaporation capacity J/s - this is negative latent capacity
+		evaporation = capacityLatent;
+		coilMoisture = coilMoisture - maxMoisture / 1800 * dtau;		// evaporation in timestep kg/s * time
+	}
 	if(coilMoisture < 0)
 		coilMoisture = 0;
-	if(coilMoisture > maxMoisture) {
-		condensate = coilMoisture - maxMoisture;
+	if(coilMoisture > maxMoisture)
 		coilMoisture = maxMoisture;
-	}
-	
-return compressorPower;
 }
 
 /*
@@ -136,12 +187,12 @@ Dehumidifier::Dehumidifier(double cap, double ef, double sp, double db) {
 }
 
 /*
- * run - run the dehumidifier model for 1 minute
+ * operate - dehumidifier capacity and power for a simulation step after the humidistat has set onTime
  * @param rhIn - indoor RH (%)
  * @param tIn  - indoor temperature (deg K)
  * @return status (bool) True - on, False - off
  */
-bool Dehumidifier::run(double rhIn, double tIn) {
+bool Dehumidifier::operate(double rhIn, double tIn) {
 	const int initTime = 4;			// time to full capacity (minutes)
 	// Curves from Winkler et. al., NREl Technical Report TP-5500-52791, December 2011
 	// "Laboratory Test Report for Six ENERGY STAR® Dehumidifiers"
@@ -161,19 +212,6 @@ bool Dehumidifier::run(double rhIn, double tIn) {
 	const double efF = -0.00017672;
 	
 	
-	// Control
-	if(onTime > 0) {
-		if(rhIn < setPoint - deadBand) {
-			onTime = 0;
-		} else {
-			onTime++;
-		}
-	} else {
-		if(rhIn > setPoint + deadBand) {
-			onTime = 1;
-		}
-	}
-	
 	// Operate
 	if(onTime > 0) {
 		tIn -= C_TO_K;	// curves are in deg C and %RH
@@ -182,7 +220,7 @@ bool Dehumidifier::run(double rhIn, double tIn) {
 		double efFTRH = efA + efB * tIn + efC * pow(tIn, 2) + efD * rhIn + efE * pow(rhIn, 2) + efF * tIn * rhIn;
 		power = condensate * 3600 * efficiency / efFTRH;		// kg/s * 3600 s/h * Wh/kg = Watts
 		// reduce moisture removal linearly up to init time
-		double capInit = (onTime < initTime) ? 1.0 - double(initTime - onTime) / double(initTime) : 1.0;
+		double capInit = (onTime < initTime) ? 1.0 - (initTime - onTime) / initTime : 1.0;
 		condensate *= capInit;
 		double hfg = calcHfgAir(tIn);
 		sensible = condensate * hfg + power;
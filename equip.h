@@ -2,28 +2,63 @@
 #ifndef equip_h
 #define equip_h
 
-//using namespace std;
+#include <vector>
+#include "control.h"
 
+using namespace std;
+
+// Outdoor temperature curve of the cooling capacity or EER, 1 + a * (Tout - tRef)^2 + b * (Tout - tRef) with Tout in deg F
+struct PerformanceCurve {
+	double tRef;
+	double a;
+	double b;
+};
+
+/*
+* CompressorStage
+*
+* Performance map of one compressor stage or speed. The parts of the capacity and EER that do not change in the
+* simulation are multiplied out when the stage is added, the air flow correction when the air handler flow changes.
+*/
+struct CompressorStage {
+	double tons;					// rated capacity (tons)
+	double capacityDry;			// rated capacity with the dry coil factor (btuh)
+	double capacityWet;			// rated capacity (btuh)
+	double EER;						// rated efficiency (kbtuh/kWh)
+	double airflowCorrection;	// capacity and EER correction for the air handler flow
+};
+
+/*
+* Compressor
+*
+* Air conditioner compressor and cooling coil. TXV refrigerant charge corrections are fixed by the building, the
+* capacity and EER of a stage are the rated values times the air flow correction and the outdoor temperature curve
+* for a dry or wet coil. The stage is picked by index so multi-stage and variable speed units cost nothing extra a step.
+*/
 class Compressor {
 	private:
+		vector<CompressorStage> stages;
 		double chargeCapDry;		// charge correction for capacity (dry coil)
 		double chargeCapWet;		// charge correction for capacity (wet coil)
 		double chargeEffDry;		// charge correction for EER (dry coil)
 		double chargeEffWet;		// charge correction for EER (wet coil)
-		double capacityRated;	// capacity at rated conditions (tons)
-		double efficiencyRated;	// efficiency at rated conditions (kbtuh/kWh)
-		double onTime;				// tracks the number of minutes the compressor is on for
-		double coilMoisture;		// water on coil (kg)
+		double capAdjustTime;	// minutes the capacity ramps up over after a start
 		double maxMoisture;		// maximum amount of water that can be on coil (kg)
-		
+
+		void trackCoil(bool drying);
+
 	public:
 		double SHR;						// sensible heat ratio (unitless)
-		double capacitySensible;	// sensible capacity at current conditions (watts)
-		double capacityLatent;		// latent capacity at current conditions (watts)
-		double condensate;			// condensed water removed (kg)
+		double capacitySensible;	// sensible capacity at current conditions net of the fan heat (watts)
+		double capacityLatent;		// latent capacity at current conditions, negative while the coil dries (watts)
+		double evaporation;			// latent capacity of the coil drying (watts)
+		double coilMoisture;			// water on coil (kg)
 
-		Compressor(double EER, double tons, double charge=1.0);
-		double run(bool compOn, double hrReturn, double tReturn, double tOut, double fanFlow, double fanHeat, double mAH);
+		Compressor(double EER, double capacity, double tons, double charge=1.0, double capAdjustTime=0);
+		int addStage(double EER, double capacity, double tons);
+		void setAirflow(double fanFlow, int stage=0);
+		double run(double hrReturn, double tReturn, double tOut, double fanHeat, double mAH, double compTime, int stage=0);
+		void idle(bool fanOn);
 };
 
 class Fan {
@@ -46,15 +81,28 @@ class Dehumidifier {
 		double efficiency;			// efficiency (Wh/kg)
 		double setPoint;				// set point (% RH)
 		double deadBand;				// dead band (% RH), optional, default= +/-2.5%
-		int onTime;
+		double onTime;				// minutes the dehumidifier has run
 		
+		bool operate(double rhIn, double tIn);
+
 	public:
 		double power;			// power (watts)
 		double condensate; 	// moisture removed (kg/s)
 		double sensible;		// sensible capacity added (watts)
 		
 		Dehumidifier(double capacity, double energyFactor, double setPoint, double deadBand=2.5);
-		bool run(double rhIn, double tIn);
+		bool run(double rhIn, double tIn) { return run<DeadBandHumidistat>(rhIn, tIn); }
+
+		/*
+		* run - run the dehumidifier model for a simulation step with the humidistat H (DeadBandHumidistat in control.h)
+		* @param rhIn - indoor RH (%)
+		* @param tIn  - indoor temperature (deg K)
+		* @return status (bool) True - on, False - off
+		*/
+		template <class H> bool run(double rhIn, double tIn) {
+			onTime = H::onTime(rhIn, setPoint, deadBand, onTime);
+			return operate(rhIn, tIn);
+		}
 };
 
 
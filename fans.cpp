@@ -0,0 +1,420 @@
+#include "fans.h"
+#include "constants.h"
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+// ------------------------ Outside air into the return while the air handler heats or cools ------------------------
+
+static void returnIntake(const FanStrategy& s, FanState& state) {
+	state.mFanCycler = s.fan->q * state.airDensityIN;
+	state.mRetReg = state.mRetReg1 - state.mFanCycler;
+}
+
+// vent always open during any air handler operation (10, 14, 18)
+static void intakeAlways(const FanStrategy& s, FanState& state) {
+	returnIntake(s, state);
+}
+
+// vent open for the first 20 minutes of air handler operation in the hour (6, 15)
+static void intakeFirst20(const FanStrategy& s, FanState& state) {
+	if(state.AHseconds <= 20 * 60)
+		returnIntake(s, state);
+}
+
+// 6 at the cooling air handler flow, correcting the return intake flow so it remains a constant fraction of air handler flow
+static void intakeFirst20Cooling(const FanStrategy& s, FanState& state) {
+	if(state.AHseconds <= 20 * 60) {
+		state.mFanCycler = s.fan->q * state.airDensityIN * state.qAH_cool / state.qAH_heat;
+		state.mRetReg = state.mRetReg1 - state.mFanCycler;
+	}
+}
+
+// CFIS (13)
+static void intakeCFIS(const FanStrategy& s, FanState& state) {
+	if(state.AHseconds <= 20 * 60) {
+		returnIntake(s, state);
+		state.ventSumIN = state.ventSumIN + s.ach;
+	}
+}
+
+// CFIS (13) with RIVEC control, RIVEC operates this fan until it reaches its exposure setpoint
+static void intakeCFISRivec(const FanStrategy& s, FanState& state) {
+	if(state.rivecOn == 1) {
+		returnIntake(s, state);
+		state.ventSumIN = state.ventSumIN + s.ach;
+	}
+}
+
+// fan cycler only when the economizer is off (22)
+static void intakeEconomizerOff(const FanStrategy& s, FanState& state) {
+	if(state.AHseconds <= 20 * 60 && state.econoFlag == 0)
+		returnIntake(s, state);
+}
+
+// ------------------------------------------------ Fan controls ------------------------------------------------
+
+static bool airHandlerHeatCool(FanState& state) {
+	return state.AHflag == 1 || state.AHflag == 2 || state.AHflag == 102;
+}
+
+// the air handler is off for heat/cool so it is turned on at the cooling speed for venting
+static void airHandlerVent(const FanStrategy& s, FanState& state) {
+	state.AHflag = 100;
+	state.AHseconds = state.AHseconds + STEP_SECONDS;
+	state.qAH = state.qAH_cool;
+	state.supVelAH = state.qAH / s.supArea;
+	state.retVelAH = state.qAH / s.retArea;
+	state.qSupReg = -state.qAH * state.supLF + state.qAH;
+	state.qRetReg = state.qAH * state.retLF - state.qAH;
+	state.qRetLeak = -state.qAH * state.retLF;
+	state.qSupLeak = state.qAH * state.supLF;
+	state.mSupLeak = state.qSupLeak * state.airDensityIN;
+	state.mSupReg = state.qSupReg * state.airDensityIN;
+	state.mAH = state.qAH * state.airDensityIN;
+	state.mechVentPower = state.mechVentPower + state.fanPower_cooling;		// note AH operates at cooling speed
+	state.AHfanHeat = state.fanPower_cooling * .85;								// for heat
+}
+
+// fan cycler operation with the air handler drawing outside air into the return (13, 22)
+static void fanCyclerOn(const FanStrategy& s, FanState& state) {
+	airHandlerVent(s, state);
+	state.mRetLeak = state.qRetLeak * state.airDensityIN;
+	state.mFanCycler = s.fan->q * state.airDensityIN;
+	state.mRetReg = state.qRetReg * state.airDensityIN - state.mFanCycler;
+	state.ventSumIN = state.ventSumIN + s.ach;
+}
+
+// 20 minute minimum central fan integrated supply (CFIS), in the last 20 minutes of the hour without exhaust fan (13)
+static void controlCFIS(const FanStrategy& s, FanState& state) {
+	if(state.AHseconds < state.target && !airHandlerHeatCool(state))
+		fanCyclerOn(s, state);
+}
+
+static void controlCFISRivec(const FanStrategy& s, FanState& state) {
+	if(state.rivecOn == 1 && !airHandlerHeatCool(state))
+		fanCyclerOn(s, state);
+}
+
+// fan cycler operation only when the economizer is off (22)
+static void controlCFISEconomizerOff(const FanStrategy& s, FanState& state) {
+	if(state.econoFlag == 0 && state.AHseconds < state.target && !airHandlerHeatCool(state))
+		fanCyclerOn(s, state);
+}
+
+// standalone HRV not synched to the air handler, on for the last 30 minutes of every hour or RIVEC controlled (5)
+static void hrvOn(const FanStrategy& s, FanState& state) {
+	s.fan->on = 1;
+	state.mechVentPower = state.mechVentPower + s.fan->power;
+	if(s.fan->q > 0) {
+		state.mHRV = s.fan->q * state.airDensityOUT;
+		state.ventSumIN = state.ventSumIN + s.ach;
+	} else {
+		state.ventSumOUT = state.ventSumOUT + s.ach;
+	}
+}
+
+static void controlHRV(const FanStrategy& s, FanState& state) {
+	if(state.second >= 1800)
+		hrvOn(s, state);
+	else
+		s.fan->on = 0;
+}
+
+static void controlHRVRivec(const FanStrategy& s, FanState& state) {
+	if(state.rivecOn == 1)
+		hrvOn(s, state);
+	else
+		s.fan->on = 0;
+}
+
+// HRV + air handler, mHRV_AH is negative with the exhaust from the house (16)
+static void hrvAirHandlerOn(const FanStrategy& s, FanState& state) {
+	s.fan->on = 1;
+	state.ventSumIN = state.ventSumIN + s.ach;
+	state.ventSumOUT = state.ventSumOUT + s.ach;
+	state.mechVentPower = state.mechVentPower + s.fan->power;
+	if(!airHandlerHeatCool(state)) {
+		airHandlerVent(s, state);
+		state.mHRV_AH = abs(s.fan->q * state.airDensityIN) * -1.0;
+		state.mRetReg = state.qRetReg * state.airDensityIN - state.mHRV_AH;
+	} else {													// open the outside air vent
+		state.mHRV_AH = s.fan->q * state.airDensityIN;
+		state.mRetReg = state.qRetReg * state.airDensityIN - state.mHRV_AH;
+	}
+}
+
+static void controlHRVAirHandler(const FanStrategy& s, FanState& state) {
+	if(state.second >= 1800) {
+		hrvAirHandlerOn(s, state);
+	} else {
+		s.fan->on = 0;
+		state.mHRV_AH = 0;
+	}
+}
+
+static void controlHRVAirHandlerRivec(const FanStrategy& s, FanState& state) {
+	if(state.rivecOn == 1) {
+		hrvAirHandlerOn(s, state);
+	} else {
+		s.fan->on = 0;
+		state.mHRV_AH = 0;
+	}
+}
+
+// ERV + air handler, on for the last 20 minutes of every hour or RIVEC controlled (17)
+static void ervAirHandlerOn(const FanStrategy& s, FanState& state) {
+	s.fan->on = 1;
+	state.ventSumIN = state.ventSumIN + s.ach;
+	state.ventSumOUT = state.ventSumOUT + s.ach;
+	state.mechVentPower = state.mechVentPower + s.fan->power;
+	if(!airHandlerHeatCool(state)) {
+		airHandlerVent(s, state);
+		state.mRetLeak = state.qRetLeak * state.airDensityIN;
+		state.mERV_AH = abs(s.fan->q * state.airDensityIN) * -1.0;
+		state.mRetReg = state.qRetReg * state.airDensityIN - state.mERV_AH;
+	} else {													// open the outside air vent
+		state.mERV_AH = s.fan->q * state.airDensityIN;
+		state.mRetReg = state.qRetReg * state.airDensityIN - state.mERV_AH;
+	}
+}
+
+static void controlERVAirHandler(const FanStrategy& s, FanState& state) {
+	if(state.second >= 2400) {
+		ervAirHandlerOn(s, state);
+	} else {
+		s.fan->on = 0;
+		state.mERV_AH = 0;
+	}
+}
+
+static void controlERVAirHandlerRivec(const FanStrategy& s, FanState& state) {
+	if(state.rivecOn == 1) {
+		ervAirHandlerOn(s, state);
+	} else {
+		s.fan->on = 0;
+		state.mERV_AH = 0;
+	}
+}
+
+// whole house fan, the heat of a supply fan is added to the internal gains of the house (1)
+static void wholeHouseOn(const FanStrategy& s, FanState& state) {
+	s.fan->on = 1;
+	state.mechVentPower = state.mechVentPower + s.fan->power;
+	if(s.fan->q > 0) {
+		state.fanHeat = s.heat;
+		state.ventSumIN = state.ventSumIN + s.ach;
+	} else
+		state.ventSumOUT = state.ventSumOUT + s.ach;
+}
+
+static void controlContinuous(const FanStrategy& s, FanState& state) {
+	wholeHouseOn(s, state);
+}
+
+static void controlRivecExhaust(const FanStrategy& s, FanState& state) {
+	if(state.rivecOn == 1)
+		wholeHouseOn(s, state);
+	else
+		s.fan->on = 0;
+}
+
+// local exhaust, not part of the RIVEC whole house ventilation
+static void scheduledOn(const FanStrategy& s, FanState& state) {
+	s.fan->on = 1;
+	state.mechVentPower = state.mechVentPower + s.fan->power;
+	state.nonRivecVentSumOUT = state.nonRivecVentSumOUT + s.ach;
+}
+
+static void scheduled(const FanStrategy& s, FanState& state, bool on) {
+	if(on)
+		scheduledOn(s, state);
+	else
+		s.fan->on = 0;
+}
+
+// fixed schedule bathroom (2)
+static void controlBathroom(const FanStrategy& s, FanState& state) {
+	scheduled(s, state, state.hour == 7 && state.second >= 1800);
+}
+
+// fixed schedule kitchen (3)
+static void controlKitchen(const FanStrategy& s, FanState& state) {
+	scheduled(s, state, state.hour > 17 && state.hour <= 18);
+}
+
+// fixed schedule exhaust fan, off for four hours of the heating or cooling day (4)
+static void controlExhaustSchedule(const FanStrategy& s, FanState& state) {
+	if(state.hcFlag == 1)
+		scheduled(s, state, !(state.hour > 1 && state.hour <= 5));
+	if(state.hcFlag == 2)
+		scheduled(s, state, !(state.hour > 15 && state.hour <= 19));
+}
+
+// dryer, three hours of operation two days per week (19)
+static void controlDryer(const FanStrategy& s, FanState& state) {
+	scheduled(s, state, state.weekend == 1 && state.hour > 12 && state.hour <= 15);
+}
+
+// economizer (21)
+static void controlEconomizer(const FanStrategy& s, FanState& state) {
+	if(state.econoFlag == 1) {
+		s.fan->on = 1;
+		state.AHfanPower = state.AHfanPower + s.fan->power;
+		state.nonRivecVentSumIN = state.nonRivecVentSumIN + s.ach;
+	} else
+		s.fan->on = 0;
+}
+
+// dynamic schedules (23 - 27)
+static void controlDynamicDryer(const FanStrategy& s, FanState& state) {
+	scheduled(s, state, state.dryerFan == 1);
+}
+
+static void controlDynamicKitchen(const FanStrategy& s, FanState& state) {
+	scheduled(s, state, state.kitchenFan == 1);
+}
+
+static void controlDynamicBathOne(const FanStrategy& s, FanState& state) {
+	scheduled(s, state, state.bathOneFan == 1);
+}
+
+static void controlDynamicBathTwo(const FanStrategy& s, FanState& state) {
+	scheduled(s, state, state.bathTwoFan == 1);
+}
+
+static void controlDynamicBathThree(const FanStrategy& s, FanState& state) {
+	scheduled(s, state, state.bathThreeFan == 1);
+}
+
+/*
+* FanTable - FanTable class constructor
+* Fans with codes that are controlled elsewhere (the RIVEC fans 30, 31, 50 and 51) or not at all have no entries.
+* @param fan - fans of the building
+* @param houseVolume - house volume (m3)
+* @param supDiameter - supply duct diameter (m)
+* @param retDiameter - return duct diameter (m)
+* @param OccContType - occupancy control type, above 1 the whole house fan (1) is RIVEC controlled
+* @param rivecFlag - 1 for RIVEC control of the CFIS, HRV and ERV fans
+*/
+FanTable::FanTable(vector<fan_struct>& fan, double houseVolume, double supDiameter, double retDiameter, int OccContType,
+	int rivecFlag) {
+	bool rivec = (rivecFlag == 1);
+
+	for(size_t i=0; i < fan.size(); i++) {
+		FanStrategy s;
+		int oper = (int) fan[i].oper;
+
+		s.fan = &fan[i];
+		s.ach = abs(fan[i].q) * 3600 / houseVolume;
+		s.heat = fan[i].power * .84;			// 16% efficiency for the particular fan used in this study
+		s.supArea = pow(supDiameter,2) * M_PI / 4;
+		s.retArea = pow(retDiameter,2) * M_PI / 4;
+		if(fan[i].oper != oper)
+			continue;
+
+		// outside air into the return
+		s.behaviour = 0;
+		switch(oper) {
+			case 6:
+			case 15:
+				s.behaviour = intakeFirst20;
+				break;
+			case 10:
+			case 14:
+			case 18:
+				s.behaviour = intakeAlways;
+				break;
+			case 13:
+				s.behaviour = rivec ? intakeCFISRivec : intakeCFIS;
+				break;
+			case 22:
+				s.behaviour = intakeEconomizerOff;
+				break;
+		}
+		if(s.behaviour) {
+			intake.push_back(s);
+			if(oper == 6)
+				s.behaviour = intakeFirst20Cooling;
+			coolingIntake.push_back(s);
+		}
+
+		// own controls
+		s.behaviour = 0;
+		switch(oper) {
+			case 1:
+				s.behaviour = (OccContType > 1) ? controlRivecExhaust : controlContinuous;
+				break;
+			case 2:
+				s.behaviour = controlBathroom;
+				break;
+			case 3:
+				s.behaviour = controlKitchen;
+				break;
+			case 4:
+				s.behaviour = controlExhaustSchedule;
+				break;
+			case 5:
+				s.behaviour = rivec ? controlHRVRivec : controlHRV;
+				break;
+			case 13:
+				s.behaviour = rivec ? controlCFISRivec : controlCFIS;
+				break;
+			case 16:
+				s.behaviour = rivec ? controlHRVAirHandlerRivec : controlHRVAirHandler;
+				break;
+			case 17:
+				s.behaviour = rivec ? controlERVAirHandlerRivec : controlERVAirHandler;
+				break;
+			case 19:
+				s.behaviour = controlDryer;
+				break;
+			case 21:
+				s.behaviour = controlEconomizer;
+				break;
+			case 22:
+				s.behaviour = controlCFISEconomizerOff;
+				break;
+			case 23:
+				s.behaviour = controlDynamicDryer;
+				break;
+			case 24:
+				s.behaviour = controlDynamicKitchen;
+				break;
+			case 25:
+				s.behaviour = controlDynamicBathOne;
+				break;
+			case 26:
+				s.behaviour = controlDynamicBathTwo;
+				break;
+			case 27:
+				s.behaviour = controlDynamicBathThree;
+				break;
+		}
+		if(s.behaviour)
+			control.push_back(s);
+	}
+}
+
+/*
+* runIntake - outside air drawn into the return by the fans while the air handler heats or cools
+* @param state - simulation variables
+* @param cooling - the air handler runs at the cooling flow
+*/
+void FanTable::runIntake(FanState& state, bool cooling) {
+	vector<FanStrategy>& fans = cooling ? coolingIntake : intake;
+
+	for(size_t i=0; i < fans.size(); i++)
+		fans[i].behaviour(fans[i], state);
+}
+
+/*
+* runControls - switches the fans with their own controls for the time step
+* @param state - simulation variables
+*/
+void FanTable::runControls(FanState& state) {
+	for(size_t i=0; i < control.size(); i++)
+		control[i].behaviour(control[i], state);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#ifndef fans_h
+#define fans_h
+#include <vector>
+#include "functions.h"
+
+using namespace std;
+
+/*
+* FanState
+*
+* The simulation variables the fan strategies read and set. main binds the references to its own variables once before
+* the time step loop, the time and the air densities are set every step before the strategies run.
+*/
+struct FanState {
+	int& AHflag;						// air handler mode, 100 = on for venting
+	int& AHseconds;					// air handler operation in the hour (seconds)
+	int& target;						// fan cycler operation wanted by this time in the hour (seconds)
+	int& rivecOn;						// RIVEC decision
+	int& econoFlag;					// economizer on
+	int& hcFlag;						// 1 = heating season, 2 = cooling season
+	int& weekend;
+	int& dryerFan;						// dynamic schedule flags
+	int& kitchenFan;
+	int& bathOneFan;
+	int& bathTwoFan;
+	int& bathThreeFan;
+	double& qAH;						// air handler flow (m3/s)
+	double& qAH_cool;
+	double& qAH_heat;
+	double& supLF;						// duct leakage fractions
+	double& retLF;
+	double& fanPower_cooling;
+	double& supVelAH;
+	double& retVelAH;
+	double& qSupReg;
+	double& qRetReg;
+	double& qRetLeak;
+	double& qSupLeak;
+	double& mAH;
+	double& mSupReg;
+	double& mRetReg;
+	double& mRetReg1;					// return register flow with the air handler on and no outside air
+	double& mSupLeak;
+	double& mRetLeak;
+	double& mFanCycler;				// outside air drawn into the return
+	double& mHRV;
+	double& mHRV_AH;
+	double& mERV_AH;
+	double& mechVentPower;
+	double& AHfanPower;
+	double& AHfanHeat;
+	double& fanHeat;					// heat of a supply fan into the house
+	double& ventSumIN;				// ventilation flows (ach)
+	double& ventSumOUT;
+	double& nonRivecVentSumIN;
+	double& nonRivecVentSumOUT;
+	int hour;
+	int second;							// time in the hour at the start of the step
+	double airDensityIN;
+	double airDensityOUT;
+};
+
+class FanStrategy;
+typedef void (*fanBehaviour)(const FanStrategy& s, FanState& state);
+
+/*
+* FanStrategy
+*
+* What one fan does, resolved from its operation code once for the building
+*/
+class FanStrategy {
+	public:
+		fan_struct* fan;
+		fanBehaviour behaviour;
+		double ach;							// air changes per hour of the fan flow
+		double heat;						// heat of the fan motor into a supply air stream (W)
+		double supArea, retArea;		// duct cross sections (m2)
+};
+
+/*
+* FanTable
+*
+* The fans of a building sorted by what they do each time step. The operation codes are resolved once into a list of
+* the fans that draw outside air into the return while the air handler runs and a list of the fans with their own
+* control, each with the function for its code, so a step only calls the fans that have something to do and does not
+* test codes. A new fan type is a new function and an entry in FanTable::FanTable().
+*/
+class FanTable {
+	private:
+		vector<FanStrategy> intake;			// outside air into the return while the air handler heats or cools
+		vector<FanStrategy> coolingIntake;	// the same when the air handler runs at the cooling flow
+		vector<FanStrategy> control;			// fans switched on and off by their own controls
+
+	public:
+		FanTable(vector<fan_struct>& fan, double houseVolume, double supDiameter, double retDiameter, int OccContType,
+			int rivecFlag);
+		void runIntake(FanState& state, bool cooling);
+		void runControls(FanState& state);
+};
+
+#endif
@@ -62,6 +62,38 @@ struct flue_struct {
 	double flueTemp;
 };
 
+struct zone_struct {
+	int type;					// 1 = crawlspace (takes the floor leakage), 2 = garage, 3 = conditioned zone
+	int link;					// zone joined by the interzone leakage and conductance: 1 = house, 3 = first zone in the zone file, etc.
+	double volume;				// air volume (m3)
+	double floorArea;			// floor area (m2), sets the zone mass
+	double bottom;				// height of the zone floor above grade (m)
+	double top;					// height of the zone ceiling above grade (m)
+	double UA;					// conductance to outside (W/K)
+	double UAlink;				// conductance to the linked zone (W/K)
+	double C;					// leakage coefficient to outside (m3/s/Pa^n)
+	double n;					// leakage pressure exponent to outside
+	double linkC;				// interzone leakage coefficient (m3/s/Pa^n)
+	double linkn;				// interzone leakage pressure exponent
+	double linkHeight;		// height of the interzone leakage above grade (m)
+	double supplyFraction;	// fraction of the supply register flow delivered to the zone and returned through the house
+	double internalGains;	// (W)
+	int node;					// airflow network zone index
+	double temp;				// air temperature (deg K)
+	double tempOld;			// air temperature at the last time step (deg K)
+	double tempMass;			// mass temperature (deg K)
+	double tempMassOld;		// mass temperature at the last time step (deg K)
+	double P;					// zone pressure (Pa)
+	double mOUT;				// sum of flows out of the zone (kg/s, -ve)
+	double mOutside;			// flow into the zone from outside (kg/s)
+	double mFromHouse;		// flow into the zone from the house (kg/s)
+	double mHouse;				// flow from the zone into the house (kg/s)
+	double mLinkIn;			// flow into the zone through the interzone leakage when linked to another zone (kg/s)
+	double mLinkOut;			// flow out of the zone through the interzone leakage when linked to another zone (kg/s, -ve)
+};
+
+class FlowNetwork;		// airflow network (airnet.h)
+
 //ASHRAE 62.2-2016 Infiltration and Relative Dose Functions
 
 void sub_infiltrationModel (
@@ -124,149 +156,80 @@ double sub_Pollutant (
 
 // Additional functions
 
-void sub_heat ( 
-	double& tempOut, 
-	//double& airDensityRef, 
-	//double& airTempRef, 
-	double& mCeiling, 
-	double& AL4, 
-	double& windSpeed, 
-	double& ssolrad, 
-	double& nsolrad, 
-	double* tempOld, 
-	double& atticVolume, 
-	double& houseVolume, 
-	double& sc, 
-	double* b,
-	double& floorArea, 
-	double& roofPitch, 
-	double& ductLocation, 
-	double& mSupReg, 
-	double& mRetReg, 
-	double& mRetLeak, 
-	double& mSupLeak, 
-	double& mAH, 
-	double& supRval, 
-	double& retRval, 
-	double& supDiameter, 
-	double& retDiameter, 
-	double& supThickness, 
-	double& retThickness, 
-	double& supVel, 
-	double& retVel, 
-	int& pRef, 
-	double& HROUT, 
-	double& uaSolAir,
-	double& uaTOut, 
-	double& matticenvin, 
-	double& matticenvout, 
-	double& mHouseIN, 
-	double& mHouseOUT, 
-	double& planArea, 
-	double& mSupAHoff, 
-	double& mRetAHoff, 
-	double& solgain, 
-	double& tsolair, 
-	double& mFanCycler, 
-	double& roofPeakHeight, 
-	double& retLength,
-	double& supLength,
-	int& roofType,
-	double roofExtRval,
-	double roofIntRval,
-	double ceilRval,
-	double gableEndRval,
-	int& AHflag, 
-	double& mERV_AH,
-	double& ERV_SRE,
-	double& mHRV,
-	double& HRV_ASE,
-	double& mHRV_AH,
-	double& capacityc,
-	double& capacityh,
-	double& evapcap,
-	double& internalGains,
-	//int bsize,
-	double& airDensityIN,
-	double& airDensityOUT,
-	double& airDensityATTIC,
-	double& airDensitySUP,
-	double& airDensityRET,
-	int& numStories,
-	double& storyHeight,
-	double dhSensibleGain,
-	double& H2,
-	double& H4,
-	double& H6,
-	double bulkArea,
-	double sheathArea,
-	int radiantBarrier
+void sub_leakNetwork (
+	FlowNetwork& network,
+	double& n,
+	double& eaveHeight,
+	double leakFracCeil,
+	double leakFracFloor,
+	double leakFracWall,
+	int& numFlues,
+	flue_struct* flue,
+	double* wallFraction,
+	double* floorFraction,
+	double& flueShelterFactor,
+	int& numWinDoor,
+	winDoor_struct* winDoor,
+	int& numFans,
+	fan_struct* fan,
+	int& numPipes,
+	pipe_struct* Pipe,
+	int& Crawl,
+	double& Hfloor,
+	bool rowHouse,
+	double& supC,
+	double& supn,
+	double& retC,
+	double& retn,
+	double& windPressureExp,
+	double& atticPressureExp,
+	double& roofPeakHeight,
+	double& roofPitch,
+	bool roofPeakPerpendicular,
+	double* soffitFraction,
+	soffit_struct* soffit,
+	int& numAtticVents,
+	atticVent_struct* atticVent,
+	int& numAtticFans,
+	fan_struct* atticFan,
+	int& numZones,
+	zone_struct* zone
 );
 
 void sub_houseLeak ( 
+	FlowNetwork& network,
 	int& AHflag,
-	int& leakIterations, 
 	double& U, 
 	int& windAngle, 
 	double& tempHouse, 
 	double& tempAttic, 
 	double& tempOut, 
 	double& envC, 
-	double& n, 
-	double& eaveHeight, 
-	double leakFracCeil, 
-	double leakFracFloor,
-	double leakFracWall, 
-	int& numFlues, 
-	flue_struct* flue, 
-	double* wallFraction, 
-	double* floorFraction, 
+	double& atticC, 
 	double* Sw, 
-	double& flueShelterFactor, 
-	int& numWinDoor, 
-	winDoor_struct* winDoor, 
-	int& numFans, 
 	fan_struct* fan, 
-	int& numPipes, 
-	pipe_struct* Pipe, 
 	double& mIN, 
 	double& mOUT, 
 	double& Pint, 
 	double& mFlue, 
 	double& mCeiling, 
 	double* mFloor, 
-	double& atticC, 
 	double& dPflue, 
-	int& Crawl, 
-	double& Hfloor, 
-	bool rowHouse, 
-	double* soffitFraction, 
 	double& Patticint, 
 	double* wallCp, 
-	//double& airDensityRef, 
-	//double& airTempRef, 
 	double& mSupReg, 
-	double& mAH, 
-	double& mRetLeak, 
-	double& mSupLeak, 
 	double& mRetReg, 
 	double& mHouseIN, 
 	double& mHouseOUT, 
-	double& supC, 
-	double& supn, 
-	double& retC, 
-	double& retn, 
 	double& mSupAHoff, 
 	double& mRetAHoff, 
-	//double& Aeq,
 	double& airDensityIN,
 	double& airDensityOUT,
-	double& airDensityATTIC,
-	double& houseVolume,
-	double& windPressureExp
+	double& airDensityATTIC
 );
 
 void sub_atticLeak ( 
+	FlowNetwork& network,
 	int& leakIterations, 
 	double& U, 
 	int& windAngle, 
@@ -274,27 +237,12 @@ void sub_atticLeak (
 	double& tempOut, 
 	double& tempAttic, 
 	double& atticC, 
-	double& atticPressureExp, 
-	double& eaveHeight, 
-	double& roofPeakHeight, 
-	double& flueShelterFactor, 
 	double* Sw, 
-	int& numAtticVents, 
-	atticVent_struct* atticVent, 
-	soffit_struct* soffit, 
+	fan_struct* atticFan, 
 	double& mAtticIN, 
 	double& mAtticOUT, 
 	double& Patticint, 
 	double& mCeiling, 
-	bool rowHouse, 
-	double* soffitFraction, 
-	double& roofPitch, 
-	bool roofPeakPerpendicular, 
-	int& numAtticFans, 
-	fan_struct* atticFan, 
-	//double& airDensityRef, 
-	//double& airTempRef, 
-	double& mSupReg, 
 	double& mRetLeak, 
 	double& mSupLeak, 
 	double& matticenvin, 
@@ -306,6 +254,18 @@ void sub_atticLeak (
 	double& airDensityATTIC
 	);
 
+void sub_zoneLeak (
+	FlowNetwork& network,
+	double& U,
+	int& windAngle,
+	double& tempOut,
+	double* Sw,
+	double& airDensityOUT,
+	int& numZones,
+	zone_struct* zone,
+	double& mZones
+	);
+
 void sub_filterLoading (
 	int& MERV,
 	int& loadingRate,
@@ -327,6 +287,4 @@ void sub_filterLoading (
 	double& qAH_low
 	);
 
-double saturationVaporPressure (double temp);
-
 #endif
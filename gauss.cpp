@@ -9,6 +9,18 @@ using namespace std;
 
 // From: https://martin-thoma.com/solving-linear-equations-with-gaussian-elimination/
 vector<double> gauss(vector< vector<double> > A) {
+    vector<double> x(A.size());
+
+    gauss(A, x);
+    return x;
+}
+
+/*
+* gauss - solves in place, for callers that keep the matrix and the solution between calls so nothing is allocated
+* @param A - augmented matrix, destroyed by the elimination
+* @param x - returns the solution, sized by the caller
+*/
+void gauss(vector< vector<double> >& A, vector<double>& x) {
     int n = A.size();
 
     for (int i=0; i<n; i++) {
@@ -43,14 +55,12 @@ vector<double> gauss(vector< vector<double> > A) {
     }
 
     // Solve equation Ax=b for an upper triangular matrix A
-    vector<double> x(n);
     for (int i=n-1; i>=0; i--) {
         x[i] = A[i][n]/A[i][i];
         for (int k=i-1;k>=0; k--) {
             A[k][n] -= A[k][i] * x[i];
         }
     }
-    return x;
 }
 
 // ----- Original MatSEqn definitions -----
@@ -2,6 +2,8 @@
 #ifndef gauss_h
 #define gauss_h
 #include <vector>
+#include <algorithm>
+#include "lanes.h"
 
 using namespace std;
 
@@ -27,5 +29,214 @@ int MatSEqn(double A[][ArraySize], double* b);
 int matlu(double A[][ArraySize], int* rpvt, int* cpvt, int& continuevar);
 int matbs(double A[][ArraySize], double* b, double* x, int* rpvt, int* cpvt);
 vector<double> gauss(vector< vector<double> > A);
+void gauss(vector< vector<double> >& A, vector<double>& x);
+
+/*
+* SparseMatrixT
+*
+* Square matrix that only stores its non-zero entries, for node networks where each node is connected to a few others.
+* A[i][j] reads or creates entry (i,j) so equations can be assembled exactly as with a dense matrix.
+* solve() eliminates the nodes in minimum degree order so the cost grows with the number of connections rather than
+* the cube of the number of nodes. There is no pivoting so the matrix must be diagonally dominant (heat balances, flow networks).
+* clear() keeps the entries so a matrix that is assembled the same way each time step only finds its elimination order once.
+* The scalar type is a template parameter so the heat balance can also be solved with Dual numbers (dual.h) or for
+* several variants at once in Lanes (lanes.h).
+* SparseMatrix is the double matrix used by the simulation.
+*/
+template <class T> class SparseMatrixT {
+	public:
+		class Row {
+			public:
+				vector<int> col;			// column of each entry
+				vector<T> val;			// value of each entry
+
+				T& operator[](int j) {
+					for(size_t k=0; k < col.size(); k++) {
+						if(col[k] == j)
+							return val[k];
+					}
+					col.push_back(j);
+					val.push_back(0);
+					return val.back();
+				}
+		};
+
+		SparseMatrixT(int size=0) { resize(size); }
+		void resize(int size);
+		void clear();
+		int size() { return rows.size(); }
+		Row& operator[](int i) { return rows[i]; }
+		int solve(vector<T>& b);
+
+	private:
+		vector<Row> rows;
+		vector<int> order;					// elimination order
+		vector<int> position;				// position of each node in the elimination order
+		vector< vector<int> > colRows;	// rows with an entry in each column, including the fill in
+		vector<T> x;
+		int orderedEntries;					// number of entries when the order was found
+
+		int entries();
+		void orderNodes();
+};
+
+typedef SparseMatrixT<double> SparseMatrix;
+
+/*
+* resize - sets the number of nodes and removes all entries
+* @param size - number of nodes
+*/
+template <class T> void SparseMatrixT<T>::resize(int size) {
+	rows.assign(size, Row());
+	order.clear();
+	orderedEntries = -1;
+}
+
+/*
+* clear - sets all entries to zero but keeps them so the elimination order can be used again
+*/
+template <class T> void SparseMatrixT<T>::clear() {
+	for(size_t i=0; i < rows.size(); i++) {
+		for(size_t k=0; k < rows[i].val.size(); k++)
+			rows[i].val[k] = 0;
+	}
+}
+
+template <class T> int SparseMatrixT<T>::entries() {
+	int count = 0;
+	for(size_t i=0; i < rows.size(); i++)
+		count += rows[i].col.size();
+	return count;
+}
+
+/*
+* orderNodes - minimum degree elimination order of the matrix graph
+* Eliminating a node connects all its remaining neighbours so the node with the fewest neighbours is taken each time,
+* which eliminates the leaves of the network first and keeps the fill in small.
+*/
+template <class T> void SparseMatrixT<T>::orderNodes() {
+	int n = rows.size();
+	vector< vector<int> > adj(n);
+	vector<char> eliminated(n, 0);
+	vector<int> mark(n, -1);
+
+	// structure of A + A transpose without the diagonal
+	for(int i=0; i < n; i++) {
+		for(size_t k=0; k < rows[i].col.size(); k++) {
+			int j = rows[i].col[k];
+			if(j != i) {
+				adj[i].push_back(j);
+				adj[j].push_back(i);
+			}
+		}
+	}
+	for(int i=0; i < n; i++) {
+		sort(adj[i].begin(), adj[i].end());
+		adj[i].erase(unique(adj[i].begin(), adj[i].end()), adj[i].end());
+	}
+
+	order.clear();
+	for(int step=0; step < n; step++) {
+		int k = -1;
+		for(int i=0; i < n; i++) {
+			if(!eliminated[i] && (k < 0 || adj[i].size() < adj[k].size()))
+				k = i;
+		}
+		order.push_back(k);
+		eliminated[k] = 1;
+
+		// the neighbours of k become connected to each other
+		for(size_t a=0; a < adj[k].size(); a++) {
+			int u = adj[k][a];
+			vector<int> merged;
+			mark[u] = k;
+			for(size_t b=0; b < adj[u].size(); b++) {
+				if(adj[u][b] != k) {
+					merged.push_back(adj[u][b]);
+					mark[adj[u][b]] = k;
+				}
+			}
+			for(size_t b=0; b < adj[k].size(); b++) {
+				if(mark[adj[k][b]] != k)
+					merged.push_back(adj[k][b]);
+			}
+			adj[u].swap(merged);
+		}
+	}
+
+	position.resize(n);
+	for(int s=0; s < n; s++)
+		position[order[s]] = s;
+	colRows.assign(n, vector<int>());
+	for(int i=0; i < n; i++) {
+		for(size_t k=0; k < rows[i].col.size(); k++)
+			colRows[rows[i].col[k]].push_back(i);
+	}
+	x.resize(n);
+}
+
+/*
+* solve - solves A x = b by sparse Gaussian elimination. The matrix is overwritten by its factors.
+* The elimination order is found again only if entries were added since the last solution.
+* @param b - right hand side, replaced by the solution x
+* @return 0 or -1 if a zero pivot was found
+*/
+template <class T> int SparseMatrixT<T>::solve(vector<T>& b) {
+	int n = rows.size();
+	int errcode = 0;
+
+	if(entries() != orderedEntries) {
+		orderNodes();
+		orderedEntries = entries();
+	}
+
+	// forward elimination, entries in columns that are already eliminated are ignored
+	for(int s=0; s < n; s++) {
+		int p = order[s];
+		Row& pivotRow = rows[p];
+		T pivot = pivotRow[p];
+
+		if(anyOf(pivot == 0)) {
+			errcode = -1;
+			continue;
+		}
+		for(size_t r=0; r < colRows[p].size(); r++) {
+			int i = colRows[p][r];
+			if(position[i] <= s)
+				continue;
+			Row& row = rows[i];
+			T factor = row[p] / pivot;
+			if(allOf(factor == 0))
+				continue;
+			for(size_t k=0; k < pivotRow.col.size(); k++) {
+				int j = pivotRow.col[k];
+				if(position[j] <= s)
+					continue;
+				size_t rowEntries = row.col.size();
+				row[j] -= factor * pivotRow.val[k];
+				if(row.col.size() > rowEntries)		// fill in
+					colRows[j].push_back(i);
+			}
+			b[i] -= factor * b[p];
+		}
+	}
+
+	// back substitution
+	for(int s=n-1; s >= 0; s--) {
+		int p = order[s];
+		Row& row = rows[p];
+		T sum = b[p];
+		for(size_t k=0; k < row.col.size(); k++) {
+			int j = row.col[k];
+			if(position[j] > s)
+				sum -= row.val[k] * x[j];
+		}
+		x[p] = sum / row[p];
+	}
+	for(int i=0; i < n; i++)
+		b[i] = x[i];
+
+	return errcode;
+}
 
 #endif
\ No newline at end of file
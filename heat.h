@@ -0,0 +1,1057 @@
+#pragma once
+#ifndef heat_h
+#define heat_h
+
+#include <type_traits>
+#include "functions.h"
+#include "airnet.h"
+#include "constants.h"
+#include "gauss.h"
+#include "dual.h"
+#include "lanes.h"
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+// The attic and house heat balance is templated on its scalar type. The simulation uses double,
+// Dual<N> (dual.h) gives the derivatives of all node temperatures with respect to N inputs of the heat balance in the
+// same pass, with the flows from the leakage network held fixed (test_heat), and
+// Lanes<N> (lanes.h) solves the heat balance of N variants of the house at once (test_heat, the simulation loop runs one
+// variant). Branches on values that can differ between the variants use choose(), branches on the building
+// description (roof insulation nodes, duct location) use uniform().
+
+// Building layouts sub_heat is compiled for, so the branches on the layout are settled by the compiler. heatLayout()
+// picks the layout of a building once and heatBalanceFor() the sub_heat instance for it. HL_GENERAL keeps the branches
+// at run time, for ducts that are neither in the attic nor in the house.
+enum heatLayoutFlags {
+	HL_ROOF_INSULATION = 1,		// interior insulation at the roof deck, nodes 16 and 17
+	HL_DUCTS_IN_HOUSE = 2,		// ducts in the conditioned space, otherwise in the attic
+	HL_RADIANT_BARRIER = 4,		// radiant barrier on the sheathing
+	HL_GENERAL = 8
+};
+
+const double IDEAL_TOLERANCE = 0.01;	// ideal loads hold the house air this close to the setpoint (K)
+
+/*
+* heatTranCoef()
+*
+* Calculates heat transfer coefficient (hT) using combination of natural and forced convection from Ford
+* From Walker (1993) eqn 3-41, 3-55
+* @param tempi - surface temperature (deg K)
+* @param tempa - air temperature (deg K)
+* @param velocity - air velocity (m/s)
+* @return heat transfer coefficient (W/m2K)
+* convectionCoef() takes pow(velocity, 0.8) instead, so it is found once for all the surfaces in the same air stream
+*/
+
+template <class T> T convectionCoef(T tempi, T tempa, T velocityFactor) {
+	T hNatural = 3.2 * pow(abs(tempi - tempa), 1.0 / 3.0); 		// Natural convection from Ford
+	T tFilm = (tempi + tempa) / 2;                					// film temperature
+	T hForced = (18.192 - .0378 * tFilm) * velocityFactor;		// forced convection from Ford
+	return pow((pow(hNatural, 3) + pow(hForced, 3)), 1.0 / 3.0);      // combine using cube
+}
+
+template <class T> T heatTranCoef(T tempi, T tempa, T velocity) {
+	return convectionCoef(tempi, tempa, pow(velocity, 0.8));
+}
+
+/*
+* radTranCoef()
+*
+* Calculates radiation heat transfer coefficient (hR) using linearized solution from Holman.
+* From Walker (1993) eqn 3-23
+* @param emissivity - surface emissivity
+* @param tempi - surface temperature of first surface (deg K)
+* @param tempj - surface temperature of second surface (deg K)
+* @param viewFactor - view factor between surfaces Fi-j
+* @param areaRatio - ratio of surface areas (Ai/Aj)
+* @return heat transfer coefficient (W/m2K)
+* radResistance() is the part that only depends on the surfaces, HeatCoefficients keeps it for each pair
+*/
+
+template <class T> T radResistance(double emissivity, T viewFactor, T areaRatio) {
+	return (1 - emissivity) / emissivity + 1 / viewFactor + (1 - emissivity) / emissivity * areaRatio;
+}
+
+template <class T> T radTranCoef(double emissivity, T tempi, T tempj, T viewFactor, T areaRatio) {
+	T rT = radResistance(emissivity, viewFactor, areaRatio);
+	return SIGMA * (tempi + tempj) * (pow(tempi, 2) + pow(tempj, 2)) / rT;
+}
+
+/*
+* HeatCoefficients
+*
+* The parts of the sub_heat node equations that only depend on the building: the surface areas, the radiation view
+* factors, the radiation resistance (radResistance) of each pair of surfaces that see each other, the roof finish and
+* the heat capacities and U-values of the solid nodes. building() works them out on the first sub_heat call and again
+* only when the building inputs change, so each call only evaluates the temperature and flow dependent parts. The
+* caller keeps it between sub_heat calls like the matrix A, HeatModel keeps both for a simulation. HeatModel works
+* them out once when it is constructed and fixes them, so its sub_heat calls do not compare the building inputs.
+*/
+template <class T> class HeatCoefficients {
+	private:
+		vector<T> buildingInputs;									// building inputs the coefficients were worked out for
+		bool ready;
+		bool fixed;														// the building does not change, building() has nothing to do
+
+		void radPair(int i, int j, T resistance) {
+			radPairs.push_back(make_pair(i, j));
+			radRes[i][j] = resistance;
+		}
+
+	public:
+		T area[ATTIC_NODES];
+		T viewFactor[ATTIC_NODES][ATTIC_NODES];
+		T radRes[ATTIC_NODES][ATTIC_NODES];					// radResistance of the pairs in radPairs
+		vector< pair<int, int> > radPairs;						// surfaces i, j with radiation from i to j
+		T heatCap[ATTIC_NODES];										// heat capacities (J/K), sub_heat fills in the air nodes
+		T uVal[ATTIC_NODES];											// U-values (W/m2K), sub_heat fills in the ceiling and ducts
+		double absorptivityRoof, emissivityRoof;				// of the roof finish
+
+		HeatCoefficients() { ready = false; fixed = false; }
+
+		// the coefficients stay as they are for the rest of the simulation
+		void fix() { fixed = true; }
+
+		/*
+		* building - works out the coefficients if the building has changed
+		* @param ... - the sub_heat inputs of the same names
+		*/
+		void building(int roofType, T sheathArea, T bulkArea, T planArea, T floorArea, T roofPitch, T retDiameter,
+			T retThickness, T retLength, T supDiameter, T supThickness, T supLength, bool ductsInHouse, int roofInNorth,
+			int roofInSouth, double emissivitySheathing, T roofExtRval, T roofIntRval, T ceilRval, T gableEndRval,
+			T storyHeight) {
+			if(fixed)
+				return;
+			T inputs[] = { T(roofType), sheathArea, bulkArea, planArea, floorArea, roofPitch, retDiameter, retThickness,
+				retLength, supDiameter, supThickness, supLength, T(ductsInHouse), T(roofInNorth), T(emissivitySheathing),
+				roofExtRval, roofIntRval, ceilRval, gableEndRval, storyHeight };
+			int numInputs = sizeof(inputs) / sizeof(inputs[0]);
+			bool same = ready;
+			T denShingles, cpShingles, Rshingles;
+
+			for(int i=0; same && i < numInputs; i++)
+				same = allOf(inputs[i] == buildingInputs[i]);
+			if(same)
+				return;
+			buildingInputs.assign(inputs, inputs + numInputs);
+			ready = true;
+			radPairs.clear();
+			for(int i=0; i < ATTIC_NODES; i++) {
+				for(int j=0; j < ATTIC_NODES; j++)
+					viewFactor[i][j] = 0;
+			}
+
+			// Surface Area of Nodes
+			area[1] = sheathArea;
+			area[3] = area[1];
+
+			// the following are commented out for ConSOl because cement tile is flat and does not have increased surface area
+			if(roofType == 2 || roofType == 3) {
+		        area[2] = 1.5 * area[1];	   // tile roof has more surface area for convection heat transfer
+			} else {
+				area[2] = area[1];																
+			}
+
+		   area[4] = area[2];
+			area[5] = bulkArea;
+			area[6] = planArea;									         // Ceiling
+			area[7] = area[6];											   // Attic floor
+			area[8] = planArea / 2 * tan(roofPitch * M_PI / 180);	// Total endwall area (assumes 2:1 aspect ratio)
+			area[9] = area[8];
+			area[10] = (retDiameter + 2 * retThickness) * M_PI * retLength;
+			area[11] = M_PI * retLength * retDiameter;
+			area[13] = (supDiameter + 2 * supThickness) * M_PI * supLength;
+			area[14] = M_PI * supLength * supDiameter;
+
+			// surface area of inside of house minus the end walls, roof and ceiling
+			// Currently assuming two stories with heights of 2.5m and 3.0m
+			//area[15] = 3 * pow(floorArea, .5) * 2 + 2.5 * pow(floorArea, .5) * 2 + 2 * floorArea;
+			//area[15] = numStories * storyHeight * pow(planArea, .5) * 2 + (2 * (numStories -1)) * planArea;
+			area[15] = 11 * pow(floorArea,0.5) + 2 * floorArea;	// Empirically derived relationship
+			area[12] = 6 * area[15];									//  Surface area of everything in the house
+			area[16] = area[1];
+			area[17] = area[3];
+
+			// Radiation view factors
+			/* 
+			Only 5 nodes are involved in radiation transfer in the attic:
+			North roof(1), South roof(3), Ceiling(7), Return duct(10), and Supply duct(13)
+			The endwalls have a very small contribution to radiation exchange and are neglected.
+			The wood may or may not contribute to radiation exchange, but their geometry is
+			too complex to make any assumptions so it is excluded.
+		   */
+
+		   viewFactor[7][1] = 1 / 2.0;
+		   viewFactor[7][3] = viewFactor[7][1];
+		   viewFactor[1][7] = viewFactor[7][1] * area[7] / area[1];
+		   viewFactor[3][7] = viewFactor[1][7];
+			if(ductsInHouse) { //  Ducts in the house
+				viewFactor[1][3] = (1 - viewFactor[1][7]);
+				viewFactor[3][1] = (1 - viewFactor[3][7]);
+			} else {			// ducts in the attic
+				// 33.3% of each duct sees each sheathing surface (top third of duct)
+				viewFactor[13][1] = 1 / 2.0;
+				viewFactor[10][1] = viewFactor[13][1];
+				viewFactor[13][3] = viewFactor[13][1];
+				viewFactor[10][3] = viewFactor[13][1];
+
+				viewFactor[1][13] = viewFactor[13][1] * (area[13] / 3) / area[1];
+				viewFactor[1][10] = viewFactor[10][1] * (area[10] / 3) / area[1];
+				viewFactor[3][13] = viewFactor[13][3] * (area[13] / 3) / area[3];
+				viewFactor[3][10] = viewFactor[10][3] * (area[10] / 3) / area[3];
+				viewFactor[1][3] = (1 - viewFactor[1][7] - viewFactor[1][10] - viewFactor[1][13]);
+				viewFactor[3][1] = (1 - viewFactor[3][7] - viewFactor[3][10] - viewFactor[3][13]);
+
+				// North Sheathing
+				radPair(roofInNorth, 10, radResistance(emissivitySheathing, viewFactor[1][10], area[1]/(area[10]/3)));
+				radPair(roofInNorth, 13, radResistance(emissivitySheathing, viewFactor[1][13], area[1]/(area[13]/3)));
+
+				// South Sheathing
+				radPair(roofInSouth, 10, radResistance(emissivitySheathing, viewFactor[3][10], area[3]/(area[10]/3)));
+				radPair(roofInSouth, 13, radResistance(emissivitySheathing, viewFactor[3][13], area[3]/(area[13]/3)));
+
+
+				// Return Ducts (note, No radiative exchange w/ supply ducts)
+				radPair(10, roofInSouth, radResistance(emissivityWood, viewFactor[10][3], area[10]/area[3]));
+				radPair(10, roofInNorth, radResistance(emissivityWood, viewFactor[10][1], area[10]/area[1]));
+
+				// Supply Ducts (note, No radiative exchange w/ return ducts)
+				radPair(13, roofInSouth, radResistance(emissivityWood, viewFactor[13][3], area[13]/area[3]));
+				radPair(13, roofInNorth, radResistance(emissivityWood, viewFactor[13][1], area[13]/area[1]));
+			}
+
+
+			// North Sheathing
+			radPair(roofInNorth, roofInSouth, radResistance(emissivitySheathing, viewFactor[1][3], area[1]/area[3]));
+			radPair(roofInNorth, 7, radResistance(emissivitySheathing, viewFactor[1][7], area[1]/area[7]));
+
+			// South Sheathing
+			radPair(roofInSouth, roofInNorth, radResistance(emissivitySheathing, viewFactor[3][1], area[3]/area[1]));
+			radPair(roofInSouth, 7, radResistance(emissivitySheathing, viewFactor[3][7], area[3]/area[7]));
+
+			// Attic Floor
+			radPair(7, roofInSouth, radResistance(emissivityWood, viewFactor[7][3], area[7]/area[3]));
+			radPair(7, roofInNorth, radResistance(emissivityWood, viewFactor[7][1], area[7]/area[1]));
+
+			// underside of ceiling
+			radPair(6, 12, radResistance(emissivityWood, T(1), area[6]/area[12]));
+
+			switch(roofType) {
+				case 1:			// asphalt shingles
+					absorptivityRoof = .92;
+					emissivityRoof = .91;
+					Rshingles = .078;										// ASHRAE Fundamentals 2011 pg 26.7
+					denShingles = 1100 * 2 * .005;					// asphalt shingles (factor of two because they overlap)
+					cpShingles = 1260;									// CP asphalt shingles
+					break;
+				case 2: 			// red clay tile - edited for ConSol to be light brown concrete
+					absorptivityRoof = .58; 											// .67
+					emissivityRoof = .9;
+					Rshingles = 0.5;                             // Assume this includes air space but no documentation. Seems high
+					denShingles = 50;										// kg/m2
+					cpShingles = 880;										// CP for tile roof
+					break;
+				case 3:			// low coating clay tile
+					absorptivityRoof = .5;
+					emissivityRoof = .9;
+					Rshingles = 0.5;                             // Assume this includes air space but no documentation. Seems high
+					denShingles = 50;
+					cpShingles = 880;										// CP for tile roof
+					break;
+				case 4:			// asphalt shingles  & white coating
+					absorptivityRoof = .15;
+					emissivityRoof = .91;
+					Rshingles = .078;										// ASHRAE Fundamentals 2011 pg 26.7
+					denShingles = 1100 * 2 * .005;					// asphalt shingles (factor of two because they overlap)
+					cpShingles = 1260;									// CP asphalt shingles
+					break;
+				case 5:			// prescriptive roof tile finish per Title 24 2016 Prescriptive Package A, CZ 10-15.
+					absorptivityRoof = .8; //0.8
+					emissivityRoof = .9; //Brennan changed from 0.75 to align with all other roof finishes.
+					Rshingles = .5;
+					denShingles = 50; //50
+					cpShingles = 880;										// CP for tile roof
+					break;
+			}
+
+			// Ducts
+			double supCp = 753.624;											// Specific heat capacity of steel [j/kg/K]
+			double suprho = 16.018 * 2;									// Supply duct density. The factor of two represents the plastic and sprical [kg/m^3]
+			double retCp = 753.624;											// Specific heat capacity of steel [j/kg/K]
+			double retrho = 16.018 * 2;									// Return duct density [kg/m^3]
+
+			// Heat capacities (J/kgK) of the solid nodes
+			heatCap[1] = .5 * area[1] * densitySheathing * thickSheathing * 1210;	// half of sheathing
+			heatCap[2] = heatCap[1] + area[1] * denShingles * cpShingles;				// other half plus shingles
+			heatCap[3] = heatCap[1];
+			heatCap[4] = heatCap[2];
+			heatCap[5] = area[5] * 0.013 * densityWood * 1630;								// 13mm equivalent thickness for 2x4 trusses
+			heatCap[6] = 0.5 * area[6] * 10 * 1150;											// half of drywall
+			heatCap[7] = heatCap[6] + area[7] * ceilRval * 0.7 * 840;					// half of drywall + all of insulation
+			heatCap[8] = .5 * area[8] * densityWood * thickSheathing * 1210;
+			heatCap[9] = heatCap[8];
+			heatCap[10] = retLength * M_PI * (retDiameter + retThickness) * retThickness * retrho * retCp;
+			//  maybe not - 02/2004 need to increase house mass with furnishings and their area: say 5000kg furnishings
+			// mass of walls (5 cm effctive thickness) + mass of slab (aso 5 cm thick)
+			heatCap[12] = (storyHeight * pow(floorArea, .5) * 4 * 2000 * .01 + planArea * .05 * 2000) * 1300;
+			heatCap[13] = supLength * M_PI * (supDiameter + supThickness) * supThickness * suprho * supCp;
+			heatCap[16] = area[16] * roofIntRval * 0.7 * 840; // 0.7kg/m2/R-val = 20kg/m3 * 0.035W/mK for fiberglass, 840 from 2009 ASHRAE fund, ch26, tbl 4 
+			heatCap[17] = heatCap[16];
+
+			// U-values
+			uVal[1] = 1 / ((thickSheathing / kWood) + Rshingles + roofExtRval);
+			uVal[2] = uVal[1];
+			uVal[3] = uVal[1];
+			uVal[4] = uVal[1];
+			uVal[8] = 1 / gableEndRval;
+			uVal[9] = uVal[8];
+			if(roofInNorth == 16) {			// interior insulation at the roof deck
+				uVal[16] = 1 / roofIntRval;
+				uVal[17] = 1 / roofIntRval;
+			}
+		}
+};
+
+template <class T, int LAYOUT = HL_GENERAL> void sub_heat (
+	T& tempOut, 
+	//T& airDensityRef, 
+	//T& airTempRef, 
+	T& mCeiling, 
+	T& AL4, 
+	T& windSpeed, 
+	T& ssolrad, 
+	T& nsolrad, 
+	T* tempOld, 
+	T& atticVolume, 
+	T& houseVolume, 
+	T& skyCover, 
+	T* x,
+	T& floorArea, 
+	T& roofPitch, 
+	T& ductLocation, 
+	T& mSupReg, 
+	T& mRetReg, 
+	T& mRetLeak, 
+	T& mSupLeak, 
+	T& mAH, 
+	T& supRval, 
+	T& retRval, 
+	T& supDiameter, 
+	T& retDiameter, 
+	T& supThickness, 
+	T& retThickness, 
+	T& supVel, 
+	T& retVel, 
+	int& pRef, 
+	T& HROUT, 
+	T& uaSolAir,
+	T& uaTOut, 
+	T& matticenvin, 
+	T& matticenvout, 
+	T& mHouseIN, 
+	T& mHouseOUT, 
+	T& planArea, 
+	T& mSupAHoff, 
+	T& mRetAHoff, 
+	T& solgain, 
+	T& tsolair, 
+	T& mFanCycler, 
+	T& roofPeakHeight, 
+	T& retLength,
+	T& supLength,
+	int& roofType,
+	T roofExtRval,
+	T roofIntRval,
+	T ceilRval,
+	T gableEndRval,
+	int& AHflag, 
+	T& mERV_AH,
+	T& ERV_SRE,
+	T& mHRV,
+	T& HRV_ASE,
+	T& mHRV_AH,
+	T& capacityc,
+	T& capacityh,
+	T& evapcap,
+	T& internalGains,
+	//int bsize,
+	T& airDensityIN,
+	T& airDensityOUT,
+	T& airDensityATTIC,
+	T& airDensitySUP,
+	T& airDensityRET,
+	int& numStories,
+	T& storyHeight,
+	T dhSensibleGain,
+	T& innerNorthH,
+	T& innerSouthH,
+	T& bulkH,
+	T bulkArea,
+	T sheathArea,
+	int radiantBarrier,
+	int numZones,
+	zone_struct* zone,
+	SparseMatrixT<T>& A,
+	HeatCoefficients<T>& coef,
+	double timeStep,
+	T holdHouse = T(0),			// 1 holds the house air at houseSetpoint, 0 solves its balance
+	T houseSetpoint = T(0),
+	T* houseLoad = 0				// returns the heat the held house air takes, cooling < 0 (W), none if 0
+) {
+	vector<T> b;
+	typename SparseMatrixT<T>::Row houseRow;		// balance of the house air while it is held
+	T houseB = 0;
+	T toldcur[ATTIC_NODES], tempSquared[ATTIC_NODES];
+	T htCoef[ATTIC_NODES];
+	T (&area)[ATTIC_NODES] = coef.area;
+	T (&heatCap)[ATTIC_NODES] = coef.heatCap;
+	T (&uVal)[ATTIC_NODES] = coef.uVal;
+	T rtCoef[ATTIC_NODES][ATTIC_NODES];
+	T kAir;
+	T muAir;
+	T characteristicVelocity;
+	T HI;
+	T gndCoef2, gndCoef4, skyCoef2, skyCoef4;
+	T FRS, FG;
+	T TSKY, PW;
+	T TGROUND;
+	int heatIterations;
+	int roofInNorth, roofInSouth;
+	double emissivitySheathing; //emissivity of the sheathing, depends on radiantBarrier (1=yes, 0=no). 
+	const bool general = (LAYOUT & HL_GENERAL) != 0;
+	const bool roofInsulation = general ? uniform(roofIntRval > 0) : (LAYOUT & HL_ROOF_INSULATION) != 0;
+	const bool ductsInHouse = general ? uniform(ductLocation == 1) : (LAYOUT & HL_DUCTS_IN_HOUSE) != 0;
+	const bool ductsInAttic = general ? uniform(ductLocation == 0) : (LAYOUT & HL_DUCTS_IN_HOUSE) == 0;
+	const bool radiant = general ? radiantBarrier == 1 : (LAYOUT & HL_RADIANT_BARRIER) != 0;
+	const int attic_nodes = roofInsulation ? 18 : 16;
+
+	// Node 0 is the Attic Air
+	// Node 1 is the Inner North Sheathing
+	// Node 2 is the Outer North Sheathing
+	// Node 3 is the Inner South Sheathing
+	// Node 4 is the Outer South Sheathing
+	// Node 5 is all of the Wood (joists, trusses, etc.) lumped together
+	// Node 6 is the Ceiling of the House
+	// Node 7 is the Floor of the Attic
+	// Node 8 is the Inner Gable Wall (both lumped together)
+	// Node 9 is the Outer Gable Wall (both lumped together)
+	// Node 10 is the Return Duct Outer Surface
+	// Node 11 is the Return Duct Air
+	// Node 12 is The Mass of the House
+	// Node 13 is the Supply Duct Outer Surface
+	// Node 14 is the Supply Duct Air
+	// Node 15 is the House Air (all one zone)
+	// Node 16 is the Inner North Roof Insulation
+	// Node 17 is the Inner South Roof Insulation
+	// Zones from the zone file add an air node and a mass node each after the attic and house nodes
+
+	if(roofInsulation) {   // If there is interior insulation at the roof add nodes 16&17
+      roofInNorth = 16;
+      roofInSouth = 17;
+      }
+   else {                  // No insulation so interior nodes are the sheathing surface (1&3)
+      roofInNorth = 1;
+      roofInSouth = 3;
+   }
+   
+   //Set roof sheathing emissivity based on presence of radiant barrier.
+   if(radiant){
+   		emissivitySheathing = emissivityRadiantBarrier;
+   } else {
+   		emissivitySheathing = emissivityWood;
+   }
+   
+   // set size of equation vectors to number of nodes, A keeps its entries from the last call
+   int numNodes = attic_nodes + 2 * numZones;
+   if(A.size() != numNodes)
+      A.resize(numNodes);
+   b.resize(numNodes, 0);
+
+	PW = HROUT * pRef / (.621945 + HROUT);						// water vapor partial pressure pg 1.9 ASHRAE fundamentals 2009
+	PW = PW / 1000 / 3.38;											// CONVERT TO INCHES OF HG
+	TSKY = tempOut * pow((.55 + .33 * sqrt(PW)), .25);		// TSKY DEPENDS ON PW
+
+	// Surface areas, view factors, roof finish and the heat capacities and U-values of the solid nodes
+	coef.building(roofType, sheathArea, bulkArea, planArea, floorArea, roofPitch, retDiameter, retThickness, retLength,
+		supDiameter, supThickness, supLength, ductsInHouse, roofInNorth, roofInSouth, emissivitySheathing, roofExtRval,
+		roofIntRval, ceilRval, gableEndRval, storyHeight);
+	const double absorptivityRoof = coef.absorptivityRoof;
+	const double emissivityRoof = coef.emissivityRoof;
+
+	// Heat capacities (J/kgK) of the air nodes
+	heatCap[0] = atticVolume * airDensityATTIC * CpAir;							// attic air
+	heatCap[11] = (pow(retDiameter, 2) * M_PI / 4) * retLength * airDensityRET * CpAir;
+	heatCap[14] = (pow(supDiameter, 2) * M_PI / 4) * supLength * airDensitySUP * CpAir;
+	heatCap[15] = houseVolume * airDensityIN * CpAir;
+
+	// U-values of the ceiling, which depend on the direction of the heat flow
+	uVal[6] = choose(ceilRval > 0,
+		choose(tempOld[15] > tempOld[0], 1 / ceilRval + 0.085, 1 / ceilRval),   // From 2013 Res ACM table 2-2 (0.015 * 5.6783)
+		T(0.1));		// sheetrock - 0.016m / 0.16 W/mK
+	uVal[7] = uVal[6];
+
+	// Inner Surface of Ducts
+	// from Holman   Nu(D) = 0.023*Re(D)^0.8*Pr(D)^0.4
+	// Note Use of HI notation
+	// I think that the following may be an imperical relationship
+	// Return Ducts
+	//kAir = 0.02624;											// Thermal conductivity of air, now as function of air temperature
+	kAir = ((1.5207e-11 * tempOld[15] - 4.8574e-8) * tempOld[15] + 1.0184e-4) * tempOld[15] - 0.00039333;
+	muAir = 0.000018462;										// Dynamic viscosity of air (mu) [kg/ms] Make temperature dependent  (this value at 300K)
+	T prandtl = pow((CpAir * muAir / kAir), .4);		// Pr^0.4, the same for both ducts
+	HI = .023 * kAir / retDiameter * pow((retDiameter * airDensityRET * abs(retVel) / muAir), .8) * prandtl;
+	uVal[10] = 1 / (retRval + 1/HI);
+	// Supply Ducts
+	HI = .023 * kAir / supDiameter * pow((supDiameter * airDensitySUP * supVel / muAir), .8) * prandtl;
+	uVal[13] = 1 / (supRval + 1/HI);
+
+	/* most of the surfaces in the attic undergo both natural and forced convection
+	the overall convection is determined by the forced and natural convection coefficients
+	to the THIRD power, adding them, and taking the cubed root.  This is Iain's idea
+	and it seemed to work for him*/
+
+	// Characteristic velocity
+	characteristicVelocity = (matticenvin - matticenvout) / airDensityATTIC / AL4 / 2.0;
+	characteristicVelocity = choose(characteristicVelocity == 0, abs(mCeiling) / airDensityATTIC / AL4 / 2.0, characteristicVelocity);
+	characteristicVelocity = choose(characteristicVelocity == 0, T(.1), characteristicVelocity);
+
+	// convection heat transfer coefficients, the forced convection velocity factor is found once for each air stream
+	T atticFactor = pow(characteristicVelocity, 0.8);
+	T windFactor = pow(windSpeed, 0.8);
+   htCoef[roofInNorth] = convectionCoef(tempOld[roofInNorth], tempOld[0], atticFactor);  // inner north sheathing
+   htCoef[roofInSouth] = convectionCoef(tempOld[roofInSouth], tempOld[0], atticFactor);  // inner south sheathing
+	htCoef[2] = convectionCoef(tempOld[2], tempOut, windFactor);                  // outer north sheathing
+	htCoef[4] = convectionCoef(tempOld[4], tempOut, windFactor);                  // outer south sheathing
+	htCoef[5] = convectionCoef(tempOld[5], tempOld[0], atticFactor);  // Wood (joists,truss,etc.)
+   
+	// Underside of Ceiling. Modified to use fixed numbers from ASHRAE Fundamentals ch.3 on 05/18/2000
+	if(AHflag != 0)
+		htCoef[6] = 9;
+	else
+		htCoef[6] = 6;
+	// House Mass uses ceiling heat transfer coefficient as rest for house heat transfer coefficient	
+	htCoef[12] = htCoef[6];
+
+	htCoef[7] = convectionCoef(tempOld[7], tempOld[0], atticFactor);  // Attic Floor
+	htCoef[8] = convectionCoef(tempOld[8], tempOld[0], atticFactor);  // Inner side of gable endwalls (lumped together)
+	htCoef[9] = convectionCoef(tempOld[9], tempOut, windFactor);                 // Outer side of gable ends
+
+	if(ductsInHouse) { //  Ducts in the house
+		// Outer Surface of Ducts
+		if(AHflag != 0) {
+			htCoef[10] = 9;
+			htCoef[13] = htCoef[10];
+		} else {
+			htCoef[10] = 6;
+			htCoef[13] = htCoef[10];
+		}
+	} else {
+		htCoef[10] = convectionCoef(tempOld[10], tempOld[0], atticFactor);			// Outer Surface of Return Ducts
+		htCoef[13] = convectionCoef(tempOld[13], tempOld[0], atticFactor);			// Outer Surface of Supply Ducts
+	}
+
+   // Pass back wood surface heat transfer coefficients for use by moisture routines
+   innerNorthH = htCoef[roofInNorth];
+   innerSouthH = htCoef[roofInSouth];
+   bulkH = htCoef[5];
+
+
+	// radiation between the attic surfaces
+	for(int i=0; i < attic_nodes; i++)
+		tempSquared[i] = tempOld[i] * tempOld[i];
+	for(size_t p=0; p < coef.radPairs.size(); p++) {
+		int i = coef.radPairs[p].first;
+		int j = coef.radPairs[p].second;
+		rtCoef[i][j] = SIGMA * (tempOld[i] + tempOld[j]) * (tempSquared[i] + tempSquared[j]) / coef.radRes[i][j];
+	}
+
+	// Sky and ground radiation
+	FRS = (1 - skyCover) * (180 - roofPitch) / 180;      	// ROOF-SKY SHAPE FACTOR
+	FG = 1 - FRS;                            					// ROOF-GROUND SHAPE FACTOR
+	TGROUND = tempOut;                           			// ASSUMING GROUND AT AIR TEMP
+	skyCoef4 = choose(skyCover < 1, radTranCoef(emissivityRoof, tempOld[4], TSKY, FRS, T(0)), T(0));
+	skyCoef2 = choose(skyCover < 1, radTranCoef(emissivityRoof, tempOld[2], TSKY, FRS, T(0)), T(0));
+	gndCoef4 = radTranCoef(emissivityRoof, tempOld[4], TGROUND, FG, T(0));
+	gndCoef2 = radTranCoef(emissivityRoof, tempOld[2], TGROUND, FG, T(0));
+
+
+	// ITERATION OF TEMPERATURES WITHIN HEAT SUBROUTINE
+	// THIS ITERATES BETWEEN ALL TEMPERATURES BEFORE RETURNING TO MAIN PROGRAM
+	heatIterations = 0;
+	for(int i=0; i < attic_nodes; i++) {
+		toldcur[i] = tempOld[i];
+	}
+	while(1) {
+
+		heatIterations++;
+		
+		// reset array A to 0
+		A.clear();
+
+		// NODE 0 IS ATTIC AIR
+		A[0][0] = heatCap[0] / timeStep + htCoef[7] * area[7] + htCoef[5] * area[5]
+			        + htCoef[roofInNorth] * area[roofInNorth] + htCoef[roofInSouth] * area[roofInSouth]
+			        + area[8] * htCoef[8] - mRetLeak * CpAir - matticenvout * CpAir;
+		b[0] = heatCap[0] * tempOld[0] / timeStep + matticenvin * CpAir * tempOut;
+		// ceiling flow from attic to house or from house to attic
+		A[0][0] += choose(mCeiling >= 0, mCeiling * CpAir + mSupAHoff * CpAir + mRetAHoff * CpAir, T(0));
+		b[0] += choose(mCeiling >= 0, mSupLeak * CpAir * toldcur[14],
+			-mCeiling * CpAir * toldcur[15] - mSupAHoff * CpAir * toldcur[14]
+			- mRetAHoff * CpAir * toldcur[11] + mSupLeak * CpAir * toldcur[14]);
+		A[0][roofInNorth] = -htCoef[roofInNorth] * area[roofInNorth];
+		A[0][roofInSouth] = -htCoef[roofInSouth] * area[roofInSouth];
+		A[0][5] = -htCoef[5] * area[5];
+		A[0][7] = -htCoef[7] * area[7];
+		A[0][8] = -htCoef[8] * area[8];
+		if(ductsInAttic) {		// duct surface conduction loss to attic
+			A[0][0] +=  htCoef[13] * area[13] / 2 + htCoef[10] * area[10] / 2;
+			A[0][10] = -htCoef[10] * area[10] / 2;
+			A[0][13] = -htCoef[13] * area[13] / 2;
+		}
+
+		// NODE 1 IS INSIDE NORTH SHEATHING
+   	if(roofInsulation) {
+         A[1][1] = heatCap[1] / timeStep + uVal[16] * area[1] + area[1] * uVal[1];
+         b[1] = heatCap[1] * tempOld[1] / timeStep;
+         A[1][2] = -area[1] * uVal[1];
+         A[1][16] = -area[1] * uVal[16];
+      }
+      else {
+         A[1][0] = -htCoef[1] * area[1];
+         A[1][1] = heatCap[1] / timeStep + htCoef[1] * area[1] + area[1] * uVal[1] + rtCoef[1][3] * area[1] + rtCoef[1][7] * area[1];
+         b[1] = heatCap[1] * tempOld[1] / timeStep;
+         A[1][2] = -area[1] * uVal[1];
+         A[1][3] = -rtCoef[1][3] * area[1];
+         A[1][7] = -rtCoef[1][7] * area[1];
+
+         if(ductsInAttic) {			// duct surface radiation to sheathing
+            A[1][1] += rtCoef[1][10] * area[1] + rtCoef[1][13] * area[1];
+            A[1][10] = -rtCoef[1][10] * area[1];
+            A[1][13] = -rtCoef[1][13] * area[1];
+         }
+      }
+
+		// NODE 2 IS OUTSIDE NORTH SHEATHING
+		A[2][1] = -area[1] * uVal[2];
+		A[2][2] = heatCap[2] / timeStep + htCoef[2] * area[2] + area[1] * uVal[2] + skyCoef2 * area[1] + gndCoef2 * area[1];
+		b[2] = heatCap[2] * tempOld[2] / timeStep + htCoef[2] * area[2] * tempOut + area[1] * nsolrad * absorptivityRoof
+		     + skyCoef2 * area[1] * TSKY + gndCoef2 * area[1] * TGROUND;
+
+		// NODE 3 IS INSIDE SOUTH SHEATHING
+   	if(roofInsulation) {
+         A[3][3] = heatCap[3] / timeStep + uVal[17] * area[3] + area[3] * uVal[3];
+         b[3] = heatCap[3] * tempOld[3] / timeStep;
+         A[3][4] = -area[3] * uVal[3];
+         A[3][17] = -area[3] * uVal[17];
+      }
+      else {
+         A[3][0] = -htCoef[3] * area[3];
+         A[3][1] = -rtCoef[3][1] * area[3];
+         A[3][3] = heatCap[3] / timeStep + htCoef[3] * area[3] + area[3] * uVal[3] + rtCoef[3][1] * area[3] + rtCoef[3][7] * area[3];
+         b[3] = heatCap[3] * tempOld[3] / timeStep;
+         A[3][4] = -area[3] * uVal[3];
+         A[3][7] = -rtCoef[3][7] * area[3];
+
+         if(ductsInAttic) {			// duct surface radiation to sheathing
+            A[3][3] += rtCoef[3][10] * area[3] + rtCoef[3][13] * area[3];
+            A[3][10] = -rtCoef[3][10] * area[3];
+            A[3][13] = -rtCoef[3][13] * area[3];
+         }
+      }
+
+		// NODE 4 IS OUTSIDE SOUTH SHEATHING
+		A[4][3] = -area[3] * uVal[4];
+		A[4][4] = heatCap[4] / timeStep + htCoef[4] * area[4] + area[3] * uVal[4] + skyCoef4 * area[3] + gndCoef4 * area[3];
+		b[4] = heatCap[4] * tempOld[4] / timeStep + htCoef[4] * area[4] * tempOut + area[3] * ssolrad * absorptivityRoof
+		     + skyCoef4 * area[3] * TSKY + gndCoef4 * area[3] * TGROUND;
+
+		// NODE 5 IS MASS OF WOOD IN ATTIC I.E. JOISTS AND TRUSSES
+		A[5][0] = -htCoef[5] * area[5];
+		A[5][5] = heatCap[5] / timeStep + htCoef[5] * area[5];
+		b[5] = heatCap[5] * tempOld[5] / timeStep;
+
+		// NODE 6 ON INSIDE OF CEILING
+		A[6][6] = heatCap[6] / timeStep + htCoef[6] * area[6] + rtCoef[6][12] * area[6] + area[6] * uVal[6];
+		b[6] = heatCap[6] / timeStep * tempOld[6];
+		A[6][7] = -area[6] * uVal[6];
+		A[6][15] = -htCoef[6] * area[6];
+		A[6][12] = -rtCoef[6][12] * area[6];
+
+		// NODE 7 ON ATTIC FLOOR
+		A[7][0] = -htCoef[7] * area[7];
+		A[7][roofInNorth] = -rtCoef[7][roofInNorth] * area[7];
+		A[7][roofInSouth] = -rtCoef[7][roofInSouth] * area[7];
+		A[7][6] = -area[7] * uVal[7];
+		A[7][7] = heatCap[7] / timeStep + htCoef[7] * area[7] + rtCoef[7][roofInNorth] * area[7] + rtCoef[7][roofInSouth] * area[7] + area[7] * uVal[7];				// + HR8t11 * area[7] + HR8t14 * area[7]
+		b[7] = heatCap[7] / timeStep * tempOld[7];
+
+		// NODE 8 IS INSIDE ENDWALLS THAT ARE BOTH LUMPED TOGETHER
+		A[8][0] = -htCoef[8] * area[8];
+		A[8][8] = heatCap[8] / timeStep + htCoef[8] * area[8] + area[8] * uVal[8];
+		A[8][9] = -area[8] * uVal[8];
+		b[8] = heatCap[8] * tempOld[8] / timeStep;
+
+		// NODE 9 IS OUTSIDE ENDWALLS THAT ARE BOTH LUMPED TOGETHER
+		A[9][8] = -area[9] * uVal[9];
+		A[9][9] = heatCap[9] / timeStep + htCoef[9] * area[9] + area[9] * uVal[9];
+		b[9] = heatCap[9] * tempOld[9] / timeStep + htCoef[9] * area[9] * tempOut;
+
+		// NODE 10 Exterior Return Duct Surface
+		// Remember that the fluid properties are evaluated at a constant temperature
+		// therefore, the convection on the inside of the ducts is
+		A[10][11] = -area[11] * uVal[10];
+		b[10] = heatCap[10] * tempOld[10] / timeStep;
+		if(ductsInHouse) {			// ducts in house
+			A[10][10] = heatCap[10] / timeStep + htCoef[10] * area[10] + area[11] * uVal[10];
+			A[10][15] = -area[10] * htCoef[10];
+		} else {
+			A[10][0] = -area[10] * htCoef[10] / 2;
+			A[10][roofInNorth] = -area[10] * rtCoef[10][roofInNorth] / 3;
+			A[10][roofInSouth] = -area[10] * rtCoef[10][roofInSouth] / 3;
+			A[10][10] += heatCap[10] / timeStep + htCoef[10] * area[10] / 2 + area[11] * uVal[10]
+			          + area[10] * rtCoef[10][roofInNorth] / 3 + area[10] * rtCoef[10][roofInSouth] / 3;
+		}
+		
+		// NODE 11 Air in return duct
+		A[11][10] = -area[11] * uVal[10];
+		A[11][11] = choose(mCeiling >= 0,
+			// flow from attic to house
+			heatCap[11] / timeStep + area[11] * uVal[10] + mAH * CpAir + mRetAHoff * CpAir,
+			// flow from house to attic
+			heatCap[11] / timeStep + area[11] * uVal[10] + mAH * CpAir - mRetAHoff * CpAir);
+		b[11] = choose(mCeiling >= 0,
+			heatCap[11] * tempOld[11] / timeStep + mRetAHoff * CpAir * toldcur[0]
+			      - mRetLeak * CpAir * toldcur[0] - mRetReg * CpAir * toldcur[15]
+			      - mFanCycler * CpAir * tempOut - mHRV_AH * CpAir * ((1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15])
+			      - mERV_AH * CpAir * ((1-ERV_SRE) * tempOut + ERV_SRE * tempOld[15]),
+			heatCap[11] * tempOld[11] / timeStep - mRetAHoff * CpAir * toldcur[15]
+			      - mRetLeak * CpAir * toldcur[0] - mRetReg * CpAir * toldcur[15]
+			      - mFanCycler * CpAir * tempOut - mHRV_AH * CpAir * ((1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15])
+			      - mERV_AH * CpAir * ((1-ERV_SRE) * tempOut + ERV_SRE * tempOld[15]));
+
+		// Node 12 is the mass of the structure of the house that interacts
+		// with the house air to increase its effective thermal mass
+		// 95% of solar gain goes to house mass, 5% to house air
+		A[12][12] = heatCap[12] / timeStep + htCoef[12] * area[12] + rtCoef[6][12] * area[6];
+		A[12][15] = -htCoef[12] * area[12];
+		A[12][6] = -rtCoef[6][12] * area[6];
+		b[12] = heatCap[12] * tempOld[12] / timeStep + .95 * solgain;
+
+		// NODE 13 Exterior Supply Duct Surface
+		b[13] = heatCap[13] * tempOld[13] / timeStep;
+		A[13][14] = -area[14] * uVal[13];
+		if(ductsInHouse) {			// ducts in house
+			A[13][13] = heatCap[13] / timeStep + htCoef[13] * area[13] + area[14] * uVal[13];
+			A[13][15] = -area[13] * htCoef[13];
+		} else {
+			A[13][0] = -area[13] * htCoef[13] / 2;
+			A[13][roofInNorth] = -area[13] * rtCoef[13][roofInNorth] / 3;
+			A[13][roofInSouth] = -area[13] * rtCoef[13][roofInSouth] / 3;
+			A[13][13] = heatCap[13] / timeStep + htCoef[13] * area[13] / 2 + area[14] * uVal[13]
+			          + area[13] * rtCoef[13][roofInNorth] / 3 + area[13] * rtCoef[13][roofInSouth] / 3;
+		}
+
+		// NODE 14 Air in SUPPLY duct
+		// capacity is AC unit capacity in Watts
+		// this is a sensible heat balance, the moisture is balanced in a separate routine.
+		A[14][13] = -area[14] * uVal[13];
+		A[14][14] = choose(mCeiling >= 0,
+			// flow from attic to house
+			heatCap[14] / timeStep + area[14] * uVal[13] + mSupReg * CpAir
+			          + mSupLeak * CpAir + mSupAHoff * CpAir,
+			// flow from house to attic
+			heatCap[14] / timeStep + area[14] * uVal[13] + mSupReg * CpAir
+			          + mSupLeak * CpAir - mSupAHoff * CpAir);
+		b[14] = choose(mCeiling >= 0,
+			heatCap[14] * tempOld[14] / timeStep - capacityc + capacityh + evapcap
+			      + mAH * CpAir * toldcur[11] + mSupAHoff * CpAir * toldcur[0],
+			heatCap[14] * tempOld[14] / timeStep - capacityc + capacityh + evapcap
+			      + mAH * CpAir * toldcur[11] - mSupAHoff * CpAir * toldcur[15]);
+
+		// NODE 15 AIR IN HOUSE
+		// use solair tmeperature for house UA
+		A[15][15] = choose(mCeiling >= 0,
+			// flow from attic to house
+			heatCap[15] / timeStep + htCoef[6] * area[6] - mRetReg * CpAir
+			          - mHouseOUT * CpAir + htCoef[12] * area[12] + uaSolAir + uaTOut,
+			// flow from house to attic
+			heatCap[15] / timeStep + htCoef[6] * area[6] - mCeiling * CpAir
+			          - mSupAHoff * CpAir - mRetAHoff * CpAir - mRetReg * CpAir
+			          - mHouseOUT * CpAir + htCoef[12] * area[12] + uaSolAir + uaTOut);
+		b[15] = choose(mCeiling >= 0,
+			heatCap[15] * tempOld[15] / timeStep + (mHouseIN - mHRV) * CpAir * tempOut
+			      + mHRV * CpAir * (( 1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15])
+			      + uaSolAir * tsolair + uaTOut * tempOut + .05 * solgain + mSupReg * CpAir * toldcur[14] 
+				   + mCeiling * CpAir * toldcur[0] + mSupAHoff * CpAir * toldcur[14]
+				   + mRetAHoff * CpAir * toldcur[11] + internalGains + dhSensibleGain,
+			heatCap[15] * tempOld[15] / timeStep + (mHouseIN - mHRV) * CpAir * tempOut
+			      + mHRV * CpAir * ((1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15]) + uaSolAir * tsolair
+			      + uaTOut * tempOut + .05 * solgain + mSupReg * CpAir * toldcur[14] + internalGains + dhSensibleGain);
+		A[15][6] = -htCoef[6] * area[6];
+		A[15][12] = -htCoef[12] * area[12];
+		if(ductsInHouse) {
+			// ducts in house
+			A[15][15] += area[10] * htCoef[10] + area[13] * htCoef[13];
+			A[15][10] = -area[10] * htCoef[10];
+			A[15][13] = -area[13] * htCoef[13];
+		}
+
+   	if(roofInsulation) {
+         // NODE 16 IS INSIDE NORTH Insulation
+         A[16][0] = -htCoef[16] * area[16];
+         A[16][1] = -area[16] * uVal[16];
+         A[16][16] = heatCap[16] / timeStep + htCoef[16] * area[16] + area[16] * uVal[16] + rtCoef[16][17] * area[16] + rtCoef[16][7] * area[16];
+         b[16] = heatCap[16] * tempOld[16] / timeStep;
+         A[16][17] = -rtCoef[16][17] * area[16];
+         A[16][7] = -rtCoef[16][7] * area[16];
+
+         if(ductsInAttic) {			// duct surface radiation to insulation
+            A[16][16] += rtCoef[16][10] * area[16] + rtCoef[16][13] * area[16];
+            A[16][10] = -rtCoef[16][10] * area[16];
+            A[16][13] = -rtCoef[16][13] * area[16];
+         }
+
+         // NODE 17 IS INSIDE SOUTH Insulation
+         A[17][0] = -htCoef[17] * area[17];
+         A[17][3] = -area[17] * uVal[17];
+         A[17][17] = heatCap[17] / timeStep + htCoef[17] * area[17] + area[17] * uVal[17] + rtCoef[17][16] * area[17] + rtCoef[17][7] * area[17];
+         b[17] = heatCap[17] * tempOld[17] / timeStep;
+         A[17][16] = -rtCoef[17][16] * area[17];
+         A[17][7] = -rtCoef[17][7] * area[17];
+
+         if(ductsInAttic) {			// duct surface radiation to insulation
+            A[17][17] += rtCoef[17][10] * area[17] + rtCoef[17][13] * area[17];
+            A[17][10] = -rtCoef[17][10] * area[17];
+            A[17][13] = -rtCoef[17][13] * area[17];
+         }
+      }
+
+		// ZONES
+		// all air exchange with the house and between zones is implicit so the zones are solved with the house
+		for(int i=0; i < numZones; i++) {
+			int air = attic_nodes + 2 * i;
+			int mass = air + 1;
+			int link = (zone[i].link == ZONE_HOUSE) ? 15 : attic_nodes + 2 * (zone[i].link - NUM_BASE_ZONES);
+			double zoneHeight = zone[i].top - zone[i].bottom;
+			double capAir = zone[i].volume * airDensityRef * airTempRef / zone[i].tempOld * CpAir;
+			// walls and slab as for the house mass
+			double capMass = (zoneHeight * pow(zone[i].floorArea, .5) * 4 * 2000 * .01 + zone[i].floorArea * .05 * 2000) * 1300;
+			double hAmass = 6 * (2 * zone[i].floorArea + 4 * pow(zone[i].floorArea, .5) * zoneHeight);
+			T mSupZone = zone[i].supplyFraction * mSupReg;			// supply air returned to the house through the zone
+
+			// NODE air IS ZONE AIR
+			A[air][air] += capAir / timeStep + zone[i].UA + zone[i].UAlink + hAmass - zone[i].mOUT * CpAir + mSupZone * CpAir;
+			A[air][mass] = -hAmass;
+			A[air][link] -= zone[i].UAlink + zone[i].mLinkIn * CpAir;
+			A[air][15] -= zone[i].mFromHouse * CpAir;
+			b[air] = capAir * zone[i].tempOld / timeStep + (zone[i].UA + zone[i].mOutside * CpAir) * tempOut
+			       + mSupZone * CpAir * toldcur[14] + zone[i].internalGains;
+
+			// linked zone or house
+			A[link][link] += zone[i].UAlink;
+			A[link][air] -= zone[i].UAlink - zone[i].mLinkOut * CpAir;
+
+			// house inflow from the zone is at the zone temperature rather than outside
+			A[15][air] -= zone[i].mHouse * CpAir + mSupZone * CpAir;
+			b[15] -= zone[i].mHouse * CpAir * tempOut + mSupZone * CpAir * toldcur[14];
+
+			// NODE mass IS ZONE MASS
+			A[mass][mass] = capMass / timeStep + hAmass;
+			A[mass][air] = -hAmass;
+			b[mass] = capMass * zone[i].tempMassOld / timeStep;
+		}
+
+		// ideal loads: the house air is held at the setpoint in place of its balance, the load is what the balance is short
+		if(houseLoad) {
+			houseRow = A[15];
+			houseB = b[15];
+			for(size_t k=0; k < A[15].col.size(); k++)
+				A[15].val[k] = choose(holdHouse > 0, A[15].col[k] == 15 ? T(1) : T(0), A[15].val[k]);
+			b[15] = choose(holdHouse > 0, houseSetpoint, b[15]);
+		}
+
+		A.solve(b);
+
+		if(houseLoad) {
+			T load = -houseB;
+			for(size_t k=0; k < houseRow.col.size(); k++)
+				load += houseRow.val[k] * b[houseRow.col[k]];
+			*houseLoad = holdHouse * load;
+		}
+
+		if(allOf(abs(b[0] - toldcur[0]) < .1)) {
+			break;
+		} else {
+            if(anyOf(isnan(b[0]))) {
+                cout << "NAN in gauss elimination. Exiting" << endl;
+                exit(-1);
+                }
+//cout << "+";
+			for(int i=0; i < attic_nodes; i++) {
+				toldcur[i] = b[i];
+			}
+		}
+	} // END of DO LOOP
+	for (int i=0; i<attic_nodes; i++) {
+		x[i] = b[i];
+		}
+	for(int i=0; i < numZones; i++) {
+		zone[i].temp = value(b[attic_nodes + 2 * i]);
+		zone[i].tempMass = value(b[attic_nodes + 2 * i + 1]);
+	}
+}
+
+/*
+* heatLayout - layout of a building for sub_heat
+* @param roofIntRval - interior roof insulation R-value
+* @param ductLocation - 0 = attic, 1 = house
+* @param radiantBarrier - 1 = radiant barrier on the sheathing
+* @return heatLayoutFlags
+*/
+inline int heatLayout(double roofIntRval, double ductLocation, int radiantBarrier) {
+	if(ductLocation != 0 && ductLocation != 1)
+		return HL_GENERAL;
+	return (roofIntRval > 0 ? HL_ROOF_INSULATION : 0) | (ductLocation == 1 ? HL_DUCTS_IN_HOUSE : 0)
+		| (radiantBarrier == 1 ? HL_RADIANT_BARRIER : 0);
+}
+
+template <class T> using heatBalanceFunction = decltype(&sub_heat<T, HL_GENERAL>);
+
+/*
+* heatBalanceFor - the sub_heat instance compiled for a layout
+* @param layout - from heatLayout()
+* @return sub_heat instance
+*/
+template <class T> heatBalanceFunction<T> heatBalanceFor(int layout) {
+	switch(layout) {
+		case 0: return sub_heat<T, 0>;
+		case 1: return sub_heat<T, 1>;
+		case 2: return sub_heat<T, 2>;
+		case 3: return sub_heat<T, 3>;
+		case 4: return sub_heat<T, 4>;
+		case 5: return sub_heat<T, 5>;
+		case 6: return sub_heat<T, 6>;
+		case 7: return sub_heat<T, 7>;
+		default: return sub_heat<T, HL_GENERAL>;
+	}
+}
+
+/*
+* HeatModel
+*
+* The attic and house heat balance of one building for a simulation. The constructor keeps the building description
+* and picks the sub_heat instance for its layout, step() takes the weather, flows and temperatures of a time step. The
+* matrix and the HeatCoefficients are kept between steps, so the areas, heat capacities and U-values of the building
+* are worked out in the first step and each step after only assembles the parts that change.
+* After idealLoads() each step holds the house air at the thermostat setpoint instead of letting equipment cycle around
+* it. sub_heat fixes the house air node at the setpoint and the load is the residual of its balance, so a step takes one
+* solve. The house is held or left free as in the step before, a held house that would need the opposite load or a free
+* house past the setpoint is solved again the other way, which only happens when the house starts or stops needing a load.
+*/
+template <class T> class HeatModel {
+	private:
+		heatBalanceFunction<T> balance;							// sub_heat compiled for the building layout
+		T atticVolume, houseVolume, floorArea, planArea, roofPitch, roofPeakHeight, AL4;
+		T ductLocation, supRval, retRval, supDiameter, retDiameter, supThickness, retThickness, supLength, retLength;
+		int roofType, numStories, radiantBarrier;
+		T roofExtRval, roofIntRval, ceilRval, gableEndRval, storyHeight, bulkArea, sheathArea;
+		SparseMatrixT<T> A;											// node equations, kept so the elimination order is only found once
+		HeatCoefficients<T> coef;
+		bool ideal;														// ideal loads, the house air is held at the setpoint when it needs a load
+		bool heating;													// held at or above the setpoint, otherwise at or below it
+		T setpoint;
+		T held;															// 1 when the house air was held in the last step, 0 when free
+
+	public:
+		T idealLoad;													// heat added to the house air in the last step, cooling < 0 (W)
+		T idealResidual;												// house air less the setpoint at the end of the last step (K)
+
+		/*
+		* HeatModel - HeatModel class constructor
+		* @param ... - the sub_heat inputs of the same names that describe the building
+		*/
+		HeatModel(T atticVolume, T houseVolume, T floorArea, T planArea, T roofPitch, T roofPeakHeight, T AL4,
+			T ductLocation, T supRval, T retRval, T supDiameter, T retDiameter, T supThickness, T retThickness, T supLength,
+			T retLength, int roofType, T roofExtRval, T roofIntRval, T ceilRval, T gableEndRval, int numStories,
+			T storyHeight, T bulkArea, T sheathArea, int radiantBarrier) :
+			atticVolume(atticVolume), houseVolume(houseVolume), floorArea(floorArea), planArea(planArea),
+			roofPitch(roofPitch), roofPeakHeight(roofPeakHeight), AL4(AL4), ductLocation(ductLocation), supRval(supRval),
+			retRval(retRval), supDiameter(supDiameter), retDiameter(retDiameter), supThickness(supThickness),
+			retThickness(retThickness), supLength(supLength), retLength(retLength), roofType(roofType),
+			numStories(numStories), radiantBarrier(radiantBarrier), roofExtRval(roofExtRval), roofIntRval(roofIntRval),
+			ceilRval(ceilRval), gableEndRval(gableEndRval), storyHeight(storyHeight), bulkArea(bulkArea),
+			sheathArea(sheathArea) {
+			// lanes could differ in the layout, they are run with the general instance that checks they agree
+			int layout = is_same<T, double>::value ? heatLayout(value(roofIntRval), value(ductLocation), radiantBarrier)
+				: HL_GENERAL;
+			balance = heatBalanceFor<T>(layout);
+
+			// the building parts of the coefficients, with the roof and duct nodes sub_heat takes for the layout
+			bool roofInsulation = uniform(roofIntRval > 0);
+			double emissivitySheathing = (radiantBarrier == 1) ? emissivityRadiantBarrier : emissivityWood;
+			coef.building(roofType, sheathArea, bulkArea, planArea, floorArea, roofPitch, retDiameter, retThickness, retLength,
+				supDiameter, supThickness, supLength, uniform(ductLocation == 1), roofInsulation ? 16 : 1, roofInsulation ? 17 : 3,
+				emissivitySheathing, roofExtRval, roofIntRval, ceilRval, gableEndRval, storyHeight);
+			coef.fix();
+			ideal = false;
+			heating = true;
+			setpoint = 0;
+			held = 0;
+			idealLoad = 0;
+			idealResidual = 0;
+		}
+
+		/*
+		* idealLoads - holds the house air at a setpoint in the steps that follow, with no equipment
+		* @param setpoint - thermostat setpoint (deg K)
+		* @param heating - true for a heating load when the house is below the setpoint, false for a cooling load above it
+		*/
+		void idealLoads(T setpoint, bool heating) {
+			ideal = true;
+			this->setpoint = setpoint;
+			this->heating = heating;
+		}
+
+		/*
+		* step - solves the node temperatures at the end of a time step
+		* @param ... - the sub_heat inputs of the same names
+		*/
+		void step(T& tempOut, T& mCeiling, T& windSpeed, T& ssolrad, T& nsolrad, T* tempOld, T& skyCover, T* x, T& mSupReg,
+			T& mRetReg, T& mRetLeak, T& mSupLeak, T& mAH, T& supVel, T& retVel, int& pRef, T& HROUT, T& uaSolAir,
+			T& uaTOut, T& matticenvin, T& matticenvout, T& mHouseIN, T& mHouseOUT, T& mSupAHoff, T& mRetAHoff, T& solgain,
+			T& tsolair, T& mFanCycler, int& AHflag, T& mERV_AH, T& ERV_SRE, T& mHRV, T& HRV_ASE, T& mHRV_AH, T& capacityc,
+			T& capacityh, T& evapcap, T& internalGains, T& airDensityIN, T& airDensityOUT, T& airDensityATTIC,
+			T& airDensitySUP, T& airDensityRET, T dhSensibleGain, T& innerNorthH, T& innerSouthH, T& bulkH, int numZones,
+			zone_struct* zone, double timeStep) {
+			T load = 0;
+			auto solve = [&]() {
+				balance(tempOut, mCeiling, AL4, windSpeed, ssolrad, nsolrad, tempOld, atticVolume, houseVolume, skyCover, x,
+					floorArea, roofPitch, ductLocation, mSupReg, mRetReg, mRetLeak, mSupLeak, mAH, supRval, retRval, supDiameter,
+					retDiameter, supThickness, retThickness, supVel, retVel, pRef, HROUT, uaSolAir, uaTOut, matticenvin,
+					matticenvout, mHouseIN, mHouseOUT, planArea, mSupAHoff, mRetAHoff, solgain, tsolair, mFanCycler,
+					roofPeakHeight, retLength, supLength, roofType, roofExtRval, roofIntRval, ceilRval, gableEndRval, AHflag,
+					mERV_AH, ERV_SRE, mHRV, HRV_ASE, mHRV_AH, capacityc, capacityh, evapcap, internalGains, airDensityIN,
+					airDensityOUT, airDensityATTIC, airDensitySUP, airDensityRET, numStories, storyHeight, dhSensibleGain,
+					innerNorthH, innerSouthH, bulkH, bulkArea, sheathArea, radiantBarrier, numZones, zone, A, coef, timeStep,
+					held, setpoint, ideal ? &load : 0);
+			};
+			solve();
+			if(!ideal)
+				return;
+
+			// a held house that would need the opposite load floats, a free house past the setpoint needs a load
+			T floating = held * choose(heating ? load < 0 : load > 0, T(1), T(0));
+			T past = (1 - held) * choose(heating ? x[15] < setpoint : x[15] > setpoint, T(1), T(0));
+			if(anyOf(floating > 0) || anyOf(past > 0)) {
+				held = held - floating + past;
+				solve();
+			}
+			idealLoad = load;
+			idealResidual = held * (x[15] - setpoint);
+		}
+};
+
+#endif
@@ -0,0 +1,212 @@
+#pragma once
+#ifndef lanes_h
+#define lanes_h
+
+#include <iostream>
+#include <cstdlib>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+/*
+* Lanes
+*
+* N values of one quantity, one for each of N variants of a building run in lockstep (structure of arrays). The attic
+* and house heat balance (sub_heat and HeatModel in heat.h) is templated on its scalar type, so passing Lanes<N> instead
+* of double solves the same equations for all the variants in one pass: the equation assembly, the search for matrix
+* entries and the elimination order are done once for the N lanes and the arithmetic on the lanes is in simple loops
+* the compiler can vectorize.
+* Comparisons give a LaneMask. Branches on values that differ between the variants are written with choose(), which
+* takes each lane from one of two results. Branches that change the equations themselves (node count, duct location)
+* use uniform(), the variants in a batch have to agree on those.
+* Only the heat balance runs in lanes, test_heat checks it against running the variants one at a time. The minute loop
+* of main(), the leakage flow network, the moisture balance and the controllers are double, so a sweep still runs each
+* variant as its own simulation.
+*/
+template <int N> class LaneMask {
+	public:
+		bool m[N];
+};
+
+template <int N> class Lanes {
+	public:
+		double v[N];
+
+		Lanes(double value=0) {
+			for(int i=0; i < N; i++)
+				v[i] = value;
+		}
+
+		double& operator[](int i) { return v[i]; }
+		const double& operator[](int i) const { return v[i]; }
+
+		Lanes& operator+=(const Lanes& a) {
+			for(int i=0; i < N; i++)
+				v[i] += a.v[i];
+			return *this;
+		}
+		Lanes& operator-=(const Lanes& a) {
+			for(int i=0; i < N; i++)
+				v[i] -= a.v[i];
+			return *this;
+		}
+		Lanes& operator*=(const Lanes& a) {
+			for(int i=0; i < N; i++)
+				v[i] *= a.v[i];
+			return *this;
+		}
+		Lanes& operator/=(const Lanes& a) {
+			for(int i=0; i < N; i++)
+				v[i] /= a.v[i];
+			return *this;
+		}
+		Lanes& operator+=(double a) { for(int i=0; i < N; i++) v[i] += a; return *this; }
+		Lanes& operator-=(double a) { for(int i=0; i < N; i++) v[i] -= a; return *this; }
+		Lanes& operator*=(double a) { for(int i=0; i < N; i++) v[i] *= a; return *this; }
+		Lanes& operator/=(double a) { for(int i=0; i < N; i++) v[i] /= a; return *this; }
+};
+
+// Branch helpers for the scalar types, where a comparison is a single bool
+
+inline bool allOf(bool a) { return a; }
+inline bool anyOf(bool a) { return a; }
+inline bool uniform(bool a) { return a; }
+template <class T> T choose(bool c, const T& a, const T& b) { return c ? a : b; }
+
+template <int N> bool allOf(const LaneMask<N>& a) {
+	for(int i=0; i < N; i++) {
+		if(!a.m[i])
+			return false;
+	}
+	return true;
+}
+template <int N> bool anyOf(const LaneMask<N>& a) {
+	for(int i=0; i < N; i++) {
+		if(a.m[i])
+			return true;
+	}
+	return false;
+}
+// a condition that has to be the same in every lane
+template <int N> bool uniform(const LaneMask<N>& a) {
+	for(int i=1; i < N; i++) {
+		if(a.m[i] != a.m[0]) {
+			cerr << "Variants run in lanes differ in an input that changes the equations. Exiting" << endl;
+			exit(-1);
+		}
+	}
+	return a.m[0];
+}
+template <int N> Lanes<N> choose(const LaneMask<N>& c, const Lanes<N>& a, const Lanes<N>& b) {
+	Lanes<N> r;
+	for(int i=0; i < N; i++)
+		r.v[i] = c.m[i] ? a.v[i] : b.v[i];
+	return r;
+}
+
+// the zone structure holds doubles, so lanes are run without zones and the first lane is kept there
+template <int N> double value(const Lanes<N>& a) { return a.v[0]; }
+
+template <int N> Lanes<N> operator-(const Lanes<N>& a) { Lanes<N> r(a); r *= -1; return r; }
+template <int N> Lanes<N> operator+(const Lanes<N>& a) { return a; }
+
+template <int N> Lanes<N> operator+(Lanes<N> a, const Lanes<N>& b) { return a += b; }
+template <int N> Lanes<N> operator+(Lanes<N> a, double b) { return a += b; }
+template <int N> Lanes<N> operator+(double a, Lanes<N> b) { return b += a; }
+template <int N> Lanes<N> operator-(Lanes<N> a, const Lanes<N>& b) { return a -= b; }
+template <int N> Lanes<N> operator-(Lanes<N> a, double b) { return a -= b; }
+template <int N> Lanes<N> operator-(double a, const Lanes<N>& b) { Lanes<N> r(a); return r -= b; }
+template <int N> Lanes<N> operator*(Lanes<N> a, const Lanes<N>& b) { return a *= b; }
+template <int N> Lanes<N> operator*(Lanes<N> a, double b) { return a *= b; }
+template <int N> Lanes<N> operator*(double a, Lanes<N> b) { return b *= a; }
+template <int N> Lanes<N> operator/(Lanes<N> a, const Lanes<N>& b) { return a /= b; }
+template <int N> Lanes<N> operator/(Lanes<N> a, double b) { return a /= b; }
+template <int N> Lanes<N> operator/(double a, const Lanes<N>& b) { Lanes<N> r(a); return r /= b; }
+
+#define LANE_COMPARE(op) \
+template <int N> LaneMask<N> operator op(const Lanes<N>& a, const Lanes<N>& b) { \
+	LaneMask<N> r; for(int i=0; i < N; i++) r.m[i] = a.v[i] op b.v[i]; return r; } \
+template <int N> LaneMask<N> operator op(const Lanes<N>& a, double b) { \
+	LaneMask<N> r; for(int i=0; i < N; i++) r.m[i] = a.v[i] op b; return r; } \
+template <int N> LaneMask<N> operator op(double a, const Lanes<N>& b) { \
+	LaneMask<N> r; for(int i=0; i < N; i++) r.m[i] = a op b.v[i]; return r; }
+
+LANE_COMPARE(==)
+LANE_COMPARE(!=)
+LANE_COMPARE(<)
+LANE_COMPARE(>)
+LANE_COMPARE(<=)
+LANE_COMPARE(>=)
+#undef LANE_COMPARE
+
+template <int N> ostream& operator<<(ostream& os, const Lanes<N>& a) {
+	for(int i=0; i < N; i++)
+		os << (i ? " " : "") << a.v[i];
+	return os;
+}
+
+// f applied to each lane
+template <int N, class F> Lanes<N> eachLane(const Lanes<N>& a, F f) {
+	Lanes<N> r;
+	for(int i=0; i < N; i++)
+		r.v[i] = f(a.v[i]);
+	return r;
+}
+
+template <int N> Lanes<N> exp(const Lanes<N>& a) { return eachLane(a, [](double x) { return exp(x); }); }
+template <int N> Lanes<N> log(const Lanes<N>& a) { return eachLane(a, [](double x) { return log(x); }); }
+template <int N> Lanes<N> sqrt(const Lanes<N>& a) { return eachLane(a, [](double x) { return sqrt(x); }); }
+template <int N> Lanes<N> sin(const Lanes<N>& a) { return eachLane(a, [](double x) { return sin(x); }); }
+template <int N> Lanes<N> cos(const Lanes<N>& a) { return eachLane(a, [](double x) { return cos(x); }); }
+template <int N> Lanes<N> tan(const Lanes<N>& a) { return eachLane(a, [](double x) { return tan(x); }); }
+template <int N> Lanes<N> abs(const Lanes<N>& a) { return eachLane(a, [](double x) { return fabs(x); }); }
+template <int N> Lanes<N> fabs(const Lanes<N>& a) { return abs(a); }
+template <int N> LaneMask<N> isnan(const Lanes<N>& a) {
+	LaneMask<N> r;
+	for(int i=0; i < N; i++)
+		r.m[i] = isnan(a.v[i]);
+	return r;
+}
+// the squares and cubes of the heat transfer coefficients are multiplied out, which the compiler can vectorize
+template <int N> Lanes<N> pow(const Lanes<N>& a, double b) {
+	Lanes<N> r;
+	if(b == 2) {
+		for(int i=0; i < N; i++)
+			r.v[i] = a.v[i] * a.v[i];
+	} else if(b == 3) {
+		for(int i=0; i < N; i++)
+			r.v[i] = a.v[i] * a.v[i] * a.v[i];
+	} else {
+		for(int i=0; i < N; i++)
+			r.v[i] = pow(a.v[i], b);
+	}
+	return r;
+}
+template <int N> Lanes<N> pow(const Lanes<N>& a, const Lanes<N>& b) {
+	Lanes<N> r;
+	for(int i=0; i < N; i++)
+		r.v[i] = pow(a.v[i], b.v[i]);
+	return r;
+}
+template <int N> Lanes<N> pow(double a, const Lanes<N>& b) {
+	Lanes<N> r;
+	for(int i=0; i < N; i++)
+		r.v[i] = pow(a, b.v[i]);
+	return r;
+}
+template <int N> Lanes<N> max(const Lanes<N>& a, const Lanes<N>& b) {
+	Lanes<N> r;
+	for(int i=0; i < N; i++)
+		r.v[i] = (a.v[i] < b.v[i]) ? b.v[i] : a.v[i];
+	return r;
+}
+template <int N> Lanes<N> min(const Lanes<N>& a, const Lanes<N>& b) {
+	Lanes<N> r;
+	for(int i=0; i < N; i++)
+		r.v[i] = (b.v[i] < a.v[i]) ? b.v[i] : a.v[i];
+	return r;
+}
+
+#endif
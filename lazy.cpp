@@ -0,0 +1,86 @@
+#include "lazy.h"
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+/*
+* LazyStage - LazyStage class constructor
+* @param name - name of the stage in the hit rate report
+*/
+LazyStage::LazyStage(string name) {
+	this->name = name;
+	valid = false;
+	evaluations = 0;
+	reuses = 0;
+}
+
+/*
+* input - declares an input of the stage for this call
+* @param value - input value
+* @param threshold - change from the last evaluation allowed before the stage is evaluated again, 0 = any change
+*/
+void LazyStage::input(double value, double threshold) {
+	next.push_back(value);
+	if(this->threshold.size() < next.size())
+		this->threshold.push_back(threshold);
+	else
+		this->threshold[next.size() - 1] = threshold;
+}
+
+/*
+* output - registers a variable the stage writes
+* @param value - the variable, which has to stay at the same address
+*/
+void LazyStage::output(double* value) {
+	outputs.push_back(value);
+	saved.push_back(0);
+	valid = false;
+}
+
+/*
+* reuse - decides whether the stage can be skipped, from the inputs declared since the last call
+* @return true if every input is within its threshold of the last evaluation, the outputs have been put back. False
+* if the stage has to be evaluated, followed by keep().
+*/
+bool LazyStage::reuse() {
+	bool same = valid && next.size() == last.size();
+
+	for(size_t i=0; same && i < next.size(); i++)
+		same = abs(next[i] - last[i]) <= threshold[i];
+	if(same) {
+		for(size_t i=0; i < outputs.size(); i++)
+			*outputs[i] = saved[i];
+		reuses++;
+	} else {
+		last.swap(next);
+		evaluations++;
+	}
+	next.clear();
+	return same;
+}
+
+/*
+* keep - keeps the outputs of an evaluation
+*/
+void LazyStage::keep() {
+	for(size_t i=0; i < outputs.size(); i++)
+		saved[i] = *outputs[i];
+	valid = true;
+}
+
+/*
+* invalidate - the next call evaluates the stage whatever its inputs
+*/
+void LazyStage::invalidate() {
+	valid = false;
+}
+
+/*
+* hitRate - fraction of the calls that reused the last evaluation
+*/
+double LazyStage::hitRate() {
+	long int calls = evaluations + reuses;
+	return calls > 0 ? (double) reuses / calls : 0;
+}
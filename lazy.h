@@ -0,0 +1,41 @@
+#pragma once
+#ifndef lazy_h
+#define lazy_h
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/*
+* LazyStage
+*
+* A stage of the minute calculations that is skipped while its inputs stay close to the inputs of its last evaluation.
+* Each call declares the inputs of the stage with the change each may have before the stage is evaluated again
+* (0 = any change), then reuse() decides. A stage that writes its results into the caller's variables registers them
+* with output() once; they are kept by keep() after each evaluation and put back when the stage is reused.
+* The evaluations and reuses are counted so the savings can be reported at the end of the run.
+*/
+class LazyStage {
+	private:
+		vector<double> last;							// inputs of the last evaluation
+		vector<double> next;							// inputs declared for this call
+		vector<double> threshold;					// change allowed in each input
+		vector<double*> outputs;
+		vector<double> saved;						// outputs of the last evaluation
+		bool valid;										// there is an evaluation to reuse
+
+	public:
+		string name;
+		long int evaluations;
+		long int reuses;
+
+		LazyStage(string name);
+		void input(double value, double threshold = 0);
+		void output(double* value);
+		bool reuse();
+		void keep();
+		void invalidate();
+		double hitRate();
+};
+
+#endif
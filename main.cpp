@@ -4,14 +4,25 @@
 #include <iomanip>		// RAD: so far used only for setprecission() in cmd output
 #include <time.h>
 #include <vector>
+#include <limits>
 #ifdef __APPLE__
    #include <cmath>        // needed for mac g++
 #endif
 #include "functions.h"
+#include "airnet.h"
+#include "gauss.h"
+#include "heat.h"
+#include "timestep.h"
+#include "lazy.h"
+#include "surrogate.h"
+#include "repdays.h"
+#include "parareal.h"
 #include "weather.h"
 #include "psychro.h"
 #include "equip.h"
 #include "moisture.h"
+#include "fans.h"
+#include "control.h"
 #include "constants.h"
 #include "config/config.h"
 
@@ -110,6 +121,48 @@ int main(int argc, char *argv[], char* envp[])
 	double dhDeadBand = config.pDouble("dhDeadBand");				// Dehumidifier dead band (+/- %RH)
 	double cCapAdjustTime = config.pDouble("cCapAdjustTime");	// First minute adjustment of cooling capacity (fraction)
 	int warmupYears = config.pInt("warmupYears");					// Number of years to run for warmup
+	// entries added since 2/8/18 default to the fixed minute run when they are not in the config file
+	int maxTimeStep = config.pInt("maxTimeStep", 1);				// Longest heat and moisture time step (minutes), 1 = fixed minute steps
+	double stepTolerance = config.pDouble("stepTolerance", 0.01);	// Local temperature error allowed per time step (K)
+	int moistureStep = config.pInt("moistureStep", 1);				// Moisture balance time step (minutes)
+	int screeningInterval = config.pInt("screeningInterval", 0);	// Days between full model days of the reduced order screening model, 0 = full model every day
+	int representativeDays = config.pInt("representativeDays", 0);	// Days simulated for clusters of similar weather days, 0 = every day simulated
+	int representativeWarmup = config.pInt("representativeWarmup", 2);	// Days simulated before each representative day
+	int pararealSlices = config.pInt("pararealSlices", 0);				// Parallel in time slices of the run, 0 = serial run
+	int pararealIterations = config.pInt("pararealIterations", 4);	// Most Parareal iterations
+	double pararealTolerance = config.pDouble("pararealTolerance", 0.5);	// Largest jump allowed between Parareal slices (K, hPa, % moisture content, g)
+	int pararealCoarseStep = config.pInt("pararealCoarseStep", 60);	// Time step of the coarse Parareal sweep (minutes)
+	int runStartDay = config.pInt("runStartDay", 0);					// First day of the run period (1 - 365), 0 = whole years
+	int runEndDay = config.pInt("runEndDay", 365);						// Last day of the run period (1 - 365)
+	int runWarmupDays = config.pInt("runWarmupDays", 14);				// Days simulated before the run period
+	double lazyTempThreshold = config.pDouble("lazyTempThreshold", 0);	// Temperature change before the airflows are solved again (K), 0 = any change
+	double lazyWindThreshold = config.pDouble("lazyWindThreshold", 0);	// Wind speed change before the airflows are solved again (m/s), 0 = any change
+	double lazyWindAngleThreshold = config.pDouble("lazyWindAngleThreshold", 0);	// Wind direction change before the airflows are solved again (degrees), 0 = any change
+	bool idealLoads = config.pBool("idealLoads", false);					// House held at the thermostat setpoint with no equipment, for the heating and cooling loads
+
+	// Ideal loads need the heat balance every day in one run for the peak loads
+	if(idealLoads && (screeningInterval > 0 || pararealSlices > 0)) {
+		cerr << "Ideal loads cannot be combined with the screening model or Parareal" << endl;
+		return 1;
+		}
+
+	// A run period is a single pass through part of the weather year
+	if(runStartDay > 0) {
+		if(runStartDay > 365 || runEndDay < runStartDay || runEndDay > 365 || runWarmupDays < 0) {
+			cerr << "Run period must have 1 <= runStartDay <= runEndDay <= 365 and runWarmupDays >= 0" << endl;
+			return 1;
+			}
+		if(representativeDays > 0 || pararealSlices > 0) {
+			cerr << "Run period cannot be combined with representative days or Parareal" << endl;
+			return 1;
+			}
+		warmupYears = 0;
+		}
+
+	// the step lengths are set in minutes and counted in simulation steps
+	maxTimeStep = max(1, maxTimeStep * 60 / STEP_SECONDS);
+	moistureStep = max(1, moistureStep * 60 / STEP_SECONDS);
+	pararealCoarseStep = max(1, pararealCoarseStep * 60 / STEP_SECONDS);
 	
 	// Simulation Batch Timing
 	time_t startTime, endTime;
@@ -129,10 +182,13 @@ int main(int argc, char *argv[], char* envp[])
 		string moistureFileName = outPath + simName + ".hum";
 		string filterFileName = outPath + simName + ".fil";
 		string summaryFileName = outPath + simName + ".rc2";
+		string zoneFileName = inPath + simName + ".zon";
+		string humidityFileName = inPath + simName + ".hcl";
 
 		//Declare arrays
 		double Sw[4];
-		double Swinit[4][361];		
+		double Swinit[4][361];
+		double SwSquared[4][361];		// square of Swinit, which is what the leakage models use		
 		double mFloor[4] = {0,0,0,0};
 		double wallCp[4] = {0,0,0,0};
 		double mechVentPower;
@@ -158,12 +214,12 @@ int main(int argc, char *argv[], char* envp[])
 		double R;						// Ceiling Floor Leakage Sum
 		double X;						// Ceiling Floor Leakage Difference
 		int numFlues;					// Number of flues/chimneys/passive stacks
-		flue_struct flue[6] = {0}; // Flue data structure
+		vector<flue_struct> flue;	// Flue data structure
 		double wallFraction[4]; 	// Fraction of leak in wall 1, 2, 3 and 4
 		double floorFraction[4]; 	// Fraction of leak in floor below wall 1, 2, 3 and 4
 		double flueShelterFactor;	// Shelter factor at the top of the flue (1 if the flue is higher than surrounding obstacles
 		int numPipes;					// Number of passive vents but appears to do much the same as flues
-		pipe_struct Pipe[10] = {0};	// Pipe data structure	
+		vector<pipe_struct> Pipe;	// Pipe data structure	
 		double Hfloor;
 		string rowOrIsolated;		// House in a row (R) or isolated (any string other than R)
 		bool rowHouse;					// Flag that house is in a row
@@ -175,9 +231,9 @@ int main(int argc, char *argv[], char* envp[])
 		double uaFloor;				// UA of floor or slab (no solar gain, not used for cooling load) (W/K)
 		double uaWindow;				// UA of windows for conductive gain (W/K)
 		int numWinDoor;
-		winDoor_struct winDoor[10] = {0}; // Window and Door data structure
+		vector<winDoor_struct> winDoor; // Window and Door data structure
 		int numFans;
-		fan_struct fan[10] = {0};	// Fan data structure
+		vector<fan_struct> fan;	// Fan data structure
 		double windowWE;
 		double windowN;
 		double windowS;
@@ -191,13 +247,15 @@ int main(int argc, char *argv[], char* envp[])
 		double soffitFraction[5];
 		soffit_struct soffit[4] = {0};	// Soffit data structure
 		int numAtticVents;
-		atticVent_struct atticVent[10] = {0};	// Attic vent data structure
+		vector<atticVent_struct> atticVent;	// Attic vent data structure
 		double roofPitch;
 		string roofPeakOrient;		// Roof peak orientation, D = perpendicular to front of house (Wall 1), P = parrallel to front of house
 		bool roofPeakPerpendicular;
 		double roofPeakHeight;
 		int numAtticFans;
-		fan_struct atticFan[10] = {0};	// Attic fan data structure
+		vector<fan_struct> atticFan;	// Attic fan data structure
+		int numZones = 0;				// Number of zones other than the house and attic (crawlspaces, garages, other conditioned zones)
+		vector<zone_struct> zone;	// Zone data structure, read from the optional zone file
 		double roofIntRval;
 		double roofIntThick;
 		double roofExtRval;
@@ -248,20 +306,7 @@ int main(int argc, char *argv[], char* envp[])
 		int OccContType;			// Type of occupancy control to be used in the RIVEC calculations. 1,2,...n Brennan.
 		int AuxFanIndex; 			// Index value that determines if auxiliary fans (dryer, kitchen and bath fans) are counted towards RIVEC relative exposure calculations
 
-		// Following are for humidity control logic
-		//double wCutoff;			// Humidity Ratio cut-off calculated as some percentile value for the climate zone. Brennan.
-		//double wDiffMaxNeg;		// Maximum average indoor-outdoor humidity differene, when wIn < wOut. Climate zone average.
-		//double wDiffMaxPos;		// Maximum average indoor-outdoor humidity differene, when wIn > wOut. Climate zone average.
-		//double W25[12]; 			// 25th percentiles for each month of the year, per TMY3
-		//double W75[12]; 			// 75th percentiles for each month of the year, per TMY3
-		//int FirstCut;				// Monthly Indexes assigned based on climate zone
-		//int SecondCut; 			// Monthly Indexes assigned based on climate zone
-		//double doseTarget;		// Targeted dose value
-		//double HiDose;				// Variable high dose value for real-time humidity control, based on worst-case large, low-occupancy home. 
-		//int HiMonths[3];
-		//int LowMonths[3];
-		//double HiMonthDose;
-		//double LowMonthDose;
+		// the humidity control settings are in the optional humidity control file (ControlSettings)
 
 		double dhCapacity;		// Dehumidifier capacity (pints/day)
 		double dhEnergyFactor;	// Dehumidifier energy factor (L/kWh)
@@ -270,10 +315,8 @@ int main(int argc, char *argv[], char* envp[])
 		string endOfFile;
 		
 		// Zeroing the variables to create the sums for the .ou2 file
-		long int minuteTotal = 1;
+		long int stepTotal = 1;
 		int endrunon = 0;
-		double Mcoil = 0;
-		double SHR = 0;		
 		double meanOutsideTemp = 0;
 		double meanAtticTemp = 0;
 		double meanHouseTemp = 0;
@@ -314,6 +357,7 @@ int main(int argc, char *argv[], char* envp[])
 		buildingFile >> R;
 		buildingFile >> X;
 		buildingFile >> numFlues;
+		flue.assign(numFlues, flue_struct());
 		for(int i=0; i < numFlues; i++) {
 			buildingFile >> flue[i].flueC;
 			buildingFile >> flue[i].flueHeight;
@@ -330,6 +374,7 @@ int main(int argc, char *argv[], char* envp[])
 
 		buildingFile >> flueShelterFactor;
 		buildingFile >> numPipes;
+		Pipe.assign(numPipes, pipe_struct());
 		for(int i=0; i < numPipes; i++) {
 			buildingFile >> Pipe[i].wall;
 			buildingFile >> Pipe[i].h;
@@ -352,6 +397,7 @@ int main(int argc, char *argv[], char* envp[])
 
 		// ====================== Venting Inputs (Windows/Doors)====================
 		buildingFile >> numWinDoor;
+		winDoor.assign(numWinDoor, winDoor_struct());
 		// These are not currently used in the Excel input generating spreadsheet
 		for(int i=0; i < numWinDoor; i++) {
 			buildingFile >> winDoor[i].wall;
@@ -363,6 +409,7 @@ int main(int argc, char *argv[], char* envp[])
 
 		// ================== Mechanical Venting Inputs (Fans etc) =================
 		buildingFile >> numFans;
+		fan.assign(numFans, fan_struct());
 		for(int i=0;  i < numFans; i++) {
 			buildingFile >> fan[i].power;
 			buildingFile >> fan[i].q;
@@ -391,6 +438,7 @@ int main(int argc, char *argv[], char* envp[])
 
 		// =========================== Attic Vent Inputs ===========================
 		buildingFile >> numAtticVents;
+		atticVent.assign(numAtticVents, atticVent_struct());
 		for(int i=0; i < numAtticVents; i++) {
 			buildingFile >> atticVent[i].wall;
 			buildingFile >> atticVent[i].h;
@@ -403,6 +451,7 @@ int main(int argc, char *argv[], char* envp[])
 		buildingFile >> roofPeakOrient;
 		buildingFile >> roofPeakHeight;
 		buildingFile >> numAtticFans;
+		atticFan.assign(numAtticFans, fan_struct());
 		for(int i = 0; i < numAtticFans; i++) {
 			buildingFile >> atticFan[i].power;
 			buildingFile >> atticFan[i].q;
@@ -462,25 +511,6 @@ int main(int argc, char *argv[], char* envp[])
 		buildingFile >> rivecFlagInd;
 		buildingFile >> OccContType; //Now the OccContType for SVC_Occupancy.
 		buildingFile >> AuxFanIndex; //Index value that determines if auxiliary fans (dryer, kitchen and bath fans) are counted towards RIVEC relative exposure calculations
-// 		if(HumContType > 0) {
-// 			buildingFile >> wCutoff;
-// 			buildingFile >> wDiffMaxNeg;
-// 			buildingFile >> wDiffMaxPos;
-// 			for(int i = 0; i < 12; i++) {
-// 				buildingFile >> W25[i];
-// 			}
-// 			for(int i = 0; i < 12; i++) {
-// 				buildingFile >> W75[i];
-// 			}
-// 			buildingFile >> FirstCut;
-// 			buildingFile >> SecondCut;
-// 			buildingFile >> doseTarget;
-// 			buildingFile >> HiDose;
-// 			buildingFile >> HiMonths[0] >> HiMonths[1] >> HiMonths[2];
-// 			buildingFile >> LowMonths[0] >> LowMonths[1] >> LowMonths[2];
-// 			buildingFile >> HiMonthDose;
-// 			buildingFile >> LowMonthDose;
-// 		}
 		buildingFile >> dhCapacity;	
 		buildingFile >> dhEnergyFactor;
 		buildingFile >> dhSetPoint;	
@@ -494,6 +524,25 @@ int main(int argc, char *argv[], char* envp[])
 
 		buildingFile.close();
 
+		// Zone file (optional) =======================================================================
+		// one line per zone: type link volume floorArea bottom top UA UAlink C n linkC linkn linkHeight supplyFraction internalGains
+		ifstream zoneFile(zoneFileName);
+		if(zoneFile) {
+			zoneFile >> numZones;
+			zone.assign(numZones, zone_struct());
+			for(int i=0; i < numZones; i++) {
+				zoneFile >> zone[i].type >> zone[i].link >> zone[i].volume >> zone[i].floorArea >> zone[i].bottom >> zone[i].top;
+				zoneFile >> zone[i].UA >> zone[i].UAlink >> zone[i].C >> zone[i].n >> zone[i].linkC >> zone[i].linkn >> zone[i].linkHeight;
+				zoneFile >> zone[i].supplyFraction >> zone[i].internalGains;
+				bool linkOK = (zone[i].link == ZONE_HOUSE) || (zone[i].link >= NUM_BASE_ZONES && zone[i].link < NUM_BASE_ZONES + numZones && zone[i].link != NUM_BASE_ZONES + i);
+				if(!zoneFile || !linkOK || zone[i].top <= zone[i].bottom) {
+					cerr << "Error in zone file: " << zoneFileName << " zone " << i + 1 << endl;
+					return 1;
+				}
+			}
+			zoneFile.close();
+		}
+
 		// [END] Read in Building Inputs ============================================================================================================================================
 
 		// ================= READ IN OTHER INPUT FILES =================================================
@@ -544,6 +593,8 @@ int main(int argc, char *argv[], char* envp[])
 		double angle;
 		for(int i=0; i < 361; i++) {
 			shelterFile >> angle >> Swinit[0][i] >> Swinit[1][i] >> Swinit[2][i] >> Swinit[3][i];
+			for(int k=0; k < 4; k++)
+				SwSquared[k][i] = pow(Swinit[k][i],2);
 		}
 		shelterFile.close();
 
@@ -555,7 +606,10 @@ int main(int argc, char *argv[], char* envp[])
 				cerr << "Cannot open output file: " << outputFileName << endl;
 				return 1; 
 			}
-			outputFile << "Time\tMin\twindSpeed\ttempOut\ttempHouse\tsetpoint\ttempAttic\ttempSupply\ttempReturn\tAHflag\tAHpower\tcompressPower\tmechVentPower\tHR\tSHR\tMcoil\thousePress\tQhouse\tACH\tACHflue\tventSum\tnonRivecVentSum\tfan1\tfan2\tfan3\tfan4\tfan5\tfan6\tfan7\trivecOn\trelExp\trelDose\toccupied\tHROUT\tHRattic\tHRreturn\tHRsupply\tHRhouse\tRHhouse\tHumidityIndex\tDHcondensate\tPollutantConc\tmoldIndex_South\tmoldIndex_North\tmoldIndex_BulkFraming\tmHouseIN\tmHouseOUT\tmCeilingAll\tmatticenvin\tmatticenvout\tmSupReg\tmRetReg\tqHouseIN\tqHouseOUT\tqCeilingAll\tqAtticIN\tqAtticOUT\tqSupReg\tqRetReg" << endl; 
+			outputFile << "Time\tMin\twindSpeed\ttempOut\ttempHouse\tsetpoint\ttempAttic\ttempSupply\ttempReturn\tAHflag\tAHpower\tcompressPower\tmechVentPower\tHR\tSHR\tMcoil\thousePress\tQhouse\tACH\tACHflue\tventSum\tnonRivecVentSum\tfan1\tfan2\tfan3\tfan4\tfan5\tfan6\tfan7\trivecOn\trelExp\trelDose\toccupied\tHROUT\tHRattic\tHRreturn\tHRsupply\tHRhouse\tRHhouse\tHumidityIndex\tDHcondensate\tPollutantConc\tmoldIndex_South\tmoldIndex_North\tmoldIndex_BulkFraming\tmHouseIN\tmHouseOUT\tmCeilingAll\tmatticenvin\tmatticenvout\tmSupReg\tmRetReg\tqHouseIN\tqHouseOUT\tqCeilingAll\tqAtticIN\tqAtticOUT\tqSupReg\tqRetReg";
+			for(int i=0; i < numZones; i++)
+				outputFile << "\ttempZone" << i + 1 << "\tPzone" << i + 1;
+			outputFile << endl;
 		}
 
 		// Moisture output file
@@ -639,9 +693,8 @@ int main(int argc, char *argv[], char* envp[])
 		double bulkArea = planArea * 1;  // Area of bulk wood in the attic (m2) - based on W trusses, 24oc, 60x36 house w/ 4/12 attic
 		double sheathArea = planArea / 2 / cos(roofPitch * M_PI / 180);         // Area of roof sheathing (m2)
 		hcapacity = hcapacity * .29307107 * 1000 * AFUE;			// Heating capacity of furnace converted from kBtu/hr to Watts and with AFUE adjustment
-		// Cooling capacity air flow correction term (using CFM)
-		double qAH_cfm = qAH_cool / .0004719;
-		double qAHcorr = 1.62 - .62 * qAH_cfm / (400 * capacityraw) + .647 * log(qAH_cfm / (400 * capacityraw));	
+		Compressor compressor(EERari, capacityari, capacityraw, charge, cCapAdjustTime);		// air conditioner
+		compressor.setAirflow(qAH_cool);								// Cooling capacity air flow correction term
 
 		// AL4 is used to estimate flow velocities in the attic
 		double AL4 = atticC * sqrt(airDensityRef / 2) * pow(4, (atticPressureExp - .5));
@@ -700,6 +753,13 @@ int main(int argc, char *argv[], char* envp[])
 		tempOld[2] = 278;
 		tempOld[4] = 278;
 
+		for(int i=0; i < numZones; i++) {
+			zone[i].temp = airTempRef;
+			zone[i].tempOld = airTempRef;
+			zone[i].tempMass = airTempRef;
+			zone[i].tempMassOld = airTempRef;
+		}
+
 		double tempAttic = tempOld[0];
 		double tempReturn = tempOld[11];
 		double tempSupply = tempOld[14];
@@ -739,6 +799,12 @@ int main(int argc, char *argv[], char* envp[])
 		double expLimit = 5; //Maximum relative exposure limit, 62.2-2016. Old Max way: 1 + 4 * (1 - rivecX) / (1 + rivecY);	// Exposure limit for RIVEC algorithm. This is the Max Sherman way of calculating the maximum limit. 
 		//We have moved away from using this, and instead just use a value of 2.5, based on ratios of chronic to acute pollutant exposure limits.
 
+		ControlSettings controlSettings(OccContType, expLimit);
+		if(!controlSettings.readHumidityControl(humidityFileName)) {
+			cerr << "Error in humidity control file: " << humidityFileName << endl;
+			return 1;
+		}
+
 		long int rivecMinutes = 0;					// Counts how many minutes of the year that RIVEC is on
 		long int occupiedMinCount = 0;			// Counts the number of minutes in a year that the house is occupied
 		
@@ -795,7 +861,7 @@ int main(int argc, char *argv[], char* envp[])
 // 		double relDoseRealOld = 0;
 		
 
-		int AHminutes;
+		int AHseconds;				// Air handler operation in the hour (seconds)
 		int target;
 		int dryerFan = 0;			// Dynamic schedule flag for dryer fan (0 or 1)
 		int kitchenFan = 0;		// Dynamic schedule flag for kitchen fan (0 or 1)
@@ -803,8 +869,8 @@ int main(int argc, char *argv[], char* envp[])
 		int bathTwoFan = 0;		// Dynamic schedule flag for second bathroom fan (0 or 1)
 		int bathThreeFan = 0;	// Dynamic schedule flag for third bathroom fan (0 or 1)
 		int weekend;
-		int compTime = 0;
-		int compTimeCount = 0;
+		double compTime = 0;		// Minutes the compressor has run at the end of the step, 0 once the start up ramps are over
+		int compSeconds = 0;		// Compressor operation in the cooling cycle (seconds)
 		int rivecOn = 0;		   // 0 (off) or 1 (on) for RIVEC devices
 		int hcFlag = 1;         // Start with HEATING (simulations start in January)
 		double setpoint;			// Thermostat setpoint
@@ -825,7 +891,6 @@ int main(int argc, char *argv[], char* envp[])
 		double qAH;						// Air flowrate of the Air Handler (m^3/s)
 		double uaSolAir;
 		double uaTOut;
-		double econodt = 0;			// Temperature difference between inside and outside at which the economizer operates
 		double supVelAH;			// Air velocity in the supply ducts
 		double retVelAH;			// Air velocity in the return ducts
 		double qSupReg;				// Airflow rate in the supply registers
@@ -850,16 +915,9 @@ int main(int argc, char *argv[], char* envp[])
 		double mRetAHoff=0;
 		double evapcap = 0;
 		double latcap = 0;
-		double capacity = 0;
 		double capacityh = 0;
 		double compressorPower = 0;
 		double capacityc = 0;
-		double chargecapd = 0;
-		double chargeeerd = 0;
-		double EER = 0;
-		double chargecapw = 0;
-		double chargeeerw = 0;
-		double Mcoilprevious = 0;
 		double mCeiling = 0;
 		double mHouseIN = 0;
 		double mCeilingIN = 0; //Ceiling mass flows, not including register flows. Brennan added for ventilation load calculations.
@@ -901,9 +959,15 @@ int main(int argc, char *argv[], char* envp[])
 		double HumidityIndex = 0;
 		double HumidityIndex_Sum = 0;
 		double HumidityIndex_Avg = 0;
-		//double coolingLoad = 0;
-		//double latLoad = 0;
-		//double heatingLoad = 0;
+		double coolingLoad = 0;				// Ideal loads: sensible cooling, heating and latent loads (W x minutes, kWh at the end)
+		double latLoad = 0;
+		double heatingLoad = 0;
+		double peakCoolingLoad = 0;			// largest loads of a heat balance step (W)
+		double peakLatentLoad = 0;
+		double peakHeatingLoad = 0;
+		double idealSensible = 0;			// heat added to the house air to hold the setpoint, cooling < 0 (W)
+		double idealLatent = 0;				// moisture removed from the house air to hold it at 50% RH (W)
+		double idealResidual = 0;			// largest difference between the house air and the setpoint in a step (K)
 		
 		//Mold Index variables
 		double moldIndex_South = 0;
@@ -931,7 +995,36 @@ int main(int argc, char *argv[], char* envp[])
 		Dehumidifier dh(dhCapacity, dhEnergyFactor, dhSetPoint, dhDeadBand);									// instantiate Dehumidifier 
 		Moisture moisture_nodes(atticVolume, retDiameter, retLength, supDiameter, supLength,
 			 houseVolume, floorArea, sheathArea, bulkArea, roofIntThick, roofExtRval, atticMCInit);   // instantiate moisture model
+		moisture_nodes.subStep = moistureStep;
 		Weather weatherFile(terrain, eaveHeight);																		// instantiate weatherFile object
+		FlowNetwork leakNetwork;																							// house and attic airflow network
+		HeatModel<double> heatModel(atticVolume, houseVolume, floorArea, planArea, roofPitch, roofPeakHeight, AL4, ductLocation,	// attic and house heat balance
+			supRval, retRval, supDiameter, retDiameter, supThickness, retThickness, supLength, retLength, roofType, roofExtRval,
+			roofIntRval, ceilRval, gableEndRval, numStories, storyHeight, bulkArea, sheathArea, radiantBarrier);
+		FanTable fanTable(fan, houseVolume, supDiameter, retDiameter, OccContType, rivecFlag);						// what each fan does every step
+		FanState fanState = { AHflag, AHseconds, target, rivecOn, econoFlag, hcFlag, weekend, dryerFan, kitchenFan, bathOneFan, bathTwoFan,
+			bathThreeFan, qAH, qAH_cool, qAH_heat, supLF, retLF, fanPower_cooling, supVelAH, retVelAH, qSupReg, qRetReg, qRetLeak, qSupLeak,
+			mAH, mSupReg, mRetReg, mRetReg1, mSupLeak, mRetLeak, mFanCycler, mHRV, mHRV_AH, mERV_AH, mechVentPower, AHfanPower, AHfanHeat, fanHeat,
+			ventSumIN, ventSumOUT, nonRivecVentSumIN, nonRivecVentSumOUT, 0, 0, 0, 0 };
+		LazyStage leakStage("airflows");																				// house and attic airflows reused while their inputs hold
+		TimeStep timeStep(maxTimeStep, stepTolerance);																	// adaptive heat and moisture step control
+		vector<double> stepEvents, stepStart, stepEnd, stepTemps;
+		Surrogate surrogate;																										// reduced order screening model
+		bool fullDay = true;																										// full model today, the reduced order model otherwise
+		double screenStart[RS_STATES], screenState[RS_STATES], screenInput[RI_INPUTS], screenFlow[RF_FLOWS];
+		sub_leakNetwork(leakNetwork, envPressureExp, eaveHeight, leakFracCeil, leakFracFloor, leakFracWall, numFlues, flue.data(), wallFraction, floorFraction,
+			flueShelterFactor, numWinDoor, winDoor.data(), numFans, fan.data(), numPipes, Pipe.data(), Crawl, Hfloor, rowHouse, supC, supn, retC, retn,
+			weatherFile.windPressureExp, atticPressureExp, roofPeakHeight, roofPitch, roofPeakPerpendicular, soffitFraction, soffit, numAtticVents, atticVent.data(),
+			numAtticFans, atticFan.data(), numZones, zone.data());
+		double* leakOutputs[] = { &mIN, &mOUT, &Pint, &mFlue, &mCeiling, &dPflue, &Patticint, &mHouseIN, &mHouseOUT, &mSupAHoff, &mRetAHoff,
+			&mAtticIN, &mAtticOUT, &matticenvin, &matticenvout, &mFloor[0], &mFloor[1], &mFloor[2], &mFloor[3],
+			&wallCp[0], &wallCp[1], &wallCp[2], &wallCp[3] };
+		for(double* output : leakOutputs)
+			leakStage.output(output);
+		for(int i = 0; i < numFans; i++)
+			leakStage.output(&fan[i].m);
+		for(int i = 0; i < numAtticFans; i++)
+			leakStage.output(&atticFan[i].m);
 
 		cout << endl;
 		cout << "Simulation: " << simNum << endl;
@@ -940,35 +1033,106 @@ int main(int argc, char *argv[], char* envp[])
 		cout << "Output File:\t " << outputFileName << endl;
 		cout << "Weather File:\t " << weatherFileName << endl;
 
-		
-		// =================================================================
-		// ||				 THE SIMULATION LOOPS START HERE:					   ||
-		// =================================================================
-		for(int year = 0; year <= warmupYears; year++) {
-			// ================== OPEN WEATHER FILE FOR INPUT ========================================
+		// Annual totals and counts added up every minute, for the methods that simulate some days for others
+		double* annualTotals[] = { &AH_kWh, &compressor_kWh, &mechVent_kWh, &gasTherm, &dehumidifier_kWh, &meanOutsideTemp, &meanAtticTemp,
+			&meanHouseTemp, &meanHouseACH, &meanFlueACH, &totalRelExp, &totalRelDose, &TotalDAventLoad, &TotalMAventLoad, &RHtot60, &RHtot70,
+			&HumidityIndex_Sum, &coolingLoad, &latLoad, &heatingLoad };
+		double annualKWh[] = { 1 / 60000.0, 1 / 60000.0, 1 / 60000.0, 60 / 1000000.0 / 105.5 * 29.3, 1 / 60000.0 };	// kWh per unit of the energy totals that come first
+		long int* annualCounts[] = { &occupiedMinCount, &rivecMinutes };
+		int numAnnualTotals = sizeof(annualTotals) / sizeof(annualTotals[0]);
+		int numAnnualCounts = sizeof(annualCounts) / sizeof(annualCounts[0]);
+
+		// Representative days stand in for the days of their clusters in the annual totals
+		RepresentativeDays repDays;
+		if(representativeDays > 0) {
 			try {
-				weatherFile.open(weatherFileName);
+				repDays.select(weatherFileName, terrain, eaveHeight, representativeDays, representativeWarmup);
 			}
 			catch(string fileName) {
 				cerr << "Could not open weather file: " << fileName << endl;
 				return 1;
 				}
-			cout << endl;
-			cout << "Year " << year << ": Weather file type=" << weatherFile.type << " ID=" << weatherFile.siteID << " TZ=" << weatherFile.timeZone;
-			cout << " lat=" << weatherFile.latitude << " long=" << weatherFile.longitude << " elev=" << weatherFile.elevation << endl;
-			weatherFile.latitude = M_PI * weatherFile.latitude / 180.0;					// convert to radians
+			for(int i = 0; i < numAnnualTotals; i++)
+				repDays.track(annualTotals[i], i < 5 ? annualKWh[i] : 0);
+			for(int i = 0; i < numAnnualCounts; i++)
+				repDays.track(annualCounts[i]);
+			cout << "Representative days:\t " << repDays.representedDays << " of " << repDays.simulatedDays << " simulated days" << endl;
+			}
 
-			// Fan Schedule Inputs =========================================================================================
-			// Read in fan schedule (lists of 1s and 0s, 1 = fan ON, 0 = fan OFF, for every minute of the year)
-			// Different schedule file depending on number of bathrooms
-			ifstream fanScheduleFile;
-			fanScheduleFile.open(fanScheduleFileName); 
-			if(!fanScheduleFile) { 
-				cerr << "Cannot open fan schedule: " << fanScheduleFileName << endl;
-				return 1; 		
+		// Parareal state: the slowly changing part of the simulation, corrected at the slice starts
+		vector<double> pararealState;
+		int heatNodes = (roofIntRval > 0) ? ATTIC_NODES : 16;		// the roof insulation nodes are only solved with interior insulation
+		auto packState = [&](vector<double>& state) {
+			state.assign(tempOld, tempOld + heatNodes);
+			for(int i = 0; i < numZones; i++) {
+				state.push_back(zone[i].tempOld);
+				state.push_back(zone[i].tempMassOld);
+				}
+			moisture_nodes.getState(state);
+			state.push_back(HRAttic * 1000);
+			state.push_back(HRReturn * 1000);
+			state.push_back(HRSupply * 1000);
+			state.push_back(HRHouse * 1000);
+			state.push_back(moldIndex_South);
+			state.push_back(moldIndex_North);
+			state.push_back(moldIndex_BulkFraming);
+			state.push_back(relExp);
+			state.push_back(relDose);
+			};
+		auto unpackState = [&](vector<double>& state) {
+			int k = 0;
+			for(int i = 0; i < heatNodes; i++)
+				b[i] = tempOld[i] = state[k++];
+			for(int i = 0; i < numZones; i++) {
+				zone[i].temp = zone[i].tempOld = state[k++];
+				zone[i].tempMass = zone[i].tempMassOld = state[k++];
+				}
+			k = moisture_nodes.setState(state, k);
+			HRAttic = max(state[k++] / 1000, 0.0);
+			HRReturn = max(state[k++] / 1000, 0.0);
+			HRSupply = max(state[k++] / 1000, 0.0);
+			HRHouse = max(state[k++] / 1000, 0.0);
+			moldIndex_South = state[k++];
+			moldIndex_North = state[k++];
+			moldIndex_BulkFraming = state[k++];
+			relExp = state[k++];
+			relDose = state[k++];
+			tempAttic = b[0];
+			tempReturn = b[11];
+			tempSupply = b[14];
+			tempHouse = b[15];
+			RHAttic = moisture_nodes.moistureContent[6];
+			RHHouse = moisture_nodes.moistureContent[9];
+			};
+
+		// Parareal: this process only drives the iterations, the sweeps and slices run the loops below in processes of their own
+		int simulationDays = 365 * (warmupYears + 1);
+		int recordStart = printAllYears ? 0 : 365 * warmupYears;
+		Parareal parareal(pararealSlices, pararealIterations, pararealTolerance, simulationDays, recordStart);
+		if(pararealSlices > 0) {
+			for(int i = 0; i < numAnnualTotals; i++)
+				parareal.track(annualTotals[i]);
+			for(int i = 0; i < numAnnualCounts; i++)
+				parareal.track(annualCounts[i]);
+			packState(pararealState);
+			if(parareal.run(pararealState.size()))
+				timeStep = TimeStep(pararealCoarseStep, PARAREAL_COARSE_TOLERANCE);
+			else if(parareal.failed) {
+				cerr << "Parareal sweep failed" << endl;
+				return 1;
+				}
 			}
 
-			if(year == warmupYears || printAllYears) {
+		
+		// Days of each year: the weather is read from a week before the first simulated day for the 7 day running average,
+		// the days before that are skipped in the weather and fan schedule files
+		int firstDay = (runStartDay > 0) ? max(1, runStartDay - runWarmupDays) : 1;
+		int weatherDay = max(1, firstDay - 7);
+		int lastDay = (runStartDay > 0) ? runEndDay : 365;
+
+		// Recording of the output files and annual totals starts with the last year, or the run period
+		auto startRecording = [&](bool lastYear) {
+			if((lastYear || printAllYears) && parareal.role == PR_SERIAL) {		// Parareal processes would write over each other
 				printMoistureFile = printMoistureFileCfg;
 				printFilterFile = printFilterFileCfg;
 				printOutputFile = printOutputFileCfg;
@@ -976,7 +1140,7 @@ int main(int argc, char *argv[], char* envp[])
 
 			if(!printAllYears) {	// Reset if only printing summary of final year
 				// counters
-				minuteTotal = 1;
+				stepTotal = 1;
 				occupiedMinCount = 0;
 				rivecMinutes = 0;
 				filterChanges = 0;
@@ -1000,16 +1164,101 @@ int main(int argc, char *argv[], char* envp[])
 				RHtot60 = 0;
 				RHtot70 = 0;
 				HumidityIndex_Sum = 0;
+				coolingLoad = 0;
+				latLoad = 0;
+				heatingLoad = 0;
+				peakCoolingLoad = 0;
+				peakLatentLoad = 0;
+				peakHeatingLoad = 0;
+				}
+			};
+
+		// =================================================================
+		// ||				 THE SIMULATION LOOPS START HERE:					   ||
+		// =================================================================
+		// The loops are compiled for the controllers of the building (Controls), withControls() picks them
+		auto simulate = [&](auto controls) -> int {
+		typedef decltype(controls) C;
+		for(int year = 0; year <= warmupYears; year++) {
+			if(parareal.role == PR_DRIVER)
+				break;
+
+			// ================== OPEN WEATHER FILE FOR INPUT ========================================
+			try {
+				weatherFile.open(weatherFileName);
+			}
+			catch(string fileName) {
+				cerr << "Could not open weather file: " << fileName << endl;
+				return 1;
+				}
+			cout << endl;
+			cout << "Year " << year << ": Weather file type=" << weatherFile.type << " ID=" << weatherFile.siteID << " TZ=" << weatherFile.timeZone;
+			cout << " lat=" << weatherFile.latitude << " long=" << weatherFile.longitude << " elev=" << weatherFile.elevation << endl;
+			weatherFile.latitude = M_PI * weatherFile.latitude / 180.0;					// convert to radians
+
+			// Fan Schedule Inputs =========================================================================================
+			// Read in fan schedule (lists of 1s and 0s, 1 = fan ON, 0 = fan OFF, for every minute of the year)
+			// Different schedule file depending on number of bathrooms
+			ifstream fanScheduleFile;
+			fanScheduleFile.open(fanScheduleFileName); 
+			if(!fanScheduleFile) { 
+				cerr << "Cannot open fan schedule: " << fanScheduleFileName << endl;
+				return 1; 		
+			}
+
+			// Weather and fan schedule rows are minute by minute, steps longer than a minute take the first minute of the step
+			auto readMinuteInputs = [&](int minute) {
+				cur_weather = weatherFile.readMinute(minute);
+				// Assumes operation of dryer and kitchen fans, then 1 - 3 bathroom fans
+				fanScheduleFile >> dryerFan >> kitchenFan >> bathOneFan >> bathTwoFan >> bathThreeFan;
+				for(int m = 1; m < STEP_SECONDS / 60; m++) {
+					int skipFan;
+					weatherFile.readMinute(minute + m);
+					for(int i = 0; i < 5; i++)
+						fanScheduleFile >> skipFan;
+					}
+				};
+
+			if(weatherDay > 1) {
+				weatherFile.skipHours(24 * (weatherDay - 1));
+				for(long i = 0; i < 1440L * (weatherDay - 1); i++) {
+					fanScheduleFile >> ws;
+					fanScheduleFile.ignore(numeric_limits<streamsize>::max(), '\n');
+					}
 				}
+
+			if(runStartDay == 0)
+				startRecording(year == warmupYears);
 				
-			for(int day = 1; day <= 365; day++) {
-				cout << "\rDay = " << day << flush;
+			for(int day = weatherDay; day <= lastDay; day++) {
+				if(parareal.role == PR_SERIAL)
+					cout << "\rDay = " << day << flush;
+				if(day == runStartDay)
+					startRecording(true);
+
+				// Parareal slices start and end at the start of a day
+				if(parareal.role != PR_SERIAL) {
+					streampos weatherPosition = weatherFile.position();
+					streampos fanSchedulePosition = fanScheduleFile.tellg();
+					packState(pararealState);
+					int boundary = parareal.boundary(365 * year + day - 1, pararealState);
+					if(boundary != PB_NONE)
+						unpackState(pararealState);
+					if(boundary == PB_FORKED) {
+						// a new fine process, with input files of its own
+						weatherFile.reopen(weatherFileName, weatherPosition);
+						fanScheduleFile.close();
+						fanScheduleFile.open(fanScheduleFileName);
+						fanScheduleFile.seekg(fanSchedulePosition);
+						timeStep = TimeStep(maxTimeStep, stepTolerance);
+						}
+					}
 
-				dailyAverageTemp = dailyCumulativeTemp / 1440;
+				dailyAverageTemp = dailyCumulativeTemp / STEPS_PER_DAY;
 				averageTemp.push_back (dailyAverageTemp); //provides the prior day's average temperature...need to do something for day one
 				dailyCumulativeTemp = 0;			// Resets daily average outdoor temperature to 0 at beginning of new day
 				// For 7 day moving average heating/cooling thermostat decision
-				if(day > 7) {
+				if(day > 7 && averageTemp.size() > 7) {
 					averageTemp.erase(averageTemp.begin());
 					runningAverageTemp = 0;
 					for(int i = 0; i < 7 ; i++) {
@@ -1056,9 +1305,37 @@ int main(int argc, char *argv[], char* envp[])
 				else if(day <= 334) month = 11;
 				else month = 12;
 
+				// days that are not simulated only keep the weather and fan schedules in step
+				if(!repDays.simulated(day) || day < firstDay) {
+					for(int hour = 0; hour < 24; hour++) {
+						for(int step = 0; step < STEPS_PER_HOUR; step++) {
+							if(step * STEP_SECONDS % 60 == 0)
+								readMinuteInputs(step * STEP_SECONDS / 60);
+							dailyCumulativeTemp = dailyCumulativeTemp + cur_weather.dryBulb - C_TO_K;
+							stepTotal++;
+							}
+						weatherFile.nextHour();
+						}
+					continue;
+					}
+				repDays.beginDay();
+
+				// in screening runs the full model trains the reduced order model every screeningInterval days
+				bool fullDayPrev = fullDay;
+				fullDay = screeningInterval <= 0 || !surrogate.fitted || (day - 1) % screeningInterval == 0;
+				if(!fullDay) {
+					surrogate.reducedDays++;
+					}
+				else if(!fullDayPrev) {
+					// air moisture resumes from the reduced order model, the wood nodes from the last full model day
+					moisture_nodes.setVaporPressure(6, HRAttic * cur_weather.pressure / (0.621945 + HRAttic));
+					for(int i = 7; i <= 9; i++)
+						moisture_nodes.setVaporPressure(i, HRHouse * cur_weather.pressure / (0.621945 + HRHouse));
+					}
+
 				// =================================== HOUR LOOP ================================	
 				for(int hour = 0; hour < 24; hour++) {
-					AHminutes = 0;					// Resetting air handler operation minutes for this hour
+					AHseconds = 0;					// Resetting air handler operation time for this hour
 					mFanCycler = 0;				// Fan cycler?
 					if(hcFlag == 1) {
 						setpoint = heatThermostat[hour];
@@ -1067,8 +1344,10 @@ int main(int argc, char *argv[], char* envp[])
 						setpoint = coolThermostat[hour];
 						}
 
-					// ============================== MINUTE LOOP ================================	
-					for(int minute = 0; minute < 60; minute++) {
+					// ============================== STEP LOOP ================================	
+					for(int step = 0; step < STEPS_PER_HOUR; step++) {
+						int second = step * STEP_SECONDS;		// time in the hour at the start of the step
+						int minute = second / 60;
 						double hourAngle;
 						double sinBeta;
 						double beta = 0;
@@ -1081,7 +1360,7 @@ int main(int argc, char *argv[], char* envp[])
 						double H2, H4, H6;
 						double airDensityOUT,airDensityIN,airDensityATTIC,airDensitySUP,airDensityRET;
 
-						target = minute - 39;			// Target is used for fan cycler operation currently set for 20 minutes operation, in the last 20 minutes of the hour.
+						target = second - 39 * 60;		// Target is used for fan cycler operation currently set for 20 minutes operation, in the last 20 minutes of the hour (seconds).
 						if(target < 0)
 							target = 0;						// For other time periods, replace the "40" with 60 - operating minutes
 
@@ -1119,9 +1398,7 @@ int main(int argc, char *argv[], char* envp[])
 									massFilter_cumulative = 0;
 									filterChanges++;
 								}
-							// Cooling capacity air flow correction term (in CFM)
-							qAH_cfm = qAH_cool / .0004719;
-							qAHcorr = 1.62 - .62 * qAH_cfm / (400 * capacityraw) + .647 * log(qAH_cfm / (400 * capacityraw));
+							compressor.setAirflow(qAH_cool);			// Cooling capacity air flow correction term
 						}
 						// [END] Filter loading calculations =================================================================
 
@@ -1139,16 +1416,13 @@ int main(int argc, char *argv[], char* envp[])
 						nonRivecVentSumIN = 0;				// Setting sum of non-RIVEC supply mechanical ventilation to zero
 						nonRivecVentSumOUT = 0;				// Setting sum of non-RIVEC exhaust mechanical ventilation to zero
 
-						cur_weather = weatherFile.readMinute(minute);
+						if(second % 60 == 0)
+							readMinuteInputs(minute);
 						dailyCumulativeTemp = dailyCumulativeTemp + cur_weather.dryBulb - C_TO_K;
 						tsolair = cur_weather.dryBulb;
 
 						for(int k=0; k < 4; k++)			// Wind direction as a compass direction?
-							Sw[k] = pow(Swinit[k][cur_weather.windDirection],2);		// store square of Sw to pass to attic_leak and house_leak
-
-						// Fan Schedule Inputs
-						// Assumes operation of dryer and kitchen fans, then 1 - 3 bathroom fans
-						fanScheduleFile >> dryerFan >> kitchenFan >> bathOneFan >> bathTwoFan >> bathThreeFan;
+							Sw[k] = SwSquared[k][cur_weather.windDirection];		// store square of Sw to pass to attic_leak and house_leak
 
 						// Calculate air densities
 						airDensityOUT = airDensityRef * airTempRef / cur_weather.dryBulb;		// Outside Air Density
@@ -1156,9 +1430,13 @@ int main(int argc, char *argv[], char* envp[])
 						airDensityATTIC = airDensityRef * airTempRef / tempAttic;	// Attic Air Density
 						airDensitySUP = airDensityRef * airTempRef / tempSupply;		// Supply Duct Air Density
 						airDensityRET = airDensityRef * airTempRef / tempReturn;		// Return Duct Air Density
+						fanState.hour = hour;
+						fanState.second = second;
+						fanState.airDensityIN = airDensityIN;
+						fanState.airDensityOUT = airDensityOUT;
 
 						// Solar calculations
-						hourAngle = 15 * (hour + minute / 60.0 + timeCorrection - 12) * M_PI / 180;
+						hourAngle = 15 * (hour + second / 3600.0 + timeCorrection - 12) * M_PI / 180;
 						sinBeta = cos(weatherFile.latitude) * cos(dec) * cos(hourAngle) + sin(weatherFile.latitude) * sin(dec);
 						if(sinBeta > 0) {			// sun is up
 							beta = asin(sinBeta);
@@ -1183,32 +1461,21 @@ int main(int argc, char *argv[], char* envp[])
 							tsolair = totalSolar / 4 * .03 + cur_weather.dryBulb;		// the .03 is from 1993 AHSRAE Fund. SI 26.5
 						}
 
+						// in ideal loads runs the heat balance holds the house at the setpoint and there is no equipment to switch, the
+						// air handler only runs for venting
+						if(idealLoads) {
+							qAH = (hcFlag == 1) ? qAH_heat : qAH_cool;
+							AHflag = 0;
+							heatModel.idealLoads(setpoint, hcFlag == 1);
+							}
 						// ====================== HEATING THERMOSTAT CALCULATIONS ============================
-						if(hcFlag == 1) {
+						else if(hcFlag == 1) {
 							qAH = qAH_heat;            // Heating Air Flow Rate [m3/s]
 
-							if(tempOld[15] > (setpoint + .5))
-								AHflag = 0;					// Heat off if building air temp above setpoint
-
-							if(AHflag == 0 || AHflag == 100) {
-								if(tempOld[15] <= (setpoint - .5))
-									set = 1;					// Air handler off, and tin below setpoint - 0.5 degrees
-								else
-									set = 0;					// Air handler off, but tin above setpoint - 0.5 degrees
-							}
-
-							if(tempOld[15] < (setpoint - .5))
-								AHflag = 1;					// turn on air handler/heat
-
-							if(tempOld[15] >= (setpoint - .5) && tempOld[15] <= (setpoint + .5)) {
-								if(set == 1)
-									AHflag = 1;
-								else
-									AHflag = 0;
-							}
+							AHflag = C::Thermostat::heating(tempOld[15], setpoint, AHflag, set);
 
 							if(AHflag == 0 && AHflag != AHflagPrev)
-								endrunon = minuteTotal + 1;		// Adding 1 minute runon during which heat from beginning of cycle is put into air stream
+								endrunon = stepTotal + max(1, 60 / STEP_SECONDS);		// Adding 1 minute runon during which heat from beginning of cycle is put into air stream
 
 							if(AHflag == 1)
 								hcap = hcapacity / AFUE;	// hcap is gas consumed so needs to divide output (hcapacity) by AFUE
@@ -1218,50 +1485,21 @@ int main(int argc, char *argv[], char* envp[])
 							qAH = qAH_cool;						// Cooling Air Flow Rate
 							endrunon = 0;
 
-							if(tempOld[15] < (setpoint - .5))
-								AHflag = 0;
-
-							if(AHflag == 0 || AHflag == 100) {
-								if(tempOld[15] >= (setpoint + .5))
-									set = 1;				// 1 = AH OFF and house temp below thermostat setpoint - 0.5
-								else
-									set = 0;				// 0 = AH OFF and house temp above thermostat setpoint - 0.5
-							}
-
-							if(tempOld[15] >= (setpoint + .5)) {
-								AHflag = 2;
-							}
-
-							if(tempOld[15] < (setpoint + .5) && tempOld[15] >= (setpoint - .5)) {
-								if(set == 1)
-									AHflag = 2;
-								else
-									AHflag = 0;
-							}
+							AHflag = C::Thermostat::cooling(tempOld[15], setpoint, AHflag, set);
 
-							if(AHflag != AHflagPrev && AHflag == 2) {				// First minute of operation
-								compTime = 1;
-								compTimeCount = 1;
-							} else if(AHflag == 2 && compTimeCount == 1) {			// Second minute of operation
-								compTime = 2;
-								compTimeCount = 0;
-							} else if(AHflag == 2 && compTimeCount == 0) {
-								compTime = 0;
+							if(AHflag != AHflagPrev && AHflag == 2) {				// First step of operation
+								compSeconds = STEP_SECONDS;
+							} else if(AHflag == 2 && compSeconds > 0) {
+								compSeconds += STEP_SECONDS;
 							} else if(AHflag != AHflagPrev && AHflag == 0) {		// End of cooling cycle
-								compTime = 0;
+								compSeconds = 0;
 							}
+							compTime = (compSeconds <= 120) ? compSeconds / 60.0 : 0;		// the start up ramps last two minutes
 
 							// [START] ====================== ECONOMIZER RATIONALE ===============================
-							econodt = tempHouse - cur_weather.dryBulb;			// 3.333K = 6F
-
-							// No cooling, 6F dt (internal/external) and tempHouse > 21C for economizer operation. 294.15 = 21C
-								//if(AHflag == 0 && econodt >= 3.333 && tempHouse > 294.15 && economizerUsed == 1) {
-							if(AHflag == 0 && econodt >= 3.33 && tempHouse > 294.15 && economizerUsed == 1 && hcFlag == 2) {
-									econoFlag = 1;
-									envC = Ceconomizer;
-								} else {
-									econoFlag = 0;
-								}
+							econoFlag = (economizerUsed == 1) ? C::Economizer::run(AHflag, hcFlag, tempHouse, cur_weather.dryBulb) : 0;
+							if(econoFlag == 1)
+								envC = Ceconomizer;
 						}	// [END] ========================== END ECONOMIZER ====================================
 
 
@@ -1301,7 +1539,7 @@ int main(int argc, char *argv[], char* envp[])
 						}
 	*/
 
-						if(minute == 0 || minute == 10 || minute == 20 || minute == 30 || minute == 40 || minute == 50) {
+						if(second % 600 == 0) {
 	// 						for(int i=0; i < numFans; i++) {
 	// 							// [START] ---------------------FAN 50---------- RIVEC OPERATION BASED ON CONTROL ALGORITHM v6
 	// 							// v6 of the algorithm only uses the peakStart and peakEnd variables, no more base or recovery periods.(
@@ -1325,40 +1563,16 @@ int main(int argc, char *argv[], char* envp[])
 	// 								//}
 	// 							}
 	// 						//}
-							if(OccContType == 2){ //Aux fan control only.
-								if(relExp >= 1.0 || relDose > 1.0){
-									rivecOn = 1;
-								} else {
-									rivecOn = 0;
-								}
-							}
-					
-							else if(OccContType == 3 || OccContType == 4) { //Occupancy control only (3) or Aux Fans + Occupancy control (4). Aux fans are accounted for with the AuxFanIndex variable. 
-								if(occupied[weekend][hour] == 1) { //occupied
-									if(relExp >= 1.0 || relDose > 1.0) {
-										rivecOn = 1;
-									} else {
-										rivecOn = 0;
-									}
-								
-								} else{ //unoccupied
-									if(relExp > expLimit) { //expLimit defaults to 5, based on ASHRAE 62.2-2016 Addendum C. 
-										rivecOn = 1;
-									} else{
-										rivecOn = 0;
-									}
-								}
-							}				
+							// occupancy or humidity control of the building
+							ControlInputs controlIn = { hour, month, occupied[weekend][hour], hcFlag, AHflag, rivecOn, relExp, relDose,
+								cur_weather.humidityRatio, HRHouse, RHHouse };
+							rivecOn = C::Ventilation::decide(controlSettings, controlIn);
 						}
 							// [END] ========================== END RIVEC Decision ====================================
 
-						// ==========================  Humidity Control Logic ================================
-						// following function is in humidity_control.cpp, but has NOT been compiled or tested
-						// rivecOn = humidity_control(cur_weather.humidityRatio, HRHouse, RHhouse, relExp, relDose, hour, month, AHflag, occupied)
-
 						AHflagPrev = AHflag;
 						if(AHflag != 0)
-							AHminutes++;			// counting number of air handler operation minutes in the hour
+							AHseconds += STEP_SECONDS;			// counting air handler operation time in the hour
 
 						// the following air flows depend on if we are heating or cooling
 						supVelAH = qAH / (pow(supDiameter,2) * M_PI / 4);
@@ -1377,7 +1591,7 @@ int main(int argc, char *argv[], char* envp[])
 
 						if(AHflag == 0) {			// AH OFF
 							// the 0 at the end of these terms means that the AH is off
-							if(minuteTotal >= endrunon) {  // endrunon is the end of the heating cycle + 1 minutes
+							if(stepTotal >= endrunon) {  // endrunon is the end of the heating cycle + 1 minutes
 								mSupReg = 0;
 								mAH = 0;
 								mRetLeak = 0;
@@ -1401,40 +1615,7 @@ int main(int argc, char *argv[], char* envp[])
 								AHfanPower = fanPower_heating;
 								hcap = hcapacity / AFUE;
 
-								for(int i = 0; i < numFans; i++) {     // For outside air into return cycle operation
-									if(fan[i].oper == 6 && AHminutes <= 20) {
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 10) {			// vent always open during any air handler operation
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 14) {			// vent always open during any air handler operation
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 18) {			// vent always open during any air handler operation
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 15 && AHminutes <= 20) {
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 13) {
-										if((rivecFlag == 0 && AHminutes <= 20) || (rivecFlag == 1 && rivecOn == 1)){ //This allows RIVEC to operate this fan until it reaches its Exposure setpoint?
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-										ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-										//nonRivecVentSumIN = nonRivecVentSumIN + abs(fan[i].q) * 3600 / houseVolume;
-										}
-									}
-									if(fan[i].oper == 22 && AHminutes <= 20 && econoFlag == 0) {
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-								}
+								fanTable.runIntake(fanState, false);		// For outside air into return cycle operation
 							}
 						} else {
 							if(AHflag == 2) {	//	cooling 
@@ -1448,40 +1629,7 @@ int main(int argc, char *argv[], char* envp[])
 								retVel = retVelAH;
 								AHfanHeat = fanPower_cooling * 0.85;	//0.85		// Cooling fan power multiplied by an efficiency (15% efficient fan)
 								AHfanPower = fanPower_cooling;
-								for(int i = 0; i < numFans; i++) {			// for outside air into return cycle operation
-									if(fan[i].oper == 6 && AHminutes <= 20) {
-										mFanCycler = fan[i].q * airDensityIN * qAH_cool / qAH_heat;	// correcting this return intake flow so it remains a constant fraction of air handler flow
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 10) {				// vent always open during any air handler operation
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 14) {				// vent always open during any air handler operation
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 18) {				// vent always open during any air handler operation
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 15 && AHminutes <= 20) {
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 13) {
-										if((rivecFlag == 0 && AHminutes <= 20) || (rivecFlag == 1 && rivecOn == 1)){ //This allows RIVEC to operate this fan until it reaches its Exposure setpoint?
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;								
-										ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-										//nonRivecVentSumIN = nonRivecVentSumIN + abs(fan[i].q) * 3600 / houseVolume;
-										}
-									}
-									if(fan[i].oper == 22 && AHminutes <= 20 && econoFlag == 0) {
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-								}
+								fanTable.runIntake(fanState, true);			// for outside air into return cycle operation
 							} else {
 								mAH = mAH1;
 								mRetLeak = mRetLeak1;
@@ -1494,400 +1642,12 @@ int main(int argc, char *argv[], char* envp[])
 								AHfanPower = fanPower_heating;
 								hcap = hcapacity / AFUE;
 
-								for(int i = 0; i < numFans; i++) {			// for outside air into return cycle operation
-									if(fan[i].oper == 6 && AHminutes <= 20) {
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 10) {				// vent always open during any air handler operation
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 14) {				// vent always open during any air handler operation
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 18) {				// vent always open during any air handler operation
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 15 && AHminutes <= 20) {
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-									if(fan[i].oper == 13) { 
-										if((rivecFlag == 0 && AHminutes <= 20) || (rivecFlag == 1 && rivecOn == 1)){ //This allow RIVEC to operate this fan until it reaches its Exposure setpoint?
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;								
-										ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-										//nonRivecVentSumIN = nonRivecVentSumIN + abs(fan[i].q) * 3600 / houseVolume;
-										}
-									}
-									if(fan[i].oper == 22 && AHminutes <= 20 && econoFlag == 0) {
-										mFanCycler = fan[i].q * airDensityIN;
-										mRetReg = mRetReg1 - mFanCycler;
-									}
-								}
+								fanTable.runIntake(fanState, false);			// for outside air into return cycle operation
 							}
 						}
 
-						for(int i=0; i < numFans; i++) {
-							// ***********************  20 minute minimum central fan integrated supply (CFIS) system. 20 minute minimum operation per hour. 
-							if(fan[i].oper == 13) {			// fan cycler operation without exhaust fan
-								if((rivecFlag == 0 && AHminutes < target && AHflag != 1 && AHflag != 2 && AHflag != 102) || (rivecFlag == 1 && rivecOn == 1 && AHflag != 1 && AHflag != 2 && AHflag != 102)){		// conditions for turning on air handler only for fan cycler operation
-									AHflag = 100;
-									AHminutes = AHminutes + 1;
-									qAH = qAH_cool;
-									supVelAH = qAH / (pow(supDiameter,2) * M_PI / 4);
-									retVelAH = qAH / (pow(retDiameter,2) * M_PI / 4);
-									qSupReg = -qAH * supLF + qAH;
-									qRetReg = qAH * retLF - qAH;
-									qRetLeak = -qAH * retLF;
-									qSupLeak = qAH * supLF;
-									mSupLeak = qSupLeak * airDensityIN;
-									mRetLeak = qRetLeak * airDensityIN;
-									mFanCycler = fan[i].q * airDensityIN;
-									mSupReg = qSupReg * airDensityIN;
-									mRetReg = qRetReg * airDensityIN - mFanCycler;							
-									mAH = qAH * airDensityIN;
-									mechVentPower = mechVentPower + fanPower_cooling;			// note ah operates at cooling speed
-									AHfanHeat = fanPower_cooling * .85;							// for heat
-									ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-									//nonRivecVentSumIN = nonRivecVentSumIN + abs(fan[i].q) * 3600 / houseVolume;
-								}
-							}
-						//}
-
-							if(fan[i].oper == 22) {						// Fan cycler operation only when economizer is off
-								if(econoFlag == 0) {					// Only open CFI if economizer is off
-									if(AHminutes < target && AHflag != 1 && AHflag != 2 && AHflag != 102) {		// conditions for turning on air handler only for fan cycler operation
-										AHflag = 100;
-										AHminutes = AHminutes + 1;
-										qAH = qAH_cool;
-										supVelAH = qAH / (pow(supDiameter,2) * M_PI / 4);
-										retVelAH = qAH / (pow(retDiameter,2) * M_PI / 4);
-										qSupReg = -qAH * supLF + qAH;
-										qRetReg = qAH * retLF - qAH;
-										qRetLeak = -qAH * retLF;
-										qSupLeak = qAH * supLF;
-										mSupLeak = qSupLeak * airDensityIN;
-										mRetLeak = qRetLeak * airDensityIN;
-										mFanCycler = fan[i].q * airDensityIN;
-										mSupReg = qSupReg * airDensityIN;
-										mRetReg = qRetReg * airDensityIN - mFanCycler;
-										mAH = qAH * airDensityIN;
-										mechVentPower = mechVentPower + fanPower_cooling;    // note ah operates at cooling speed
-										AHfanHeat = fanPower_cooling * .85;  // for heat
-										ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-										//nonRivecVentSumIN = nonRivecVentSumIN + abs(fan[i].q) * 3600 / houseVolume;
-									}
-								}
-							}
-						//}
-
-
-						// [START] HRV's and ERV's===================================================================================================================================
-						// (Can be RIVEC controlled so after RIVEC algorithm decision)
-						//for(int i=0; i < numFans; i++) {
-							//Brennan. Stand-alone ERV MUST be entered two times in the input files, with half the fan power attributed to each. Same airflow, but one positive and one negative.
-
-							if(fan[i].oper == 5) {		// Standalone HRV not synched to air handler
-
-								if((rivecFlag == 0 && minute >= 30) || (rivecFlag == 1 && rivecOn == 1)) {	// on for last 30 minutes of every hour or RIVEC controlled
-									fan[i].on = 1;
-									mechVentPower = mechVentPower + fan[i].power;
-									if(fan[i].q > 0) {
-										mHRV = fan[i].q * airDensityOUT;;
-										ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-										//nonRivecVentSumIN = nonRivecVentSumIN + abs(fan[i].q) * 3600 / houseVolume;	// use if HRV not to be included in RIVEC whole house ventilation calculations
-									} else {
-										ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-										//nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									}
-								} else {
-									fan[i].on = 0;
-								}
-							}
-
-							if(fan[i].oper == 16) {		// HRV + Air Handler
-
-								if((rivecFlag == 0 && minute >= 30) || (rivecFlag == 1 && rivecOn == 1)) {	// on for last 30 minutes of every hour or RIVEC controlled
-									fan[i].on = 1;
-									ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-									ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-
-									mechVentPower = mechVentPower + fan[i].power;
-									if(AHflag != 1 && AHflag != 2 && AHflag != 102) {			// ah is off for heat/cool so turn it on for venting
-										AHflag = 100;
-										AHminutes = AHminutes + 1;
-										qAH = qAH_cool;
-										supVelAH = qAH / (pow(supDiameter,2) * M_PI / 4);
-										retVelAH = qAH / (pow(retDiameter,2) * M_PI / 4);
-										qSupReg = -qAH * supLF + qAH;
-										qRetReg = qAH * retLF - qAH;
-										qRetLeak = -qAH * retLF;
-										qSupLeak = qAH * supLF;
-										mSupLeak = qSupLeak * airDensityIN;
-										mAH = qAH * airDensityIN;
-										mHRV_AH = abs(fan[i].q * airDensityIN) * -1.0;			// mHRV_AH needs to be a negative number - so does fan(i).q to get right mRetReg and then fan(i).q is also the exhaust from house flow
-										mSupReg = qSupReg * airDensityIN;
-										mRetReg = qRetReg * airDensityIN - mHRV_AH;
-										mechVentPower = mechVentPower + fanPower_cooling;		// note AH operates at cooling speed
-										AHfanHeat = fanPower_cooling * .85;						// for heat
-									} else {													// open the outside air vent
-										mHRV_AH = fan[i].q * airDensityIN;
-										mRetReg = qRetReg * airDensityIN - mHRV_AH;
-									}
-								} else {
-									fan[i].on = 0;
-									mHRV_AH = 0;
-								}
-							}
-
-							//From the HVI directory (as of 5/2015) of all ERV units, average SRE=0.63, LR/MT=0.51, TRE=0.52, cfm/w=1.1
-
-							// ERV + Air Handler Copied over from ARTI code
-							if(fan[i].oper == 17) {												
-					
-								if((rivecFlag == 0 && minute >= 40) || (rivecFlag == 1 && rivecOn == 1)) {	// on for last 20 minutes of every hour or RIVEC controlled
-									fan[i].on = 1;
-									ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-									ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									mechVentPower = mechVentPower + fan[i].power;
-									if(AHflag != 1 && AHflag != 2 && AHflag != 102) {			// AH is off for heat/cool so turn it on for venting
-										AHflag = 100;
-										AHminutes = AHminutes + 1;
-										qAH = qAH_cool;
-										supVelAH = qAH / (pow(supDiameter,2) * M_PI / 4);
-										retVelAH = qAH / (pow(retDiameter,2) * M_PI / 4);
-										qSupReg = -qAH * supLF + qAH;
-										qRetReg = qAH * retLF - qAH;
-										qRetLeak = -qAH * retLF;
-										qSupLeak = qAH * supLF;
-										mSupLeak = qSupLeak * airDensityIN;
-										mRetLeak = qRetLeak * airDensityIN;
-										mAH = qAH * airDensityIN;
-										mERV_AH = abs(fan[i].q * airDensityIN) * -1.0;
-										mSupReg = qSupReg * airDensityIN;
-										mRetReg = qRetReg * airDensityIN - mERV_AH;
-										mechVentPower = mechVentPower + fanPower_cooling;		// note ah operates at cooling speed
-										AHfanHeat = fanPower_cooling * .85;						// for heat
-									} else {													// open the outside air vent
-										mERV_AH = fan[i].q * airDensityIN;						// mass flow of ERV unit synced to Air Handler
-										mRetReg = qRetReg * airDensityIN - mERV_AH;
-									}
-								} else {
-									fan[i].on = 0;
-									mERV_AH = 0;
-								}
-							}
-						//}
-						// [END] HRV's and ERV's =================================================================================================================================
-
-
-						// [START] Auxiliary Fan Controls ============================================================================================================
-						//for(int i = 0; i < numFans; i++) {
-
-							if(fan[i].oper == 1 && OccContType > 1) {		// RIVEC controlled exhaust fan.
-								if(rivecOn == 1){
-									fan[i].on = 1;
-									//fan[i].q = FanQ;
-									//fan[i].on = 0;	// Use this to disable the whole-house exhaust fan
-									mechVentPower = mechVentPower + fan[i].power;				// vent fan power
-									if(fan[i].q > 0) {							// supply fan - its heat needs to be added to the internal gains of the house
-										fanHeat = fan[i].power * .84;			// 16% efficiency for the particular fan used in this study.
-										ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-									}
-									else											// exhasut fan
-										ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;	
-								} else{
-									fan[i].on = 0;
-									//fan[i].q = 0;
-								}	
-						
-							} else if(fan[i].oper == 1 && OccContType <= 1){ //Continuous exhaust fan simulations.
-								fan[i].on = 1;
-								//fan[i].q = FanQ;
-								mechVentPower = mechVentPower + fan[i].power;
-								if(fan[i].q > 0) {							// supply fan - its heat needs to be added to the internal gains of the house
-									fanHeat = fan[i].power * .84;			// 16% efficiency for the particular fan used in this study.
-									ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-								}
-								else											// exhasut fan
-									ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;		
-						
-							} else if(fan[i].oper == 2) {					// FIXED SCHEDULE BATHROOM
-								if(hour == 7 && minute >= 30) {
-									fan[i].on = 1;
-									mechVentPower = mechVentPower + fan[i].power;
-									//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-								} else
-									fan[i].on = 0;
-
-							} else if(fan[i].oper == 3) {					// FIXED SCHEDULE KITCHEN
-								if(hour > 17 && hour <= 18) {
-									fan[i].on = 1;
-									mechVentPower = mechVentPower + fan[i].power;			// vent fan power
-									//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-								} else
-									fan[i].on = 0;
-
-							} else if(fan[i].oper == 4) {					// FIXED SCHEDULE EXHAUST FAN
-								if(hcFlag == 1) {  // if heating
-									if(hour > 1 && hour <= 5)
-										fan[i].on = 0;
-									else {
-										fan[i].on = 1;
-										mechVentPower = mechVentPower + fan[i].power;		// vent fan power
-										//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-										nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									}
-								}
-								if(hcFlag == 2) {  // if cooling
-									if(hour > 15 && hour <= 19) {
-										fan[i].on = 0;
-									} else {
-										fan[i].on = 1;
-										mechVentPower = mechVentPower + fan[i].power;		// vent fan power
-										//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-										nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									}
-								}
-
-							} else if(fan[i].oper == 19) {					// DRYER FAN
-								if(weekend == 1) {						// Three hours of operation, two days per week
-									if(hour > 12 && hour <= 15) {
-										fan[i].on = 1;
-										mechVentPower = mechVentPower + fan[i].power;
-										//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-										nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									} else
-										fan[i].on = 0;
-								} else
-									fan[i].on = 0;
-
-							} else if(fan[i].oper == 21) {					// Economizer
-								if(econoFlag == 1) {
-									fan[i].on = 1;
-									AHfanPower = AHfanPower + fan[i].power;			// vent fan power
-									//ventSumIN = ventSumIN + abs(fan[i].q) * 3600 / houseVolume;
-									nonRivecVentSumIN = nonRivecVentSumIN + abs(fan[i].q) * 3600 / houseVolume;
-								} else
-									fan[i].on = 0;
-
-							} else if(fan[i].oper == 23) {					// DYNAMIC SCHEDULE DRYER
-								if(dryerFan == 1) {
-									fan[i].on = 1;
-									mechVentPower = mechVentPower + fan[i].power;
-									//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-								} else
-									fan[i].on = 0;
-
-							} else if(fan[i].oper == 24) {					// DYNAMIC SCHEDULE KITCHEN FAN
-								if(kitchenFan == 1) {
-									fan[i].on = 1;
-									mechVentPower = mechVentPower + fan[i].power;
-									//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-								} else
-									fan[i].on = 0;
-
-							} else if(fan[i].oper == 25) {					// DYNAMIC SCHEDULE BATHROOM 1
-								if(bathOneFan == 1) {
-									fan[i].on = 1;
-									mechVentPower = mechVentPower + fan[i].power;
-									//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-								} else
-									fan[i].on = 0;
-
-							} else if(fan[i].oper == 26) {					// DYNAMIC SCHEDULE BATHROOM 2
-								if(bathTwoFan == 1) {
-									fan[i].on = 1;
-									mechVentPower = mechVentPower + fan[i].power;
-									//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-								} else
-									fan[i].on = 0;
-
-							} else if(fan[i].oper == 27) {					// DYNAMIC SCHEDULE BATHROOM 3. Brennan, we can redirect this fan.oper=27 to look at the bathOneFan value to increaes usage for 6 occupants.
-								if(bathThreeFan == 1) {
-								//if(bathOneFan == 1) {
-									fan[i].on = 1;
-									mechVentPower = mechVentPower + fan[i].power;
-									//ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-									nonRivecVentSumOUT = nonRivecVentSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-								} else
-									fan[i].on = 0;
-							
-								
-	//sum the non-Rivec ventilation airflows (prior section) and set nonRivecVentSum to the largest of inflow/outflow.								
-								
-							//} else if(fan[i].oper == 30) {// Continuous, Infiltration-Balanced Ventilation Temperature Controller ("Gold Standard"). Brennan.
-							//	if(numStories == 1){
-							//		AIM2 = pow(abs((tempHouse - 273.15) - weatherTemp) , 0.67) * 0.069 * C; //estimated stack infiltration (m3/s). Alwasy positive.
-							//		AEQaim2FlowDiff = (Aeq * houseVolume / 3600) - AIM2; //difference between 62.2-2013 AEQ flow rate (m3/s) and the estimated infiltration. Sometimes negative.
-							//		qFanFlowRatio = AEQaim2FlowDiff / (Aeq * houseVolume / 3600); //dimensionless ratio of flows. Sometimes negative.
-							//			if(AIM2 < (Aeq * houseVolume / 3600)){ //tests if infiltration exceeds Aeq
-							//				fan[i].on = 1;
-							//				fan[i].q = FanQ * qFanFlowRatio; //adjusts fan flow based on ratio of AIM2 / Aeq
-							//				fan[i].power = FanP * qFanFlowRatio; //adjusts fan power based on ratio of AIM2 / Aeq
-							//				mechVentPower = mechVentPower + fan[i].power ;
-							//				ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume ;  
-							//			} else
-							//				fan[i].on = 0;
-							//	} else 
-							//		if(numStories == 2){
-							//			AIM2 = pow(abs((tempHouse - 273.15) - weatherTemp) , 0.67) * 0.089 * C;
-							//			AEQaim2FlowDiff = (Aeq * houseVolume / 3600) - AIM2;
-							//			qFanFlowRatio = AEQaim2FlowDiff / (Aeq * houseVolume / 3600);
-							//				if(AIM2 < (Aeq * houseVolume / 3600)){
-							//					fan[i].on = 1;
-							//					fan[i].q = FanQ * qFanFlowRatio;
-							//					fan[i].power = FanP * qFanFlowRatio;
-							//					mechVentPower = mechVentPower + fan[i].power ;
-							//					ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume ; 
-							//				} else 
-							//					fan[i].on = 0;
-							//	} 
-
-
-							//} else if(fan[i].oper == 31) {// Continuous, Infiltration-Balanced Ventilation Temperature Controller ("Gold Standard"). Brennan. Quadrature!
-							//	if(numStories == 1){
-							//		AIM2 = 0.069 * envC * pow(abs((tempHouse - 273.15) - weatherTemp), n); //estimated stack infiltration (m3/s).
-							//		AEQaim2FlowDiff = pow((Aeq * houseVolume / 3600),2) - pow(AIM2,2); //difference between squares of 62.2-2013 AEQ flow rate (m3/s) and the estimated infiltration. Tells us if AIM2 inf > Aeq
-							//		if(AEQaim2FlowDiff > 0){ 
-							//			fan[i].on = 1;
-							//			qFanFlowRatio = sqrt(AEQaim2FlowDiff) / (Aeq * houseVolume / 3600); //sqrt of the squared differences solves for the required fan flow, this is the ratio of the req fan flow to the Aeq
-							//			fan[i].q = FanQ * qFanFlowRatio;
-							//			fan[i].power = FanP * qFanFlowRatio;
-							//			mechVentPower = mechVentPower + fan[i].power ;
-							//			ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-							//		} else
-							//			fan[i].on = 0;
-							//	} else 
-							//			if(numStories == 2){
-							//			AIM2 = 0.089 * envC * pow(abs((tempHouse - 273.15) - weatherTemp), n); 
-							//			AEQaim2FlowDiff = pow((Aeq * houseVolume / 3600),2) - pow(AIM2,2); 
-							//				if(AEQaim2FlowDiff > 0){
-							//					fan[i].on = 1;
-							//					qFanFlowRatio = sqrt(AEQaim2FlowDiff) / (Aeq * houseVolume / 3600); //
-							//					fan[i].q = FanQ * qFanFlowRatio;
-							//					fan[i].power = FanP * qFanFlowRatio;
-							//					mechVentPower = mechVentPower + fan[i].power ;
-							//					ventSumOUT = ventSumOUT + abs(fan[i].q) * 3600 / houseVolume;
-							//				} else
-							//					fan[i].on = 0;
-								
-
-
-								} 
-							
-						
-							}
+						// fans with their own controls: CFIS, HRV's and ERV's (can be RIVEC controlled so after the RIVEC algorithm decision) and auxiliary fans
+						fanTable.runControls(fanState);
 
 							// Moved this out of the fan loop above
 							if(nonRivecVentSumIN > nonRivecVentSumOUT){						//ventSum based on largest of inflow or outflow
@@ -2264,9 +2024,6 @@ int main(int argc, char *argv[], char* envp[])
 						// [END] Hybrid Systems ==================================================================================================================================
 
 						// [START] Equipment Model ===============================================================================================================================
-						evapcap = 0;
-						latcap = 0;
-						capacity = 0;
 						capacityh = 0;
 						compressorPower = 0;
 					
@@ -2285,205 +2042,285 @@ int main(int argc, char *argv[], char* envp[])
 							capacityh = hcapacity + AHfanHeat;					// include fan heat in furnace capacity (converted to W in main program)
 							capacityc = 0;
 						} else {												// we have cooling
-							double Toutf = KtoF(cur_weather.dryBulb);
-
-							// the following corrections are for TXV only
-							// test for wet/dry coil using SHR calculation
-							SHR = 1 - 50 * (HRReturn - .005);										// using humidity ratio - note only because we have small indoor dry bulb range
-
-							if(SHR < .25)
-								SHR = .25;  //setting low limit
-							if(SHR > 1)
-								SHR = 1;
-							if(SHR == 1) { // dry coil
-								// charge correction for capacity (dry coil)
-								if(charge < .725) {
-									chargecapd = 1.2 + (charge - 1);
-								} else if(charge >= .725) {
-									chargecapd = .925;
-								}
-								// charge correction for EER (dry coil)
-								if(charge < 1) {
-									chargeeerd = 1.04 + (charge - 1) * .65;
-								} else if(charge >= 1) {
-									chargeeerd = 1.04 - (charge - 1) * .35;
-								}
-								capacity = (capacityari * 1000) * .91 * qAHcorr * chargecapd * ((-.00007) * pow((Toutf - 82),2) - .0067 * (Toutf - 82) + 1);
-								// EER for dry coil
-								EER = EERari * qAHcorr * chargeeerd * ((-.00007) * pow((Toutf - 82),2) - .0085 * (Toutf - 82) + 1);
-							} else {															// wet coil
-								// charge correction for capacity (wet coil)
-								if(charge < .85) {
-									chargecapw = 1 + (charge - .85);
-								} else if(charge >= .85) {
-									chargecapw = 1;
-								}
-								// charge correction for EER (wet coil)
-								if(charge < .85) {
-									chargeeerw = 1 + (charge - .85) * .9;
-								} else if(charge >= .85 && charge <= 1) {
-									chargeeerw = 1;
-								} else if(charge > 1) {
-									chargeeerw = 1 - (charge - 1) * .35;
-								}
-								double hret = .24 * ((tempReturn - 273.15) * 9 / 5 + 32) + HRReturn * (1061 + .444 * ((tempReturn - 273.15) * 9 / 5 + 32));   // return air enthalpy
-								hret += AHfanHeat / mAH / 2326.;										// add fan heat, converted to Btu/lb
-								capacity = capacityari * 1000 * (1 + (hret - 30) * .025) * qAHcorr * chargecapw * ((-.00007) * pow((Toutf - 95),2) - .0067 * (Toutf - 95) + 1);
-								// EER for wet coil
-								EER = EERari * qAHcorr * chargeeerw * ((-.00007) * pow((Toutf - 95),2) - .0085 * (Toutf - 95) + 1);
-							}
-
-							// split sensible and latent capacities and convert capacity Btu/h to W
-							// calculation of power used and total cacapity for air conditioning
-							compressorPower = capacity / EER; //compressor power
-
-							// SHR ramps up for first three minutes of operation
-							// compTime tracks the number of minutes the compressor is on for
-							if(compTime == 1) {
-								SHR = SHR + 2.0 / 3.0 * (1 - SHR);
-							} else if(compTime == 2) {
-								SHR = SHR + 1.0 / 3.0 * (1 - SHR);
-							}
-						
-							// Reduce capacity over cCapAdjustTime minutes (to reduce sensible spike)
-							if(compTime > 0 && compTime < cCapAdjustTime) {
-								capacity *= (compTime / cCapAdjustTime);
-								}
-
-							capacityc = SHR * capacity / 3.413;									// sensible (equals total if SHR=1)
-							// correct the sensible cooling for fan power heating
-							capacityc = capacityc - AHfanHeat;
-							// tracking mass on coil (Mcoil) including condensation and evaporation - do this in main program
-							evapcap = 0;
-							latcap = 0;
-						}
-
-						// Tracking Coil Moisture
-						if(AHflag == 2) {
-							if(SHR < 1) {
-								latcap = (1 - SHR) * capacity / 3.413;							// latent capacity J/s
-								Mcoil = Mcoilprevious + latcap / 2501000 * dtau;				// condenstion in timestep kg/s * time
-							} else {
-								if(Mcoil > 0) {													// if moisture on coil but no latcap, then we evaporate coil moisture until Mcoil = zero
-									latcap = -.3 * capacityraw / 1800 * 2501000;				// evaporation capacity J/s - this is negative latent capacity
-									evapcap = latcap;
-									Mcoil = Mcoilprevious - .3 * capacityraw / 1800 * dtau;		// evaporation in timestep kg/s * time
-								} else {														// no latcap and dry coil
-									latcap = 0;
-								}
-							}
-						} else if(AHflag == 100) {												// then we have no cooling, but the fan is on
-							if(Mcoil > 0) {														// if moisture on coil but no latcap, then we evaporate coil moisture until Mcoil = zero
-								latcap = -.3 * capacityraw / 1800 * 2501000;					// evaporation capacity J/s - this is negative latent capacity
-								evapcap = latcap;
-								Mcoil = Mcoilprevious - .3 * capacityraw / 1800 * dtau;			// evaporation in timestep kg/s * time
-							} else {															// no latcap and dry coil
-								latcap = 0;
-							}
+							compressorPower = compressor.run(HRReturn, tempReturn, cur_weather.dryBulb, AHfanHeat, mAH, compTime);
+							capacityc = compressor.capacitySensible;				// sensible net of the fan heat
 						}
-
-						if(Mcoil < 0)
-							Mcoil = 0;
-						if(Mcoil > .3 * capacityraw)
-							Mcoil = .3 * capacityraw;											// maximum mass on coil is 0.3 kg per ton of cooling
-						Mcoilprevious = Mcoil;													// maybe put this at top of the hour
+						if(AHflag != 2)
+							compressor.idle(AHflag == 100);						// the coil dries while the fan runs without cooling
+						latcap = compressor.capacityLatent;
+						evapcap = compressor.evaporation;
 
 						if(dhCapacity > 0) {
-							dh.run(RHHouse, tempHouse);	// run dehumidifier using house air node conditions
+							dh.run<typename C::Humidistat>(RHHouse, tempHouse);	// run dehumidifier using house air node conditions
 							}
 					
 						// [END] Equipment Model ======================================================================================================================================
 
 						// [START] Heat and Mass Transport ==============================================================================================================================
-						double mCeilingOld = -1000;														// set so first iteration is forced
-						double PatticintOld = 0;
-						double mCeilingLimit = 0.0001;   //= max(envC / 10, 0.00001);
+						// reduced order model inputs and state at the start of the minute
+						if(screeningInterval > 0) {
+							screenInput[RI_TOUT] = cur_weather.dryBulb;
+							screenInput[RI_HROUT] = cur_weather.humidityRatio;
+							screenInput[RI_WIND] = cur_weather.windSpeedLocal;
+							screenInput[RI_ROOFSOLAR] = ssolrad + nsolrad;
+							screenInput[RI_SOLGAIN] = solgain;
+							screenInput[RI_SENSIBLE] = capacityh - capacityc + evapcap;
+							screenInput[RI_LATENT] = latcap;
+							screenInput[RI_GAINS] = internalGains1 + fanHeat + dh.sensible;
+							screenInput[RI_FANIN] = 0;
+							screenInput[RI_FANOUT] = 0;
+							for(int i = 0; i < numFans; i++) {
+								if(fan[i].q > 0)
+									screenInput[RI_FANIN] += fan[i].on * fan[i].q;
+								else
+									screenInput[RI_FANOUT] -= fan[i].on * fan[i].q;
+								}
+							screenInput[RI_AH] = mAH;
+							screenStart[RS_ATTIC] = tempAttic;
+							screenStart[RS_HOUSE] = tempHouse;
+							screenStart[RS_MASS] = tempOld[12];
+							screenStart[RS_HRATTIC] = HRAttic;
+							screenStart[RS_HRHOUSE] = HRHouse;
+							}
+
+						// discrete inputs that end the current step when they change
+						stepEvents.assign(1, AHflag);
+						stepEvents.push_back(envC);
+						stepEvents.push_back(dh.power > 0);
+						for(int i = 0; i < numFans; i++) {
+							stepEvents.push_back(fan[i].on);
+							stepEvents.push_back(fan[i].q);
+							}
+
+						if(!fullDay) {
+							// reduced order screening model in place of the airflow, heat and moisture balances
+							for(int i = 0; i < RS_STATES; i++)
+								screenState[i] = screenStart[i];
+							surrogate.flows(screenState, screenInput, screenFlow);
+							if(!surrogate.step(screenState, screenInput, screenFlow)) {
+								// outside the range the fit is trusted in, the full model takes over for the rest of the day
+								fullDay = true;
+								surrogate.reducedDays--;
+								surrogate.fallbackDays++;
+								moisture_nodes.setVaporPressure(6, HRAttic * cur_weather.pressure / (0.621945 + HRAttic));
+								for(int i = 7; i <= 9; i++)
+									moisture_nodes.setVaporPressure(i, HRHouse * cur_weather.pressure / (0.621945 + HRHouse));
+								}
+							}
 
-						// Ventilation and heat transfer calculations
-						int mainIterations = 0;
-						while(1) {
-							mainIterations = mainIterations + 1;	// counting # of temperature/ventilation iterations
-							int leakIterations = 0;
+						if(!fullDay) {
+							mIN = screenFlow[RF_IN];
+							mHouseIN = screenFlow[RF_HOUSEIN];
+							mHouseOUT = screenFlow[RF_HOUSEOUT];
+							mCeiling = screenFlow[RF_CEILING];
+							matticenvin = screenFlow[RF_ATTICIN];
+							matticenvout = screenFlow[RF_ATTICOUT];
+							mFlue = screenFlow[RF_FLUE];
+							Pint = screenFlow[RF_PINT];
+
+							// attic surfaces follow the attic air and the ceiling the house air, the ducts are at the
+							// temperature around them or carry the air handler flow
+							double tempDucts = (ductLocation == 1) ? screenState[RS_HOUSE] : screenState[RS_ATTIC];
+							for(int i = 0; i < ATTIC_NODES; i++)
+								b[i] = tempOld[i] + (i == 6 ? screenState[RS_HOUSE] - tempHouse : screenState[RS_ATTIC] - tempAttic);
+							b[0] = screenState[RS_ATTIC];
+							b[12] = screenState[RS_MASS];
+							b[15] = screenState[RS_HOUSE];
+							b[10] = tempDucts;
+							b[13] = tempDucts;
+							b[11] = (mAH > 0) ? b[15] : tempDucts;
+							b[14] = (mAH > 0) ? b[15] + screenInput[RI_SENSIBLE] / (mAH * CpAir) : tempDucts;
+							for(int i = 0; i < ATTIC_NODES; i++)
+								tempOld[i] = b[i];
+							tempAttic = b[0];
+							tempReturn = b[11];
+							tempSupply = b[14];
+							tempHouse = b[15];
 
+							HRAttic = screenState[RS_HRATTIC];
+							HRHouse = screenState[RS_HRHOUSE];
+							HRReturn = HRHouse;
+							HRSupply = (mAH > 0) ? max(HRHouse - latcap / (mAH * 2501000), 0.0) : HRHouse;
+							RHHouse = 100 * HRHouse * cur_weather.pressure / (0.621945 + HRHouse) / saturationVaporPressure(tempHouse);
+							RHAttic = 100 * HRAttic * cur_weather.pressure / (0.621945 + HRAttic) / saturationVaporPressure(tempAttic);
+						}
+						// airflow, heat and moisture are solved at the start of each step for the whole step
+						else if(timeStep.begin(stepEvents, STEPS_PER_HOUR - step)) {
+							double mCeilingOld = -1000;														// set so first iteration is forced
+							double PatticintOld = 0;
+							double mZones = 0;																	// flow from the zones into the house
+							double mZonesOld = 0;
+							double mCeilingLimit = 0.0001;   //= max(envC / 10, 0.00001);
+
+							// Ventilation and heat transfer calculations
+							int mainIterations = 0;
 							while(1) {
-								// Call houseleak subroutine to calculate air flow. Brennan added the variable mCeilingIN to be passed to the subroutine. Re-add between mHouseIN and mHouseOUT
-								sub_houseLeak(AHflag, leakIterations, cur_weather.windSpeedLocal, cur_weather.windDirection, tempHouse, tempAttic, cur_weather.dryBulb, envC, envPressureExp, eaveHeight,
-									leakFracCeil, leakFracFloor, leakFracWall, numFlues, flue, wallFraction, floorFraction, Sw, flueShelterFactor, numWinDoor, winDoor, numFans, fan, numPipes,
-									Pipe, mIN, mOUT, Pint, mFlue, mCeiling, mFloor, atticC, dPflue, Crawl,
-									Hfloor, rowHouse, soffitFraction, Patticint, wallCp, mSupReg, mAH, mRetLeak, mSupLeak,
-									mRetReg, mHouseIN, mHouseOUT, supC, supn, retC, retn, mSupAHoff, mRetAHoff, airDensityIN, airDensityOUT, airDensityATTIC, houseVolume, weatherFile.windPressureExp);
-								//Yihuan : put the mCeilingIN on comment 
-								leakIterations = leakIterations + 1;
-
-								if(abs(mCeilingOld - mCeiling) < mCeilingLimit || leakIterations > 10) {
+								mainIterations = mainIterations + 1;	// counting # of temperature/ventilation iterations
+								int leakIterations = 0;
+
+								// the airflows of the last solution are reused while the temperatures and wind have moved less than
+								// their thresholds and the envelope, fans and duct flows are the same (not with extra zones)
+								bool reuseLeak = false;
+								if(numZones == 0) {
+									double leakInputs[] = { envC, atticC, (double) AHflag, mSupReg, mRetReg, mSupLeak, mRetLeak };
+									leakStage.input(tempHouse, lazyTempThreshold);
+									leakStage.input(tempAttic, lazyTempThreshold);
+									leakStage.input(cur_weather.dryBulb, lazyTempThreshold);
+									leakStage.input(cur_weather.windSpeedLocal, lazyWindThreshold);
+									leakStage.input(cur_weather.windDirection, lazyWindAngleThreshold);
+									for(double input : leakInputs)
+										leakStage.input(input);
+									for(int i = 0; i < numFans; i++) {
+										leakStage.input(fan[i].on);
+										leakStage.input(fan[i].q);
+										}
+									for(int i = 0; i < numAtticFans; i++) {
+										leakStage.input(atticFan[i].on);
+										leakStage.input(atticFan[i].q);
+										}
+									reuseLeak = leakStage.reuse();
+									}
+
+								while(!reuseLeak) {
+									// Call houseleak subroutine to calculate air flow. Brennan added the variable mCeilingIN to be passed to the subroutine. Re-add between mHouseIN and mHouseOUT
+									sub_houseLeak(leakNetwork, AHflag, cur_weather.windSpeedLocal, cur_weather.windDirection, tempHouse, tempAttic, cur_weather.dryBulb, envC, atticC, Sw,
+										fan.data(), mIN, mOUT, Pint, mFlue, mCeiling, mFloor, dPflue, Patticint, wallCp, mSupReg, mRetReg, mHouseIN, mHouseOUT,
+										mSupAHoff, mRetAHoff, airDensityIN, airDensityOUT, airDensityATTIC);
+									//Yihuan : put the mCeilingIN on comment 
+									leakIterations = leakIterations + 1;
+
+									if((abs(mCeilingOld - mCeiling) < mCeilingLimit && abs(mZonesOld - mZones) < mCeilingLimit) || leakIterations > 10) {
 //if(abs(mCeilingOld - mCeiling) >= mCeilingLimit)
 //    cout << "Leak Loop exceeded at " << hour << ":" << minute << " Delta=" << mCeilingOld - mCeiling << " Pattic=" << Patticint << endl;
-									break;
-									}
-								else {
-                            		mCeilingOld = mCeiling;
-                            		PatticintOld = Patticint;
-									}
+										break;
+										}
+									else {
+	                            		mCeilingOld = mCeiling;
+	                            		PatticintOld = Patticint;
+	                            		mZonesOld = mZones;
+										}
 
-								// call atticleak subroutine to calculate air flow to/from the attic
-								sub_atticLeak(leakIterations, cur_weather.windSpeedLocal, cur_weather.windDirection, tempHouse, cur_weather.dryBulb, tempAttic, atticC, atticPressureExp, eaveHeight, roofPeakHeight,
-									flueShelterFactor, Sw, numAtticVents, atticVent, soffit, mAtticIN, mAtticOUT, Patticint, mCeiling, rowHouse,
-									soffitFraction, roofPitch, roofPeakPerpendicular, numAtticFans, atticFan, mSupReg, mRetLeak, mSupLeak, matticenvin,
-									matticenvout, mSupAHoff, mRetAHoff, airDensityIN, airDensityOUT, airDensityATTIC);
-								Patticint += (PatticintOld - Patticint) * 0.6;   // Relax Attic pressure feedback
-							}
+									// call atticleak subroutine to calculate air flow to/from the attic
+									sub_atticLeak(leakNetwork, leakIterations, cur_weather.windSpeedLocal, cur_weather.windDirection, tempHouse, cur_weather.dryBulb, tempAttic, atticC, Sw,
+										atticFan.data(), mAtticIN, mAtticOUT, Patticint, mCeiling, mRetLeak, mSupLeak, matticenvin, matticenvout, mSupAHoff, mRetAHoff,
+										airDensityIN, airDensityOUT, airDensityATTIC);
+									Patticint += (PatticintOld - Patticint) * 0.6;   // Relax Attic pressure feedback
+
+									// zones other than the house and attic are solved together
+									sub_zoneLeak(leakNetwork, cur_weather.windSpeedLocal, cur_weather.windDirection, cur_weather.dryBulb, Sw, airDensityOUT, numZones, zone.data(), mZones);
+								}
+								if(!reuseLeak)
+									leakStage.keep();
 
 
-							// adding fan heat for supply fans, internalGains1 is from input file, fanHeat reset to zero each minute, internalGains is common
-							internalGains = internalGains1 + fanHeat;
+								// adding fan heat for supply fans, internalGains1 is from input file, fanHeat reset to zero each minute, internalGains is common
+								internalGains = internalGains1 + fanHeat;
 
-							//bsize = sizeof(b)/sizeof(b[0]);
+								//bsize = sizeof(b)/sizeof(b[0]);
 
-							// Call heat subroutine to calculate heat exchange
-							sub_heat(cur_weather.dryBulb, mCeiling, AL4, cur_weather.windSpeedLocal, ssolrad, nsolrad, tempOld, atticVolume, houseVolume, cur_weather.skyCover, b,
-								floorArea, roofPitch, ductLocation, mSupReg, mRetReg, mRetLeak, mSupLeak, mAH, supRval, retRval, supDiameter,
-								retDiameter, supThickness, retThickness, supVel, retVel, 
-								cur_weather.pressure, cur_weather.humidityRatio, uaSolAir, uaTOut, matticenvin, matticenvout, mHouseIN, mHouseOUT, planArea, mSupAHoff,
-								mRetAHoff, solgain, tsolair, mFanCycler, roofPeakHeight, retLength, supLength,
-								roofType, roofExtRval, roofIntRval, ceilRval, gableEndRval, AHflag, mERV_AH, ERV_SRE, mHRV, HRV_ASE, mHRV_AH,
-								capacityc, capacityh, evapcap, internalGains, airDensityIN, airDensityOUT, airDensityATTIC, airDensitySUP, airDensityRET, numStories, storyHeight,
-								dh.sensible, H2, H4, H6, bulkArea, sheathArea, radiantBarrier);
+								// Call heat subroutine to calculate heat exchange
+								heatModel.step(cur_weather.dryBulb, mCeiling, cur_weather.windSpeedLocal, ssolrad, nsolrad, tempOld, cur_weather.skyCover, b,
+									mSupReg, mRetReg, mRetLeak, mSupLeak, mAH, supVel, retVel, cur_weather.pressure, cur_weather.humidityRatio, uaSolAir, uaTOut,
+									matticenvin, matticenvout, mHouseIN, mHouseOUT, mSupAHoff, mRetAHoff, solgain, tsolair, mFanCycler, AHflag,
+									mERV_AH, ERV_SRE, mHRV, HRV_ASE, mHRV_AH, capacityc, capacityh, evapcap, internalGains,
+									airDensityIN, airDensityOUT, airDensityATTIC, airDensitySUP, airDensityRET, dh.sensible, H2, H4, H6,
+									numZones, zone.data(), timeStep.length * dtau);
 
-							if((abs(b[0] - tempAttic) < .2) || (mainIterations > 10)) {	// Testing for convergence
+								if((abs(b[0] - tempAttic) < .2) || (mainIterations > 10)) {	// Testing for convergence
 if(abs(b[0] - tempAttic) >= .2)
    cout << "Temp Loop exceeded at " << hour << ":" << minute << " Delta=" << b[0] - tempAttic << " tempAttic=" << tempAttic << endl;
-								tempAttic        = b[0];
-								tempReturn       = b[11];
-								tempSupply       = b[14];
-								tempHouse        = b[15];
-								break;
+									tempAttic        = b[0];
+									tempReturn       = b[11];
+									tempSupply       = b[14];
+									tempHouse        = b[15];
+									break;
+								}
+								tempAttic = b[0];
+								tempHouse = b[15];
 							}
-							tempAttic = b[0];
-							tempHouse = b[15];
-						}
 
-						// setting "old" temps for next timestep to be current temps:
-						// [START] Moisture Balance ===================================================================================================================================
+							// setting "old" temps for next timestep to be current temps:
+							// [START] Moisture Balance ===================================================================================================================================
 
-						// Call moisture balance
-						double mRetOut = mFanCycler + mHRV_AH + mERV_AH * (1 - ERV_TRE);
-						moisture_nodes.mass_cond_bal(b, cur_weather.dryBulb, cur_weather.relativeHumidity,
-							airDensityOUT, airDensityATTIC, airDensityIN, airDensitySUP, airDensityRET,
-							cur_weather.pressure, H4, H2, H6, matticenvin, matticenvout, mCeiling, mHouseIN, mHouseOUT,
-							mAH, mRetAHoff, mRetLeak, mRetReg, mRetOut, mERV_AH * ERV_TRE, mSupAHoff, mSupLeak, mSupReg,
-							latcap, dh.condensate, latentLoad);
+							// Ideal latent load: in both seasons the moisture balance holds the house air at or below 50% RH at the
+							// setpoint and takes out what the flows into the house air and the internal moisture would add above it
+							if(idealLoads) {
+								idealSensible = heatModel.idealLoad;
+								idealResidual = max(idealResidual, abs(heatModel.idealResidual));
+								moisture_nodes.pwHold = 0.5 * saturationVaporPressure(setpoint);
+								}
 
-						HRAttic = calcHumidityRatio(moisture_nodes.PW[6],cur_weather.pressure);
-						HRReturn = calcHumidityRatio(moisture_nodes.PW[7],cur_weather.pressure);  
-						HRSupply = calcHumidityRatio(moisture_nodes.PW[8],cur_weather.pressure);
-						HRHouse = calcHumidityRatio(moisture_nodes.PW[9],cur_weather.pressure);  
-						RHHouse = moisture_nodes.moistureContent[9];
-						RHAttic = moisture_nodes.moistureContent[6];
+							// Call moisture balance
+							double mRetOut = mFanCycler + mHRV_AH + mERV_AH * (1 - ERV_TRE);
+							// solved every moistureStep minutes with the inputs averaged over the heat balance steps
+							bool moistureSolved = moisture_nodes.sub_cycle(timeStep.length, b, cur_weather.dryBulb,
+								cur_weather.relativeHumidity, airDensityOUT, airDensityATTIC, airDensityIN, airDensitySUP, airDensityRET,
+								cur_weather.pressure, H4, H2, H6, matticenvin, matticenvout, mCeiling, mHouseIN, mHouseOUT,
+								mAH, mRetAHoff, mRetLeak, mRetReg, mRetOut, mERV_AH * ERV_TRE, mSupAHoff, mSupLeak, mSupReg,
+								latcap, dh.condensate, latentLoad);
+							// the moisture is taken out at the same rate over the moisture step just solved
+							if(idealLoads && moistureSolved) {
+								idealLatent = moisture_nodes.moistureRemoved * 2501000;
+								latLoad += idealLatent * moisture_nodes.timeStep / 60;
+								peakLatentLoad = max(peakLatentLoad, idealLatent);
+								}
 
-						// [END] Moisture Balance =======================================================================================================================================
+							HRAttic = calcHumidityRatio(moisture_nodes.PW[6],cur_weather.pressure);
+							HRReturn = calcHumidityRatio(moisture_nodes.PW[7],cur_weather.pressure);  
+							HRSupply = calcHumidityRatio(moisture_nodes.PW[8],cur_weather.pressure);
+							HRHouse = calcHumidityRatio(moisture_nodes.PW[9],cur_weather.pressure);  
+							RHHouse = moisture_nodes.moistureContent[9];
+							RHAttic = moisture_nodes.moistureContent[6];
+
+							// [END] Moisture Balance =======================================================================================================================================
+
+							// node temperatures at the start and end of the step
+							stepStart.assign(tempOld, tempOld + ATTIC_NODES);
+							stepEnd.assign(b, b + ATTIC_NODES);
+							for(int i = 0; i < numZones; i++) {
+								stepStart.push_back(zone[i].tempOld);
+								stepStart.push_back(zone[i].tempMassOld);
+								stepEnd.push_back(zone[i].temp);
+								stepEnd.push_back(zone[i].tempMass);
+								}
+							timeStep.solved(stepStart, stepEnd);
+						}
+
+						if(fullDay) {
+							// setting "old" temps for next timestep to be the temps at the end of this minute, interpolated in longer steps
+							timeStep.advance(stepTemps);
+							for(int i = 0; i < ATTIC_NODES; i++) {
+								b[i] = stepTemps[i];
+								tempOld[i]  = b[i];
+								}
+							for(int i = 0; i < numZones; i++) {
+								zone[i].temp = stepTemps[ATTIC_NODES + 2 * i];
+								zone[i].tempMass = stepTemps[ATTIC_NODES + 2 * i + 1];
+								zone[i].tempOld = zone[i].temp;
+								zone[i].tempMassOld = zone[i].tempMass;
+								}
+							tempAttic = b[0];
+							tempReturn = b[11];
+							tempSupply = b[14];
+							tempHouse = b[15];
 
-						for(int i = 0; i < ATTIC_NODES; i++) {
-							tempOld[i]  = b[i];
+							// full model minute for training the reduced order model
+							if(screeningInterval > 0) {
+								screenState[RS_ATTIC] = tempAttic;
+								screenState[RS_HOUSE] = tempHouse;
+								screenState[RS_MASS] = b[12];
+								screenState[RS_HRATTIC] = HRAttic;
+								screenState[RS_HRHOUSE] = HRHouse;
+								screenFlow[RF_IN] = mIN;
+								screenFlow[RF_HOUSEIN] = mHouseIN;
+								screenFlow[RF_HOUSEOUT] = mHouseOUT;
+								screenFlow[RF_CEILING] = mCeiling;
+								screenFlow[RF_ATTICIN] = matticenvin;
+								screenFlow[RF_ATTICOUT] = matticenvout;
+								screenFlow[RF_FLUE] = mFlue;
+								screenFlow[RF_PINT] = Pint;
+								surrogate.record(screenStart, screenInput, screenFlow, screenState);
+								}
 							}
 
 						// ************** house ventilation rate  - what would be measured with a tracer gas i.e., not just envelope and vent fan flows
@@ -2573,7 +2410,7 @@ if(abs(b[0] - tempAttic) >= .2)
 							}
 					
 						if(occupied[weekend][hour] == 1) { //house is occupied, then increment counter. 
-							occupiedMinCount += 1; // counts number of minutes while house is occupied
+							occupiedMinCount += 1; // counts number of steps while house is occupied
 							}
 					
 
@@ -2677,14 +2514,17 @@ if(abs(b[0] - tempAttic) >= .2)
 							}
 			
 						// Calculating sums for electrical and gas energy use
-						AH_kWh = AH_kWh + AHfanPower;								// Total air Handler energy for the simulation in kWh
-						compressor_kWh = compressor_kWh + compressorPower;	// Total cooling/compressor energy for the simulation in kWh
-						mechVent_kWh = mechVent_kWh + mechVentPower;			// Total mechanical ventilation energy for over the simulation in kWh
-						gasTherm = gasTherm + hcap;								// Total Heating energy for the simulation in therms
-						dehumidifier_kWh += dh.power;
-						//coolingLoad += capacityc / 60000;
-						//latLoad += latcap / 60000;
-						//heatingLoad += capacityh / 60000;
+						AH_kWh = AH_kWh + AHfanPower * STEP_MINUTES;								// Total air Handler energy for the simulation in kWh
+						compressor_kWh = compressor_kWh + compressorPower * STEP_MINUTES;	// Total cooling/compressor energy for the simulation in kWh
+						mechVent_kWh = mechVent_kWh + mechVentPower * STEP_MINUTES;			// Total mechanical ventilation energy for over the simulation in kWh
+						gasTherm = gasTherm + hcap * STEP_MINUTES;								// Total Heating energy for the simulation in therms
+						dehumidifier_kWh += dh.power * STEP_MINUTES;
+						if(idealLoads) {
+							coolingLoad += max(-idealSensible, 0.0) * STEP_MINUTES;
+							heatingLoad += max(idealSensible, 0.0) * STEP_MINUTES;
+							peakCoolingLoad = max(peakCoolingLoad, -idealSensible);
+							peakHeatingLoad = max(peakHeatingLoad, idealSensible);
+							}
 
 						// Average temperatures and airflows
 						meanOutsideTemp = meanOutsideTemp + cur_weather.dryBulb;	// Average external temperature over the simulation
@@ -2698,8 +2538,8 @@ if(abs(b[0] - tempAttic) >= .2)
 							totalRelDose = totalRelDose + relDose;
 							}
 
-						TotalDAventLoad = TotalDAventLoad + DAventLoad; 			//sums the dry air loads
-						TotalMAventLoad = TotalMAventLoad + MAventLoad; 			//sums the moist air loads
+						TotalDAventLoad = TotalDAventLoad + DAventLoad * STEP_MINUTES; 			//sums the dry air loads
+						TotalMAventLoad = TotalMAventLoad + MAventLoad * STEP_MINUTES; 			//sums the moist air loads
 
 
 						// ================================= WRITING RCO DATA FILE =================================
@@ -2709,16 +2549,21 @@ if(abs(b[0] - tempAttic) >= .2)
 
 						// tab separated instead of commas- makes output files smaller
 						if(printOutputFile) {
-							outputFile << year << "\t" << hour << "\t" << minuteTotal << "\t" << cur_weather.windSpeedLocal << "\t" << cur_weather.dryBulb << "\t" << tempHouse << "\t" << setpoint << "\t";
+							outputFile << year << "\t" << hour << "\t" << stepTotal << "\t" << cur_weather.windSpeedLocal << "\t" << cur_weather.dryBulb << "\t" << tempHouse << "\t" << setpoint << "\t";
 							outputFile << tempAttic << "\t" << tempSupply << "\t" << tempReturn << "\t" << AHflag << "\t" << AHfanPower << "\t";
-							outputFile << compressorPower << "\t" << mechVentPower << "\t" << HRHouse * 1000 << "\t" << SHR << "\t" << Mcoil << "\t";
+							outputFile << compressorPower << "\t" << mechVentPower << "\t" << HRHouse * 1000 << "\t" << compressor.SHR << "\t" << compressor.coilMoisture << "\t";
 							outputFile << Pint << "\t"<< qHouse << "\t" << houseACH << "\t" << flueACH << "\t" << ventSum << "\t" << nonRivecVentSum << "\t";
-							outputFile << fan[0].on << "\t" << fan[1].on << "\t" << fan[2].on << "\t" << fan[3].on << "\t" << fan[4].on << "\t" << fan[5].on << "\t" << fan[6].on << "\t";
+							for(int i=0; i < 7; i++) {			// output columns fan1 to fan7
+								outputFile << (i < numFans ? fan[i].on : 0) << "\t";
+							}
 							outputFile << rivecOn << "\t" << relExp << "\t" << relDose << "\t";
 							outputFile << occupied[weekend][hour] << "\t"; 
 							outputFile << cur_weather.humidityRatio << "\t" << HRAttic << "\t" << HRReturn << "\t" << HRSupply << "\t" << HRHouse << "\t" << RHHouse << "\t" << HumidityIndex << "\t" << dh.condensate << "\t" << indoorConc << "\t" << moldIndex_South << "\t" << moldIndex_North << "\t" << moldIndex_BulkFraming << "\t";
 							outputFile << mHouseIN << "\t" << mHouseOUT << "\t" << (mCeiling + mSupAHoff + mRetAHoff) << "\t" << matticenvin << "\t" << matticenvout << "\t" << mSupReg << "\t" << mRetReg << "\t";
-							outputFile << qHouseIN << "\t" << qHouseOUT << "\t" << qCeiling << "\t" << qAtticIN << "\t" << qAtticOUT << "\t" << qSupReg << "\t" << qRetReg << endl;
+							outputFile << qHouseIN << "\t" << qHouseOUT << "\t" << qCeiling << "\t" << qAtticIN << "\t" << qAtticOUT << "\t" << qSupReg << "\t" << qRetReg;
+							for(int i = 0; i < numZones; i++)
+								outputFile << "\t" << zone[i].temp << "\t" << zone[i].P;
+							outputFile << endl;
 							//outputFile << mHouse << "\t" << mHouseIN << "\t" << mHouseOUT << mCeiling << "\t" << mHouseIN << "\t" << mHouseOUT << "\t" << mSupReg << "\t" << mRetReg << "\t" << mSupAHoff << "\t" ;
 							//outputFile << mRetAHoff << "\t" << mHouse << "\t"<< flag << "\t"<< AIM2 << "\t" << AEQaim2FlowDiff << "\t" << qFanFlowRatio << "\t" << C << endl; //Breann/Yihuan added these for troubleshooting
 						}
@@ -2746,19 +2591,19 @@ if(abs(b[0] - tempAttic) >= .2)
 						}
 			
 						// ================================= WRITING Filter Loading DATA FILE =================================
-						massFilter_cumulative = massFilter_cumulative + (mAH * 60);	// Time steps are every minute and mAH is in [kg/s]
-						massAH_cumulative = massAH_cumulative + (mAH * 60);			// Time steps are every minute and mAH is in [kg/s]
+						massFilter_cumulative = massFilter_cumulative + (mAH * dtau);	// mAH is in [kg/s]
+						massAH_cumulative = massAH_cumulative + (mAH * dtau);			// mAH is in [kg/s]
 						// Filter loading output file
 						if(printFilterFile) {
 							filterFile << massAH_cumulative << "\t"  << qAH << "\t" << AHfanPower << "\t" << retLF << endl;
 							}
 
 						// Time keeping
-						minuteTotal++;													// Minute count of year
+						stepTotal++;													// Step count of year
 
-						//if(minuteTotal > (365 * 1440))
+						//if(stepTotal > (365 * 1440))
 						//	break;
-					}     // end of minute loop
+					}     // end of step loop
 					weatherFile.nextHour();
 
 					// Mold Index Calculations per ASHRAE 160, BDL 12/2016
@@ -2775,10 +2620,29 @@ if(abs(b[0] - tempAttic) >= .2)
 					moldIndex_BulkFraming = sub_moldIndex(0, moldIndex_BulkFraming, b[5], moisture_nodes.PW[2], Time_decl_Bulk); //Bulk Attic Framing Surface Node
 
 				}      // end of hour loop
+
+				if(screeningInterval > 0 && fullDay)
+					surrogate.endDay();
+				repDays.endDay(day);
 			}    // end of day loop
 			weatherFile.close();
 			fanScheduleFile.close();
 		}	// end of year loop
+		return 0;
+		};
+		int simulated = withControls(controlSettings, simulate);
+		if(simulated != 0)
+			return simulated;
+
+		// Parareal sweeps and slices end here, the driver takes the annual totals from the slices
+		if(parareal.role == PR_SWEEP || parareal.role == PR_FINE) {
+			packState(pararealState);
+			parareal.finish(pararealState);
+			}
+		if(parareal.role == PR_DRIVER) {
+			parareal.results();
+			stepTotal = 1 + (long) STEPS_PER_DAY * (simulationDays - recordStart);
+			}
 		//} while (weatherFile);			// Run until end of weather file
 
 		//[END] Main Simulation Loop ==============================================================================================================================================
@@ -2799,26 +2663,29 @@ if(abs(b[0] - tempAttic) >= .2)
 		gasTherm = gasTherm * 60 / 1000000 / 105.5;	// Total Heating energy for the simulation in therms
 		furnace_kWh = gasTherm * 29.3;					// Total heating/furnace energy for the simulation in kWh
 		dehumidifier_kWh = dehumidifier_kWh / 60 / 1000;
+		coolingLoad = coolingLoad / 60 / 1000;			// Ideal loads in kWh
+		latLoad = latLoad / 60 / 1000;
+		heatingLoad = heatingLoad / 60 / 1000;
 		double total_kWh = AH_kWh + furnace_kWh + compressor_kWh + mechVent_kWh + dehumidifier_kWh;
 
-		meanOutsideTemp = meanOutsideTemp / minuteTotal - C_TO_K;
-		meanAtticTemp = meanAtticTemp / minuteTotal - C_TO_K;
-		meanHouseTemp = meanHouseTemp / minuteTotal - C_TO_K;
-		meanHouseACH = meanHouseACH / minuteTotal;
-		meanFlueACH = meanFlueACH / minuteTotal;
+		meanOutsideTemp = meanOutsideTemp / stepTotal - C_TO_K;
+		meanAtticTemp = meanAtticTemp / stepTotal - C_TO_K;
+		meanHouseTemp = meanHouseTemp / stepTotal - C_TO_K;
+		meanHouseACH = meanHouseACH / stepTotal;
+		meanFlueACH = meanFlueACH / stepTotal;
 
 		if(OccContType > 2){
 			meanRelExp = totalRelExp / occupiedMinCount;
 			meanRelDose = totalRelDose / occupiedMinCount;
 			}
 		else {
-			meanRelExp = totalRelExp / minuteTotal;
-			meanRelDose = totalRelDose / minuteTotal;
+			meanRelExp = totalRelExp / stepTotal;
+			meanRelDose = totalRelDose / stepTotal;
 		}
 
-		RHexcAnnual60 = RHtot60 / minuteTotal;
-		RHexcAnnual70 = RHtot70 / minuteTotal;
-		HumidityIndex_Avg = HumidityIndex_Sum / minuteTotal;
+		RHexcAnnual60 = RHtot60 / stepTotal;
+		RHexcAnnual70 = RHtot70 / stepTotal;
+		HumidityIndex_Avg = HumidityIndex_Sum / stepTotal;
 		
 		// Write summary output file (RC2 file)
 		ofstream ou2File(summaryFileName); 
@@ -2833,21 +2700,50 @@ if(abs(b[0] - tempAttic) >= .2)
 		ou2File << "Temp_out\tTemp_attic\tTemp_house";
 		ou2File << "\tAH_kWh\tfurnace_kWh\tcompressor_kWh\tmechVent_kWh\ttotal_kWh\tmean_ACH\tflue_ACH";
 		ou2File << "\tmeanRelExp\tmeanRelDose";
-		ou2File << "\toccupiedMinCount\trivecMinutes\tNL\tenvC\tAeq\tfilterChanges\tMERV\tloadingRate\tDryAirVentLoad\tMoistAirVentLoad\tRHexcAnnual60\tRHexcAnnual70\tHumidityIndex_Avg\tdehumidifier_kWh" << endl;
+		ou2File << "\toccupiedMinCount\trivecMinutes\tNL\tenvC\tAeq\tfilterChanges\tMERV\tloadingRate\tDryAirVentLoad\tMoistAirVentLoad\tRHexcAnnual60\tRHexcAnnual70\tHumidityIndex_Avg\tdehumidifier_kWh";
+		if(idealLoads)
+			ou2File << "\theatingLoad_kWh\tcoolingLoad_kWh\tlatentLoad_kWh\tpeakHeating_W\tpeakCooling_W\tpeakLatent_W";
+		ou2File << endl;
 		//Values
 		ou2File << meanOutsideTemp << "\t" << meanAtticTemp << "\t" << meanHouseTemp << "\t";
 		ou2File << AH_kWh << "\t" << furnace_kWh << "\t" << compressor_kWh << "\t" << mechVent_kWh << "\t" << total_kWh << "\t" << meanHouseACH << "\t" << meanFlueACH << "\t";
 		ou2File << meanRelExp << "\t" << meanRelDose << "\t";
-		ou2File << occupiedMinCount << "\t" << rivecMinutes << "\t" << NL << "\t" << envC << "\t" << Aeq << "\t" << filterChanges << "\t" << MERV << "\t" << loadingRate << "\t" << TotalDAventLoad << "\t" << TotalMAventLoad;
-		ou2File << "\t" << RHexcAnnual60 << "\t" << RHexcAnnual70 << "\t" << HumidityIndex_Avg << "\t" << dehumidifier_kWh << endl;
+		ou2File << occupiedMinCount * STEP_SECONDS / 60 << "\t" << rivecMinutes * STEP_SECONDS / 60 << "\t" << NL << "\t" << envC << "\t" << Aeq << "\t" << filterChanges << "\t" << MERV << "\t" << loadingRate << "\t" << TotalDAventLoad << "\t" << TotalMAventLoad;
+		ou2File << "\t" << RHexcAnnual60 << "\t" << RHexcAnnual70 << "\t" << HumidityIndex_Avg << "\t" << dehumidifier_kWh;
+		if(idealLoads)
+			ou2File << "\t" << heatingLoad << "\t" << coolingLoad << "\t" << latLoad << "\t" << peakHeatingLoad << "\t" << peakCoolingLoad << "\t" << peakLatentLoad;
+		ou2File << endl;
 
 		ou2File.close();
 		
+		cout << endl;
+		if(screeningInterval > 0) {
+			cout << "Screening model: " << surrogate.trainingDays << " full model days (" << surrogate.fallbackDays
+				<< " taken over from the reduced order model), " << surrogate.reducedDays << " reduced order days" << endl;
+			cout << "Validation RMS error over " << surrogate.validationMinutes * STEP_SECONDS / 60 << " minutes: attic " << surrogate.rmsError(RS_ATTIC)
+				<< " K, house " << surrogate.rmsError(RS_HOUSE) << " K, house mass " << surrogate.rmsError(RS_MASS) << " K, attic HR "
+				<< surrogate.rmsError(RS_HRATTIC) * 1000 << " g/kg, house HR " << surrogate.rmsError(RS_HRHOUSE) * 1000 << " g/kg" << endl;
+			}
+		if(runStartDay > 0)
+			cout << "Run period: days " << runStartDay << " to " << runEndDay << " after " << runStartDay - firstDay << " warmup days" << endl;
+		if(idealLoads)
+			cout << "Ideal loads: heating " << heatingLoad << " kWh (peak " << peakHeatingLoad << " W), cooling " << coolingLoad << " kWh (peak "
+				<< peakCoolingLoad << " W), latent " << latLoad << " kWh (peak " << peakLatentLoad << " W), largest setpoint residual "
+				<< idealResidual << " K" << endl;
+		if(parareal.role == PR_DRIVER)
+			cout << "Parareal: " << parareal.iterations << " iterations, largest jump between slices " << parareal.defect << endl;
+		if(representativeDays > 0) {
+			double energyError = repDays.energyError();
+			cout << "Representative days: estimated error of total_kWh " << energyError << " kWh (" << 100 * energyError / total_kWh << "%)" << endl;
+			}
+		cout << "Lazy evaluation reuse:";
+		for(LazyStage* stage : { &leakNetwork.windStage, &leakStage })
+			cout << " " << stage->name << " " << 100 * stage->hitRate() << "% of " << stage->evaluations + stage->reuses << " calls";
 		cout << endl;
 		cout << "Moisture model: out_iter: " << moisture_nodes.total_out_iter << " in_iter: " << moisture_nodes.total_in_iter << endl;
 		cout << "Node, minutes above saturation: ";
 		for(int i=0; i<MOISTURE_NODES; i++)
-			cout << i << "(" << moisture_nodes.saturated_minutes[i] << ") ";
+			cout << i << "(" << moisture_nodes.saturated_steps[i] * STEP_SECONDS / 60 << ") ";
 		cout << endl; 
 
 	}
@@ -2,14 +2,22 @@
 #include "psychro.h"
 #include "constants.h"
 #include "gauss.h"
+#include "sorption.h"
 #ifdef __APPLE__
    #include <cmath>        // needed for mac g++
 #endif
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 using namespace std;
 
+const double LEWIS = 0.919;	// Lewis number for air and water vapor from ASHRAE 1989 p5-9
+const double diffCoefWood = 3E-10; // diffusion coefficient for pine from Cunningham 1990 (m2/s)
+const double diffCoefIns = 2.12E-5; // diffusion coefficient for fiberglass (106 perm-in) (m2/s)
+//const double diffCoefIns = 2.2472e-07; //diffusion coefficient for fiber insulation with vapor retarder (1 perm). (m2/s).
+const int RWATER = 462;			// gas constant for water vapor (J/KgK)
+
 /*
  * Moisture - Moisture class constructor
  * @param atticVolume - attic volume (m3)
@@ -39,6 +47,8 @@ using namespace std;
  * 10. house materials - corresponding thermal node is (12)
  * 11. interior south roof insulation ((3+17)/2)
  * 11. interior north roof insulation ((1+16)/2)
+ * The parts of the mass transfer coefficients that only depend on the geometry are found here, mass_cond_bal divides
+ * them by the node temperatures and adds the flows.
  */
 Moisture::Moisture(double atticVolume, double retDiameter, double retLength, double supDiameter, double supLength, double houseVolume, 
 						double floorArea, double sheathArea, double bulkArea, double roofInsThick, double roofExtRval, double mcInit) {
@@ -69,6 +79,7 @@ Moisture::Moisture(double atticVolume, double retDiameter, double retLength, dou
 	   roofInsulRatio = 1;
 	   }
    A.resize(moisture_nodes, vector<double>(moisture_nodes+1, 0));		// set size of equation vectors to number of nodes (A contains both)
+   work = A;
    PW.resize(moisture_nodes, 0);
 
 	deltaX[0] = sheathThick / 2;                // distance between the centers of the surface and inside wood layers. it is half the characteristic thickness of the wood member
@@ -103,30 +114,47 @@ Moisture::Moisture(double atticVolume, double retDiameter, double retLength, dou
 	density[4] = densitySheathing;
 	density[5] = densityWood;
 
+	for(int i=0; i < 3; i++)
+		woodDiffusion[i] = diffCoefWood * area[i] / RWATER;
+	for(int i=0; i < 2; i++)
+		insDiffusion[i] = diffCoefIns * area[i] / RWATER;
+	for(int i=6; i < moisture_nodes; i++)
+		airCapacity[i] = volume[i] / RWATER;
+
 	haHouse = 1 * 0.622 * .5 * floorArea / 186;	// moisture transport coefficient scales with floor area (kg/s) - 0.622 (dHR/dVP), 186 (area of std house in m2), 0.5 empirical coefficient (kg/s)
 	massWHouse = 1 * 0.622 * 60 * floorArea;					// active mass containing moisture in the house (kg) - empirical
+	housePressure = 0;
+	haHousePressure = 0;
+	massWHousePressure = 0;
 
 	// initialize wood nodes
 	for(int i=0; i<6; i++) {
 		tempOld[i] = tempInit;
 		mTotal[i] = 0;
 		moistureContent[i] = mcInit;
-		PWOld[i] = calc_vapor_pressure(mcInit, tempInit, pressure);
-		saturated_minutes[i] = 0;
+		PWOld[i] = sorptionVaporPressure(mcInit, sorptionFactor(tempInit), pressure);
+		saturated_steps[i] = 0;
 		}
 	// initialize air nodes
 	for(int i=6; i<MOISTURE_NODES; i++) {
 		tempOld[i] = tempInit;
 		PWOld[i] = saturationVaporPressure(tempInit) * RHInit / 100;
-		saturated_minutes[i] = 0;
+		saturated_steps[i] = 0;
 		}
 	total_out_iter = 0;
 	total_in_iter = 0;
+	timeStep = dtau;
+	subStep = 1;
+	saturation = 0;
+	cycleMinutes = 0;
+	pwHold = 0;
+	moistureRemoved = 0;
 }							
 							
 /*
  * mass_cond_bal - Uses the results of the ventilation and heat transfer models to predict
  *                 moisture transport. Includes effects of surfaces at saturation pressure.
+ *                 With pwHold set the house air is kept at or below it and moistureRemoved is the moisture taken out.
  * @param node_temps - array of node temperatures (deg K)
  * @param tempOut - Outdoor temperature (deg K)
  * @param RHOut - Outdoor relative humidity (%)
@@ -164,11 +192,6 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
                   double mAH, double mRetAHoff, double mRetLeak, double mRetReg, double mRetOut, double mErvHouse,
                   double mSupAHoff, double mSupLeak, double mSupReg, double latcap, double dhMoistRemv, double latload)
                                    {
-	const double LEWIS = 0.919;	// Lewis number for air and water vapor from ASHRAE 1989 p5-9
-	const double diffCoefWood = 3E-10; // diffusion coefficient for pine from Cunningham 1990 (m2/s)
-	const double diffCoefIns = 2.12E-5; // diffusion coefficient for fiberglass (106 perm-in) (m2/s)
-	//const double diffCoefIns = 2.2472e-07; //diffusion coefficient for fiber insulation with vapor retarder (1 perm). (m2/s).
-	const int RWATER = 462;			// gas constant for water vapor (J/KgK)
 	double PWOut;						// outdoor air vapor pressure (Pa)
 	double hw0, hw1, hw2;			// mass transfer coefficients for water vapor (m/s)
 
@@ -200,14 +223,14 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
 	//NODE  0 inside of south sheathing
 	kappa1[0] = calc_kappa_1(pressure, tempOld[0], moistureContent[0], volume[0] * density[0]);
 	kappa2[0] = calc_kappa_2(moistureContent[0], volume[0] * density[0]);
-	x30 = diffCoefWood * area[0] / RWATER / temperature[0] / deltaX[0];
-	x03 = -diffCoefWood * area[0] / RWATER / temperature[3] / deltaX[0];
+	x30 = woodDiffusion[0] / temperature[0] / deltaX[0];
+	x03 = -woodDiffusion[0] / temperature[3] / deltaX[0];
 	A[0][0] = kappa1[0] + x30;
 	A[0][3] = x03;
 	PWInit[0] = kappa1[0] * PWOld[0] - kappa2[0] * (temperature[0] - tempOld[0]);
 	if(moisture_nodes > 11) {		// there is interior insulation
-		x110 = diffCoefIns * area[0] / RWATER / temperature[0] / deltaX[11];
-		x011 = -diffCoefIns * area[0] / RWATER / temperature[11] / deltaX[11];
+		x110 = insDiffusion[0] / temperature[0] / deltaX[11];
+		x011 = -insDiffusion[0] / temperature[11] / deltaX[11];
 		A[0][0] += x110;
 		A[0][11] = x011;
 		}
@@ -221,14 +244,14 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
 	//NODE 1 inside of north sheathing
 	kappa1[1] = calc_kappa_1(pressure, tempOld[1], moistureContent[1], volume[1] * density[1]);
 	kappa2[1] = calc_kappa_2(moistureContent[1], volume[1] * density[1]);
-	x41 = diffCoefWood * area[1] / RWATER / temperature[1] / deltaX[1];
-	x14 = -diffCoefWood * area[1] / RWATER / temperature[4] / deltaX[1];
+	x41 = woodDiffusion[1] / temperature[1] / deltaX[1];
+	x14 = -woodDiffusion[1] / temperature[4] / deltaX[1];
 	A[1][1] = kappa1[1] + x41;
 	A[1][4] = x14;
 	PWInit[1] = kappa1[1] * PWOld[1] - kappa2[1] * (temperature[1] - tempOld[1]);
 	if(moisture_nodes > 11) {		// there is interior insulation
-		x121 = diffCoefIns * area[1] / RWATER / temperature[1] / deltaX[12];
-		x112 = -diffCoefIns * area[1] / RWATER / temperature[12] / deltaX[12];
+		x121 = insDiffusion[1] / temperature[1] / deltaX[12];
+		x112 = -insDiffusion[1] / temperature[12] / deltaX[12];
 		A[1][1] += x121;
 		A[1][12] = x112;
 		}
@@ -243,9 +266,9 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
 	kappa1[2] = calc_kappa_1(pressure, tempOld[2], moistureContent[2], volume[2] * density[2]);
 	kappa2[2] = calc_kappa_2(moistureContent[2], volume[2] * density[2]);
 	x62 = hw2 * area[2] / RWATER / temperature[2];
-	x52 = diffCoefWood * area[2] / RWATER / temperature[2] / deltaX[2];
+	x52 = woodDiffusion[2] / temperature[2] / deltaX[2];
 	x26 = -hw2 * area[2] / RWATER / temperature[6];
-	x25 = -diffCoefWood * area[2] / RWATER / temperature[5] / deltaX[2];
+	x25 = -woodDiffusion[2] / temperature[5] / deltaX[2];
 	A[2][2] = kappa1[2] + x62 + x52;
 	A[2][6] = x26;
 	A[2][5] = x25;
@@ -273,7 +296,7 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
 	PWInit[5] = kappa1[5] * PWOld[5] - kappa2[5] * (temperature[5] - tempOld[5]);
 
 	//NODE 6 IS ATTIC AIR
-	x66 = volume[6] / RWATER / temperature[6] / timeStep;
+	x66 = airCapacity[6] / temperature[6] / timeStep;
 	x6out = (-mAtticOut - mRetLeak) / airDensityAttic / RWATER / temperature[6];
 	if(mCeiling < 0) {
 		x67 = mRetAHoff / RWATER / temperature[7] / airDensityRet;
@@ -309,7 +332,7 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
 		}
 
 	//NODE 7 IS RETURN DUCT AIR
-	A[7][7] = volume[7] / RWATER / temperature[7] / timeStep;
+	A[7][7] = airCapacity[7] / temperature[7] / timeStep;
 	if(mCeiling < 0) {
 		A[7][7] += (mAH - mRetAHoff) / RWATER / temperature[7] / airDensityRet;
 		A[7][6] = mRetLeak / RWATER / temperature[6] / airDensityAttic;
@@ -323,7 +346,7 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
 	PWInit[7] = volume[7] * PWOld[7] / RWATER / temperature[7] / timeStep - mRetOut * PWOut / RWATER / tempOut / airDensityOut;
 
 	//NODE 8 IS SUPPLY DUCT AIR
-	A[8][8] = volume[8] / RWATER / temperature[8] / timeStep;
+	A[8][8] = airCapacity[8] / temperature[8] / timeStep;
 	A[8][7] = -mAH / RWATER / temperature[7] / airDensityRet;
 	if(mCeiling < 0) {
 		A[8][8] += (mSupReg + mSupLeak - mSupAHoff) / RWATER / temperature[8] / airDensitySup;
@@ -338,8 +361,14 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
 	PWInit[8] = volume[8] * PWOld[8] / RWATER / temperature[8] / timeStep - latcap / 2501000;
 
 	//NODE 9 IS HOUSE AIR
-	A[9][9] = volume[9] / RWATER / temperature[9] / timeStep + haHouse / pressure;
-	A[9][10] = -haHouse / pressure;
+	if(pressure != housePressure) {
+		housePressure = pressure;
+		haHousePressure = haHouse / pressure;
+		massWHousePressure = massWHouse / pressure;
+		A[9][10] = -haHousePressure;
+		A[10][9] = -haHousePressure;
+		}
+	A[9][9] = airCapacity[9] / temperature[9] / timeStep + haHousePressure;
 	if(mCeiling < 0) {
 		A[9][9] += (-mHouseOut - mRetReg - mCeiling - mRetAHoff - mSupAHoff) / RWATER / temperature[9] / airDensityHouse;
 		A[9][6] = 0;
@@ -355,19 +384,18 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
 	PWInit[9] = volume[9] * PWOld[9] / RWATER / temperature[9] / timeStep + mHouseIn * PWOut / RWATER / tempOut / airDensityOut - dhMoistRemv + latload;
 
 	//NODE 10 IS HOUSE MASS
-	A[10][9] = -haHouse / pressure;
-	A[10][10] = massWHouse / pressure / timeStep + haHouse / pressure;
+	A[10][10] = massWHousePressure / timeStep + haHousePressure;
 	PWInit[10] = massWHouse * PWOld[10] / pressure / timeStep;
 
 	if(moisture_nodes > 11) {
 		//NODE 11  - inside of south roof insulation
-		A[11][11] = volume[11] / RWATER / temperature[11] / timeStep - x611 - x011;
+		A[11][11] = airCapacity[11] / temperature[11] / timeStep - x611 - x011;
 		A[11][6] = -x116;
 		A[11][0] = -x110;
 		PWInit[11] = volume[11] * PWOld[11] / RWATER / temperature[11] / timeStep;
 
 		//NODE 12  - inside of north roof insulation
-		A[12][12] = volume[12] / RWATER / temperature[12] / timeStep - x612 - x112;
+		A[12][12] = airCapacity[12] / temperature[12] / timeStep - x612 - x112;
 		A[12][6] = -x126;
 		A[12][1] = -x121;
 		PWInit[12] = volume[12] * PWOld[12] / RWATER / temperature[12] / timeStep;
@@ -377,19 +405,125 @@ void Moisture::mass_cond_bal(double* node_temps, double tempOut, double RHOut,
    for (int i=0; i<moisture_nodes; i++) {
        A[i][moisture_nodes] = PWInit[i];
        }
-   PW = gauss(A);
+   for(int i=0; i<moisture_nodes; i++)
+       copy(A[i].begin(), A[i].end(), work[i].begin());
+   gauss(work, PW);
+
+	// ideal loads: a house air above pwHold is held at it, the house air equation is replaced by PW[9] = pwHold
+	bool holdHouse = pwHold > 0 && PW[9] > pwHold;
+	if(holdHouse) {
+		for(int i=0; i<moisture_nodes; i++)
+			copy(A[i].begin(), A[i].end(), work[i].begin());
+		fill(work[9].begin(), work[9].end(), 0.0);
+		work[9][9] = 1;
+		work[9][moisture_nodes] = pwHold;
+		gauss(work, PW);
+		}
 
 	// once the attic moisture nodes have been calculated assuming no condensation (as above)
 	// then we call cond_bal to check for condensation and redo the calculations if necessasry
 	// cond_bal performs an iterative scheme that tests for condensation
 	cond_bal(pressure);
 
+	// the moisture taken out to hold the house air is what is left over in its equation, with all the inflows
+	moistureRemoved = 0;
+	if(holdHouse) {
+		moistureRemoved = PWInit[9];
+		for(int i=0; i<moisture_nodes; i++)
+			moistureRemoved -= A[9][i] * PW[i];
+		}
+
 	for(int i=0; i<moisture_nodes; i++) {
 		tempOld[i] = temperature[i];
 		PWOld[i] = abs(PW[i]);			// in case negative PW's are generated (should get set to 0??)
 		}
 }
 
+/*
+ * sub_cycle - multi-rate moisture balance. The wood moisture responds over hours so the inputs of mass_cond_bal are
+ *             averaged over the heat balance steps and the moisture balance is solved once every subStep minutes.
+ *             Every heat balance step is solved when a node was close to saturation at the end of the last solution.
+ * @param minutes - length of the heat balance step (minutes)
+ * the other parameters are the mass_cond_bal parameters for the heat balance step
+ * @return true if the moisture balance was solved
+ */
+bool Moisture::sub_cycle(double minutes, double* node_temps, double tempOut, double RHOut,
+                  double airDensityOut, double airDensityAttic, double airDensityHouse, double airDensitySup, double airDensityRet,
+                  int pressure, double hU0, double hU1, double hU2,
+                  double mAtticIn, double mAtticOut, double mCeiling, double mHouseIn, double mHouseOut,
+                  double mAH, double mRetAHoff, double mRetLeak, double mRetReg, double mRetOut, double mErvHouse,
+                  double mSupAHoff, double mSupLeak, double mSupReg, double latcap, double dhMoistRemv, double latload) {
+	double inputs[] = { tempOut, RHOut, airDensityOut, airDensityAttic, airDensityHouse, airDensitySup, airDensityRet,
+		(double) pressure, hU0, hU1, hU2, mAtticIn, mAtticOut, mCeiling, mHouseIn, mHouseOut,
+		mAH, mRetAHoff, mRetLeak, mRetReg, mRetOut, mErvHouse, mSupAHoff, mSupLeak, mSupReg, latcap, dhMoistRemv, latload };
+	const int numInputs = sizeof(inputs) / sizeof(inputs[0]);
+	double a[numInputs];
+	double temps[ATTIC_NODES];
+
+	if(cycleMinutes == 0) {
+		inputSum.assign(numInputs, 0);
+		tempSum.assign(ATTIC_NODES, 0);
+		}
+	for(int i=0; i<numInputs; i++)
+		inputSum[i] += inputs[i] * minutes;
+	for(int i=0; i<ATTIC_NODES; i++)
+		tempSum[i] += node_temps[i] * minutes;
+	cycleMinutes += minutes;
+
+	if(cycleMinutes < subStep && saturation < SATURATION_LIMIT)
+		return false;
+
+	// time averages over the moisture step
+	for(int i=0; i<numInputs; i++)
+		a[i] = inputSum[i] / cycleMinutes;
+	for(int i=0; i<ATTIC_NODES; i++)
+		temps[i] = tempSum[i] / cycleMinutes;
+	timeStep = cycleMinutes * dtau;
+	cycleMinutes = 0;
+
+	mass_cond_bal(temps, a[0], a[1], a[2], a[3], a[4], a[5], a[6], (int) (a[7] + .5), a[8], a[9], a[10],
+		a[11], a[12], a[13], a[14], a[15], a[16], a[17], a[18], a[19], a[20], a[21], a[22], a[23], a[24], a[25], a[26], a[27]);
+	return true;
+}
+
+/*
+ * setVaporPressure - sets the vapor pressure of an air node, used when the balance resumes after a period
+ *                    simulated by other means (the reduced order screening model)
+ * @param node - air node (6 = attic, 7 = return, 8 = supply, 9 = house)
+ * @param pw - vapor pressure (Pa)
+ */
+void Moisture::setVaporPressure(int node, double pw) {
+	PW[node] = pw;
+	PWOld[node] = pw;
+}
+
+/*
+ * getState - appends the state carried from one time step to the next, in units of about the same weight as 1 K
+ * @param state - returns the vapor pressures (hPa), moisture contents (% for wood, RH % for air) and condensed water (g)
+ */
+void Moisture::getState(vector<double>& state) {
+	for(int i=0; i<moisture_nodes; i++) {
+		state.push_back(PWOld[i] / 100);
+		state.push_back(moistureContent[i] * (i < 6 ? 100 : 1));
+		state.push_back(mTotal[i] * 1000);
+	}
+}
+
+/*
+ * setState - restarts the balance from a state from getState()
+ * @param state - the state
+ * @param first - index of the first moisture value in state
+ * @return index after the last moisture value
+ */
+int Moisture::setState(vector<double>& state, int first) {
+	for(int i=0; i<moisture_nodes; i++) {
+		PWOld[i] = PW[i] = max(state[first++] * 100, 0.0);
+		moistureContent[i] = state[first++] / (i < 6 ? 100 : 1);
+		mTotal[i] = max(state[first++] / 1000, 0.0);
+	}
+	return first;
+}
+
 void print_matrix(vector< vector<double> > A) {
     int n = A.size();
     for (int i=0; i<n; i++) {
@@ -420,11 +554,14 @@ void Moisture::cond_bal(int pressure) {
 	bool PWOutOfRange;									// flag for PW loop exit
 	int outIter;											// number of outer loop iterations
 	int inIter;												// number of inner loop iterations
-
-	// Calculate saturation vapor pressure for each node (moved from mass_cond_bal)
-	for(int i=0; i<moisture_nodes; i++) {
-		PWSaturation[i] = saturationVaporPressure(temperature[i]);
-		}
+	int stepCount = (int) (timeStep / dtau + .5);	// simulation steps in the time step
+
+	// Calculate saturation vapor pressure for each node (moved from mass_cond_bal), all the nodes in one call
+	saturationVaporPressures(moisture_nodes, temperature, PWSaturation);
+	// and the temperature factor of the wood sorption isotherm, which is the same for all the iterations
+	double woodFactor[6];
+	for(int i=0; i < 6; i++)
+		woodFactor[i] = sorptionFactor(temperature[i]);
 			
 //MASSTOOUT = 0
 	outIter = 0;
@@ -462,7 +599,7 @@ void Moisture::cond_bal(int pressure) {
 				// to exchange moisture rather than changing the moisture contant and use the PW/MC relationship
 				PW[0] = PWSaturation[0];
 				hasCondensedMass[0] = true;
-				saturated_minutes[0]++;
+				saturated_steps[0] += stepCount;
 				}
 
    		// NODE 1:
@@ -482,7 +619,7 @@ void Moisture::cond_bal(int pressure) {
 			else {
             PW[1] = PWSaturation[1];
 				hasCondensedMass[1] = true;
-				saturated_minutes[1]++;
+				saturated_steps[1] += stepCount;
 				}
 
    		// NODE 2:
@@ -496,7 +633,7 @@ void Moisture::cond_bal(int pressure) {
 			else {
             PW[2] = PWSaturation[2];
 				hasCondensedMass[2] = true;
-				saturated_minutes[2]++;
+				saturated_steps[2] += stepCount;
 				}
 
    		// NODE 3:
@@ -510,7 +647,7 @@ void Moisture::cond_bal(int pressure) {
 			else {
             PW[3] = PWSaturation[3];
 				hasCondensedMass[3] = true;
-				saturated_minutes[3]++;
+				saturated_steps[3] += stepCount;
 				}
 
    		// NODE 4:
@@ -524,7 +661,7 @@ void Moisture::cond_bal(int pressure) {
 			else {
             PW[4] = PWSaturation[4];
 				hasCondensedMass[4] = true;
-				saturated_minutes[4]++;
+				saturated_steps[4] += stepCount;
 				}
 
    		// NODE 5:
@@ -538,7 +675,7 @@ void Moisture::cond_bal(int pressure) {
 			else {
             PW[5] = PWSaturation[5];
 				hasCondensedMass[5] = true;
-				saturated_minutes[5]++;
+				saturated_steps[5] += stepCount;
 				}
 
 			// NODE 6: the attic node is treated differently as we do not have accumulating mass of moisture for the attic air - 
@@ -558,7 +695,7 @@ void Moisture::cond_bal(int pressure) {
 			else {
             PW[6] = PWSaturation[6];
 				hasCondensedMass[6] = true;
-				saturated_minutes[6]++;
+				saturated_steps[6] += stepCount;
 				}
 			
 			// Other air nodes - do we need to recalc PW? just fix PW at saturation for now as there is no place to put the moisture
@@ -567,7 +704,7 @@ void Moisture::cond_bal(int pressure) {
 				if(PW[i] > PWSaturation[i]) {
 				   //cout << "Air node " << i << " > saturation: " << PW[i] << "> " << PWSaturation[i] << endl;
             	//PW[i] = PWSaturation[i];
-				   saturated_minutes[i]++;
+				   saturated_steps[i] += stepCount;
             	}
             }
 
@@ -610,10 +747,10 @@ void Moisture::cond_bal(int pressure) {
 				for(int i=0; i < 3; i++) {
 					if(fluxTo[i] > 0) {
 						moistureContent[i] = moistureContent[i] + (fluxTo[i] / fluxTotal * massCondensed[6]) / density[i] / volume[i];
-						PW[i] = calc_vapor_pressure(moistureContent[i], temperature[i], pressure);
+						PW[i] = sorptionVaporPressure(moistureContent[i], woodFactor[i], pressure);
 						if(PW[i] > PWSaturation[i]) {
 							PW[i] = PWSaturation[i];
-							double mcSat = mc_cubic(PW[i], pressure, temperature[i]);
+							double mcSat = sorptionMoistureContent(PW[i], woodFactor[i], pressure);
 							mTotal[i] = mTotal[i] + (moistureContent[i] - mcSat) * volume[i] * density[i];
 							moistureContent[i] = mcSat;
 							}
@@ -631,8 +768,9 @@ void Moisture::cond_bal(int pressure) {
 
 		// Calculate MC's for wood nodes based on these new PW's
 		// this uses the inverse of cleary's relationship
+		sorptionMoistureContents(6, PW.data(), woodFactor, pressure, moistureContent);
 		for(int i=0; i < 6; i++) {
-			moistureContent[i] = max(mc_cubic(PW[i], pressure, temperature[i]), 0.032);
+			moistureContent[i] = max(moistureContent[i], 0.032);
 			if(hasCondensedMass[i]) {
 				switch (i) {
 				case 0:
@@ -670,7 +808,7 @@ void Moisture::cond_bal(int pressure) {
 					// even more -ve so an iterative scheme is not needed
 					double moistureReduction = mTotal[i] / (volume[i] * density[i]);
 					moistureContent[i] = max(moistureContent[i] + moistureReduction, 0.032);
-					PW[i] = calc_vapor_pressure(moistureContent[i], temperature[i], pressure);
+					PW[i] = sorptionVaporPressure(moistureContent[i], woodFactor[i], pressure);
 					redoMassBalance = true;	// Redo mass balance with this PW because this node is no longer at saturation. 
 													// this may become unnecessary at shorter time steps when the error due 
 													// to lost condensed mass not accounted for is small
@@ -686,15 +824,11 @@ void Moisture::cond_bal(int pressure) {
 		} while(redoMassBalance);
 		total_out_iter += outIter - 1;
 		total_in_iter += inIter - 1;
-}
-
-// humidity ratio constants (from Cleary 1985)
-static const double B3 =  15.8;		// was MCA
-static const double B4 = -0.0015;	// was MCB
-static const double B5 =  0.053;		// was MCC
-static const double B6 = -0.184;		// was MCD
-static const double B7 =  0.233;		// was MCE
 
+	saturation = 0;
+	for(int i=0; i<moisture_nodes; i++)
+		saturation = max(saturation, PW[i] / PWSaturation[i]);
+}
 
 /*
  * calc_kappa_1 - calculates kappa1: the partial of wood moisture content with respect to
@@ -707,7 +841,7 @@ static const double B7 =  0.233;		// was MCE
  */
 double Moisture::calc_kappa_1(int pressure, double temp, double mc, double mass) {
 	double k1;
-	k1 = 1 / (pressure / 0.622 * exp((temp - C_TO_K) / B3) * (B5 + 2 * B6 * mc + 3 * B7 * pow(mc,2)));
+	k1 = 1 / (pressure / 0.622 * sorptionFactor(temp) * sorptionSlope(mc));
 	k1 = mass * k1 / timeStep;
 	return (k1);
 }
@@ -721,44 +855,11 @@ double Moisture::calc_kappa_1(int pressure, double temp, double mc, double mass)
  */
 double Moisture::calc_kappa_2(double mc, double mass) {
 	double k2;
-	k2 = (B4 + B5 * mc + B6 * pow(mc,2) + B7 * pow(mc,3)) / (-B3 * (B5 + 2 * B6 * mc + 3 * B7 * pow(mc,2)));
+	k2 = sorptionHumidityRatio(mc, 1) / (-B3 * sorptionSlope(mc));
 	k2 = mass * k2 / timeStep;
 	return (k2);
 }
 
-/*
- * mc_cubic - cubic solver to get MC from PW
- * @param pw		 - vapor pressure
- * @param pressure - atmospheric pressure (Pa)
- * @param temp     - temperature (deg K)
- * @return mc		 - wood moisture content
- */
-double Moisture::mc_cubic(double pw, int pressure, double temp) {
-	double W = 0.622 * pw / (pressure - pw);
-	const double a1 = B6 / B7;
-	const double a2 = B5 / B7;
-	double a3 = (B4 - W / exp((temp - C_TO_K) / B3)) / B7;
-	double q = (3 * a2 - pow(a1, 2)) / 9;
-	double r = (9 * a1 * a2 - 27 * a3 - 2 * pow(a1, 3)) / 54;
-	double disc = pow(q, 3) + pow(r, 2);
-	double s = pow(r + pow(disc, 0.5), 1.0/3.0);
-	double t = -pow(abs(r - pow(disc,0.5)), 1.0/3.0);
-//cout << "mc_cubic in: pw=" << pw << " pressure=" << pressure << " temp=" << temp  << " out: " << s + t - a1 / 3 << endl;
-	return (s + t - a1 / 3);
-	}
-
-/*
- * calc_pw - calculates vapor pressure based on moisture content and temperature
- * @param mc		 - wood moisture content
- * @param temp     - temperature (deg K)
- * @param pressure - atmospheric pressure (Pa)
- * @return pw      - vapor pressure
- */
-double Moisture::calc_vapor_pressure(double mc, double temp, int pressure) {
-	double w = exp((temp - C_TO_K) / B3) * (B4 + B5 * mc + B6 * pow(mc, 2) + B7 * pow(mc, 3));
-	return (w * pressure / (0.622 * (1 + w / 0.622)));
-	}
-
 /*
  * calc_inter_temp - calculates the interior temperature of the roof sheathing
  * @param temp1		- roof sheathing interior surface temp
@@ -5,8 +5,8 @@
 
 using namespace std;
 
-const double timeStep = 60.;		// Timestep (1 minute)
 const int MOISTURE_NODES = 13;   // Max number of nodes
+const double SATURATION_LIMIT = 0.9;	// nodes above this fraction of saturation are solved every heat balance step
 
 class Moisture {
 	private:
@@ -19,18 +19,25 @@ class Moisture {
 		double x60, x30, x06, x03, x61, x41, x16, x14, x62, x52, x26, x25, x66, x6out;
 		double x67, x68, x69, x011, x110, x112, x121, x611, x116, x612, x126;
 		vector< vector<double> > A;
+		vector< vector<double> > work;						// copy of A the solver eliminates in, kept so it is not reallocated
+		double woodDiffusion[3];								// diffusion coefficient x area / gas constant of the sheathing and bulk wood (m3/sK)
+		double insDiffusion[2];									// the same for the south and north roof insulation
+		double airCapacity[MOISTURE_NODES];					// volume / gas constant of the air nodes (m3 kg/J)
+		int housePressure;										// pressure the house mass terms were found for (Pa)
+		double haHousePressure, massWHousePressure;		// haHouse and massWHouse over the pressure (kg/sPa, kg/Pa)
 		double PWOld[MOISTURE_NODES];							// previous time step vapor pressure (Pa)
       double PWInit[MOISTURE_NODES];						// initial vapor pressure (was B() in BASIC code) (Pa)
 		double tempOld[MOISTURE_NODES];						// previous time step temperature (deg K)
 		double haHouse;											// haHouse is the moisture transport coefficient of the house mass (kg/s)
 		double massWHouse;										// active mass of moisture in the house (kg)
 		double roofInsulRatio;									// ratio of exterior insulation U-val to sheathing U-val
+		double cycleMinutes;										// minutes of heat balance steps averaged so far
+		vector<double> inputSum;								// time integrals of the mass_cond_bal inputs (x minutes)
+		vector<double> tempSum;									// time integrals of the heat balance node temperatures (deg K x minutes)
 		
 		void cond_bal(int pressure);
 		double calc_kappa_1(int pressure, double temp, double mc, double mass);
 		double calc_kappa_2(double mc, double mass);
-      double mc_cubic(double pw, int pressure, double temp);
-      double calc_vapor_pressure(double mc, double temp, int pressure);
 		double calc_inter_temp(double temp1, double temp2, double insRatio);
 		
 	public:
@@ -38,8 +45,13 @@ class Moisture {
 		double moistureContent[MOISTURE_NODES];			// Node moisture content (%)
 		vector <double> PW;										// Node vapor pressure (Pa). vector so it can be passed to gauss()
 		double mTotal[MOISTURE_NODES];						// Node mass of condensed water (kg)
-		int saturated_minutes[MOISTURE_NODES];				// Number of minutes node vapor pressure is above saturation
+		int saturated_steps[MOISTURE_NODES];				// Number of STEP_SECONDS simulation steps node vapor pressure is above saturation
 		int total_in_iter, total_out_iter;				// Total number of inner and outer iterations
+		double timeStep;											// Time step (s), changed by the adaptive step control
+		int subStep;												// Moisture time step of sub_cycle() (minutes)
+		double saturation;										// Highest node vapor pressure as a fraction of saturation
+		double pwHold;												// ideal loads hold the house air at or below this vapor pressure, 0 for no limit (Pa)
+		double moistureRemoved;									// moisture taken out of the house air to hold it at pwHold in the last solution (kg/s)
 
 		Moisture(double atticVolume, double retDiameter, double retLength, double supDiameter, double supLength, double houseVolume,
 					 double floorArea, double sheathArea, double bulkArea, double roofInsThick, double roofExtRval, double mcInit=0.15);
@@ -49,6 +61,15 @@ class Moisture {
                double mAtticIn, double mAtticOut, double mCeiling, double mHouseIn, double mHouseOut,
                double mAH, double mRetAHoff, double mRetLeak, double mRetReg, double mRetOut, double mErvHouse,
                double mSupAHoff, double mSupLeak, double mSupReg, double latcap, double dhMoistRemv, double latload);
+		bool sub_cycle(double minutes, double* node_temps, double tempOut, double RHOut,
+               double airDensityOut, double airDensityAttic, double airDensityHouse, double airDensitySup, double airDensityRet,
+               int pressure, double hU0, double hU1, double hU2,
+               double mAtticIn, double mAtticOut, double mCeiling, double mHouseIn, double mHouseOut,
+               double mAH, double mRetAHoff, double mRetLeak, double mRetReg, double mRetOut, double mErvHouse,
+               double mSupAHoff, double mSupLeak, double mSupReg, double latcap, double dhMoistRemv, double latload);
+		void setVaporPressure(int node, double pw);
+		void getState(vector<double>& state);
+		int setState(vector<double>& state, int first);
 };
 
 void print_matrix(vector< vector<double> > A);
@@ -0,0 +1,224 @@
+#include <iostream>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "parareal.h"
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+/*
+* Parareal - Parareal class constructor
+* @param slices - number of slices, 0 for a serial run
+* @param iterations - most iterations to run
+* @param tolerance - largest jump allowed between fine slices in the state units (K etc.)
+* @param days - days in the run
+* @param recordStart - first day of the annual totals
+*/
+Parareal::Parareal(int slices, int iterations, double tolerance, int days, int recordStart) {
+	this->maxIterations = max(iterations, 1);
+	this->tolerance = tolerance;
+	this->recordStart = recordStart;
+	role = (slices > 0) ? PR_DRIVER : PR_SERIAL;
+	iteration = 0;
+	this->iterations = 0;
+	defect = 0;
+	shared = 0;
+	slice = 0;
+	fineSlices = 0;
+	failed = false;
+
+	// equal slices, with one starting with the annual totals
+	slices = max(1, min(slices, days));
+	for(int i=0; i <= slices; i++)
+		sliceStart.push_back((int) ((double) i * days / slices + 0.5));
+	if(recordStart > 0 && recordStart < days && find(sliceStart.begin(), sliceStart.end(), recordStart) == sliceStart.end()) {
+		sliceStart.push_back(recordStart);
+		sort(sliceStart.begin(), sliceStart.end());
+	}
+	this->slices = sliceStart.size() - 1;
+}
+
+/*
+* track - adds an annual total to add up over the fine slices
+* @param total - the total
+*/
+void Parareal::track(double* total) {
+	totals.push_back(total);
+	totalStart.push_back(0);
+}
+
+/*
+* track - adds an annual minute count to add up over the fine slices
+* @param count - the count
+*/
+void Parareal::track(long int* count) {
+	counts.push_back(count);
+	countStart.push_back(0);
+}
+
+/*
+* at - state at a slice start
+* @param array - coarse, fine or start
+* @param k - iteration
+* @param n - slice
+*/
+double* Parareal::at(double** array, int k, int n) {
+	return array[k % 2] + n * stateSize;
+}
+
+/*
+* run - runs the iterations, forking a sweep process for each
+* @param stateSize - size of the state vector
+* @return true in a sweep process, which goes on to run the simulation, false in the driver when the iterations are
+* done or a sweep failed
+*/
+bool Parareal::run(int stateSize) {
+	int points = slices + 1;
+	int sums = totals.size() + counts.size();
+	size_t size = (6 * points * stateSize + slices * sums) * sizeof(double);
+
+	this->stateSize = stateSize;
+	shared = (double*) mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, -1, 0);
+	if(shared == MAP_FAILED) {
+		failed = true;
+		return false;
+	}
+	for(int i=0; i < 2; i++) {
+		coarse[i] = shared + i * points * stateSize;
+		fine[i] = shared + (2 + i) * points * stateSize;
+		start[i] = shared + (4 + i) * points * stateSize;
+	}
+	sliceTotals = shared + 6 * points * stateSize;
+
+	for(iteration = 0; iteration < maxIterations; iteration++) {
+		int status;
+		cout << flush;
+		pid_t pid = fork();
+		if(pid == 0) {
+			role = PR_SWEEP;
+			return true;
+		}
+		if(pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			failed = true;
+			return false;
+		}
+		iterations = iteration + 1;
+
+		// the fine slices join up when each starts where the one before ended
+		defect = 0;
+		for(int n=1; n < slices; n++) {
+			double* f = at(fine, iteration, n);
+			double* u = at(start, iteration, n);
+			for(int i=0; i < stateSize; i++)
+				defect = max(defect, abs(f[i] - u[i]));
+		}
+		cout << "Parareal iteration " << iteration << ": largest jump between slices " << defect << endl;
+		if(defect <= tolerance)
+			break;
+	}
+	return false;
+}
+
+/*
+* boundary - called by the sweep and fine processes at the start of every day
+* At a slice start the sweep keeps its coarse state, corrects it from the last iteration and forks the fine process
+* for the slice. A fine process reaching the end of its slice keeps its state and totals and exits.
+* @param day - day of the run from 0
+* @param state - state at the start of the day, returns the corrected state
+* @return pararealBoundary, the state has to be set from state unless PB_NONE
+*/
+int Parareal::boundary(int day, vector<double>& state) {
+	if(role == PR_FINE) {
+		if(day == sliceStart[slice + 1])
+			endSlice(state);
+		return PB_NONE;
+	}
+	if(role != PR_SWEEP)
+		return PB_NONE;
+
+	int n = find(sliceStart.begin(), sliceStart.end() - 1, day) - sliceStart.begin();
+	if(n == slices)
+		return PB_NONE;
+
+	int result = PB_NONE;
+	copy(state.begin(), state.end(), at(coarse, iteration, n));
+	if(iteration > 0 && n > 0) {
+		double* f = at(fine, iteration - 1, n);
+		double* g = at(coarse, iteration - 1, n);
+		for(int i=0; i < stateSize; i++)
+			state[i] += f[i] - g[i];
+		result = PB_CORRECTED;
+	}
+	copy(state.begin(), state.end(), at(start, iteration, n));
+
+	cout << flush;
+	pid_t pid = fork();
+	if(pid == 0) {
+		role = PR_FINE;
+		slice = n;
+		for(size_t i=0; i < totals.size(); i++)
+			totalStart[i] = *totals[i];
+		for(size_t i=0; i < counts.size(); i++)
+			countStart[i] = *counts[i];
+		return PB_FORKED;
+	}
+	if(pid < 0)
+		_exit(1);
+	fineSlices++;
+	return result;
+}
+
+/*
+* endSlice - keeps the state and totals at the end of a fine slice and ends the process
+* @param state - state at the end of the slice
+*/
+void Parareal::endSlice(vector<double>& state) {
+	double* sums = sliceTotals + slice * (totals.size() + counts.size());
+
+	copy(state.begin(), state.end(), at(fine, iteration, slice + 1));
+	for(size_t i=0; i < totals.size(); i++)
+		sums[i] = *totals[i] - totalStart[i];
+	for(size_t i=0; i < counts.size(); i++)
+		sums[totals.size() + i] = *counts[i] - countStart[i];
+	_exit(0);
+}
+
+/*
+* finish - called by the sweep and fine processes at the end of the run, the sweep waits for its fine processes
+* @param state - state at the end of the run
+*/
+void Parareal::finish(vector<double>& state) {
+	int status;
+	bool ok = true;
+
+	if(role == PR_FINE)
+		endSlice(state);
+	for(int i=0; i < fineSlices; i++) {
+		if(wait(&status) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			ok = false;
+	}
+	_exit(ok ? 0 : 1);
+}
+
+/*
+* results - sets the annual totals and counts to their sums over the fine slices of the last iteration
+*/
+void Parareal::results() {
+	for(size_t i=0; i < totals.size(); i++)
+		*totals[i] = 0;
+	for(size_t i=0; i < counts.size(); i++)
+		*counts[i] = 0;
+	for(int n=0; n < slices; n++) {
+		if(sliceStart[n] < recordStart)
+			continue;
+		double* sums = sliceTotals + n * (totals.size() + counts.size());
+		for(size_t i=0; i < totals.size(); i++)
+			*totals[i] += sums[i];
+		for(size_t i=0; i < counts.size(); i++)
+			*counts[i] += (long int) (sums[totals.size() + i] + 0.5);
+	}
+}
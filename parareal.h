@@ -0,0 +1,77 @@
+#pragma once
+#ifndef parareal_h
+#define parareal_h
+#include <vector>
+
+using namespace std;
+
+const double PARAREAL_COARSE_TOLERANCE = 1e30;		// step tolerance of the coarse sweep, which takes the longest steps allowed
+
+// What the process running the simulation loop is doing
+enum pararealRole {
+	PR_SERIAL = 0,		// the whole simulation, no Parareal
+	PR_DRIVER,			// starts a sweep for each iteration and adds up the slices in the end, runs no simulation itself
+	PR_SWEEP,			// coarse sweep over all the days, starting a fine process for each slice
+	PR_FINE				// fine simulation of one slice
+};
+
+// Result of Parareal::boundary() for the process that called it
+enum pararealBoundary {
+	PB_NONE = 0,		// carry on
+	PB_CORRECTED,		// the sweep corrected the state, it has to be set from the state vector
+	PB_FORKED			// this is a new fine process for the slice starting here, it has to reopen its input files
+};
+
+/*
+* Parareal
+*
+* Parallel in time simulation of a single run. The days of the run are split into slices. Each iteration a coarse sweep
+* (long time steps) runs over all the days, and at the start of each slice forks a process that simulates the slice
+* with the fine time step from the state the sweep has there. From the second iteration on the sweep corrects the
+* state at each slice start by the difference between the fine and coarse results of the slice before in the last
+* iteration, U(k, n) = G(U(k, n-1)) + F(U(k-1, n-1)) - G(U(k-1, n-1)). The iterations stop when the fine slices join up,
+* each starting within the tolerance of where the fine slice before ended, and the annual totals are the sums over
+* the fine slices.
+* The state corrected is the slowly changing part of the simulation (node temperatures, moisture, mold and dose), the
+* processes are forked so everything else is carried over from the sweep as it is.
+*/
+class Parareal {
+	private:
+		int slices;
+		int maxIterations;
+		double tolerance;
+		int recordStart;								// first day of the annual totals, slices before are warmup
+		vector<int> sliceStart;						// first day of each slice, and the number of days at the end
+		int stateSize;
+		double* shared;								// memory shared by all the processes
+		double* coarse[2];							// coarse state arriving at each slice start, by iteration parity
+		double* fine[2];								// fine state at the end of each slice, by the start of the next slice
+		double* start[2];								// corrected state at each slice start
+		double* sliceTotals;							// what each fine slice added to the totals and counts
+		vector<double*> totals;
+		vector<long int*> counts;
+		vector<double> totalStart;
+		vector<long int> countStart;
+		int slice;										// slice of a fine process
+		int fineSlices;								// fine processes started by a sweep
+
+		double* at(double** array, int k, int n);
+		void endSlice(vector<double>& state);
+
+	public:
+		int role;
+		int iteration;
+		int iterations;								// iterations run
+		double defect;									// largest jump between fine slices in the last iteration
+		bool failed;									// a sweep or fine process failed
+
+		Parareal(int slices, int iterations, double tolerance, int days, int recordStart);
+		void track(double* total);
+		void track(long int* count);
+		bool run(int stateSize);
+		int boundary(int day, vector<double>& state);
+		void finish(vector<double>& state);
+		void results();
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "powerlaw.h"
+#include "vecmath.h"
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+const double LOG_ZERO = -1e300;	// log of a closed element
+
+#ifdef __AVX__
+const bool POWER_LAW_VECTORS = true;
+#else
+const bool POWER_LAW_VECTORS = false;
+#endif
+
+/*
+* powerLawFlows - flows through orifices, m = C|dP|^n into the zone for +ve dP and out of it (-ve) for -ve dP
+* @param count - number of elements
+* @param dP - pressure difference across each element (Pa)
+* @param n - pressure exponent
+* @param CIn - coefficient for flow into the zone
+* @param COut - coefficient for flow out of the zone
+* @param logCIn - logCoefficient() of CIn
+* @param logCOut - logCoefficient() of COut
+* @param m - returns the flows (kg/s)
+* @param dmdP - returns the derivatives of the flows with respect to dP (kg/s/Pa), 0 where dP = 0
+*/
+void powerLawFlows(int count, const double* dP, const double* n, const double* CIn, const double* COut,
+	const double* logCIn, const double* logCOut, double* m, double* dmdP) {
+	if(!POWER_LAW_VECTORS) {
+		for(int e=0; e < count; e++) {
+			if(dP[e] >= 0)
+				m[e] = CIn[e] * pow(dP[e], n[e]);
+			else
+				m[e] = -COut[e] * pow(-dP[e], n[e]);
+			dmdP[e] = (dP[e] != 0) ? n[e] * m[e] / dP[e] : 0;
+		}
+		return;
+	}
+
+	vdouble zero = {0};
+
+	for(int e=0; e < count; e += VEC_LANES) {
+		int left = count - e;
+		vdouble x = load(dP + e, left, 1);
+		vdouble exponent = load(n + e, left, 0);
+		vdouble inflow = (x >= 0) ? load(logCIn + e, left, 0) : load(logCOut + e, left, 0);
+		vdouble magnitude = vexp(inflow + exponent * vlog((x >= 0) ? x : -x));
+		vdouble flow = (x == 0) ? zero : ((x > 0) ? magnitude : -magnitude);
+
+		store(m + e, left, flow);
+		store(dmdP + e, left, (x == 0) ? zero : exponent * flow / x);
+	}
+}
+
+/*
+* powerLaw - |x|^n
+* @param count - number of values
+* @param x - values
+* @param n - powers
+* @param y - returns |x|^n, 0 where x = 0
+*/
+void powerLaw(int count, const double* x, const double* n, double* y) {
+	if(!POWER_LAW_VECTORS) {
+		for(int i=0; i < count; i++)
+			y[i] = pow(abs(x[i]), n[i]);
+		return;
+	}
+
+	vdouble zero = {0};
+
+	for(int i=0; i < count; i += VEC_LANES) {
+		int left = count - i;
+		vdouble a = load(x + i, left, 1);
+		vdouble p = vexp(load(n + i, left, 0) * vlog((a >= 0) ? a : -a));
+		store(y + i, left, (a == 0) ? zero : p);
+	}
+}
+
+/*
+* logCoefficient - log of a flow coefficient
+* @param C - coefficient, >= 0
+* @return log(C), or a large -ve number for C = 0 so the flow is 0
+*/
+double logCoefficient(double C) {
+	return (C > 0) ? log(C) : LOG_ZERO;
+}
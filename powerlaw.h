@@ -0,0 +1,30 @@
+#pragma once
+#ifndef powerlaw_h
+#define powerlaw_h
+
+/*
+* Power law kernels
+*
+* Flow through the leakage elements of the airflow network, m = C|dP|^n with the sign of dP, for a whole run of
+* elements at a time. Each power is evaluated as exp(log C + n log|dP|) with the log of the coefficient worked out
+* once per solve, and the exp and log are written on short vectors of doubles (GCC/clang vector extensions) so a
+* number of elements are done in each pass instead of one libm pow() call per element. They agree with pow() to
+* about 1e-14 (test_powerlaw.cpp). The exp and log are in vecmath.h.
+* The vectors only pay with 4 doubles to a vector (AVX, make NATIVE=1). With the 2 of a portable build they are slower
+* than glibc pow(), so the portable kernels call pow() per element the way the network did before, and give the same
+* flows to the last bit.
+*/
+
+extern const bool POWER_LAW_VECTORS;	// the kernels run on vectors, otherwise they call pow()
+
+// Orifices: signed flow and its derivative
+void powerLawFlows(int count, const double* dP, const double* n, const double* CIn, const double* COut,
+	const double* logCIn, const double* logCOut, double* m, double* dmdP);
+
+// |x|^n, 0 where x = 0 (the ends of cracks)
+void powerLaw(int count, const double* x, const double* n, double* y);
+
+// log of a flow coefficient for powerLawFlows, closed elements (C = 0) give no flow
+double logCoefficient(double C);
+
+#endif
@@ -0,0 +1,336 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "repdays.h"
+#include "weather.h"
+#include "gauss.h"
+#include "constants.h"
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+const int DAYS = 365;
+const int FEATURES = 6;						// mean, maximum and minimum temperature, solar, humidity ratio, wind
+const double BALANCE_TEMP = 18.3;		// base temperature of the heating and cooling degree days of the error estimate (deg C)
+
+/*
+* RepresentativeDays - RepresentativeDays class constructor, every day is simulated until select() is called
+*/
+RepresentativeDays::RepresentativeDays() {
+	weight.assign(DAYS, 1);
+	simulate.assign(DAYS, true);
+	dayEnergy.assign(DAYS, 0);
+	representedDays = DAYS;
+	simulatedDays = DAYS;
+}
+
+/*
+* readFeatures - reads the weather year and keeps the daily features
+* @param fileName - weather file
+* @param terrain - terrain class of the site, for the local wind speed
+* @param eaveHeight - eave height (m), for the local wind speed
+*/
+void RepresentativeDays::readFeatures(string fileName, int terrain, double eaveHeight) {
+	Weather weather(terrain, eaveHeight);
+
+	weather.open(fileName);
+	features.assign(DAYS, vector<double>(FEATURES, 0));
+	for(int d=0; d < DAYS; d++) {
+		vector<double>& f = features[d];
+		f[1] = -1e6;
+		f[2] = 1e6;
+		for(int hour=0; hour < 24; hour++) {
+			for(int minute=0; minute < 60; minute++) {
+				weatherData w = weather.readMinute(minute);
+				double t = w.dryBulb - C_TO_K;
+				f[0] += t / 1440;
+				f[1] = max(f[1], t);
+				f[2] = min(f[2], t);
+				f[3] += w.globalHorizontal / 60000.0;		// kWh/m2
+				f[4] += w.humidityRatio / 1440;
+				f[5] += w.windSpeedLocal / 1440;
+			}
+			weather.nextHour();
+		}
+	}
+	weather.close();
+}
+
+/*
+* select - clusters the days of the weather year and picks the days to simulate
+* The features are scaled to unit variance and clustered by k-means, started from the day nearest the mean and then
+* each time the day furthest from the days already picked so the result does not depend on a random start.
+* @param fileName - weather file
+* @param terrain - terrain class of the site, for the local wind speed
+* @param eaveHeight - eave height (m), for the local wind speed
+* @param clusters - number of representative days, besides the coldest and hottest days
+* @param warmupDays - days simulated before each representative day
+*/
+void RepresentativeDays::select(string fileName, int terrain, double eaveHeight, int clusters, int warmupDays) {
+	vector< vector<double> > x(DAYS, vector<double>(FEATURES));
+	vector<double> mean(FEATURES, 0), sd(FEATURES, 0);
+	vector<int> extreme, members;
+	vector<bool> clustered(DAYS, true);
+
+	readFeatures(fileName, terrain, eaveHeight);
+
+	// coldest and hottest days are design days of their own
+	int coldest = 0, hottest = 0;
+	for(int d=1; d < DAYS; d++) {
+		if(features[d][2] < features[coldest][2])
+			coldest = d;
+		if(features[d][1] > features[hottest][1])
+			hottest = d;
+	}
+	extreme.push_back(coldest);
+	if(hottest != coldest)
+		extreme.push_back(hottest);
+	for(size_t i=0; i < extreme.size(); i++)
+		clustered[extreme[i]] = false;
+	for(int d=0; d < DAYS; d++) {
+		if(clustered[d])
+			members.push_back(d);
+	}
+	clusters = max(1, min(clusters, (int) members.size()));
+
+	// scaled features
+	for(int d=0; d < DAYS; d++) {
+		for(int k=0; k < FEATURES; k++)
+			mean[k] += features[d][k] / DAYS;
+	}
+	for(int d=0; d < DAYS; d++) {
+		for(int k=0; k < FEATURES; k++)
+			sd[k] += pow(features[d][k] - mean[k], 2) / DAYS;
+	}
+	for(int k=0; k < FEATURES; k++)
+		sd[k] = (sd[k] > 0) ? sqrt(sd[k]) : 1;
+	for(int d=0; d < DAYS; d++) {
+		for(int k=0; k < FEATURES; k++)
+			x[d][k] = (features[d][k] - mean[k]) / sd[k];
+	}
+
+	// farthest point start
+	vector< vector<double> > centre;
+	vector<double> nearest(DAYS, 1e30);
+	int first = members[0];
+	double firstDistance = 1e30;
+	for(size_t i=0; i < members.size(); i++) {
+		double r = 0;
+		for(int k=0; k < FEATURES; k++)
+			r += x[members[i]][k] * x[members[i]][k];
+		if(r < firstDistance) {
+			firstDistance = r;
+			first = members[i];
+		}
+	}
+	centre.push_back(x[first]);
+	while((int) centre.size() < clusters) {
+		int far = members[0];
+		double farDistance = -1;
+		for(size_t i=0; i < members.size(); i++) {
+			int d = members[i];
+			double r = 0;
+			for(int k=0; k < FEATURES; k++)
+				r += pow(x[d][k] - centre.back()[k], 2);
+			nearest[d] = (centre.size() == 1) ? r : min(nearest[d], r);
+			if(nearest[d] > farDistance) {
+				farDistance = nearest[d];
+				far = d;
+			}
+		}
+		centre.push_back(x[far]);
+	}
+
+	// k-means
+	vector<int> group(DAYS, -1);
+	for(int iteration=0; iteration < 100; iteration++) {
+		bool changed = false;
+		for(size_t i=0; i < members.size(); i++) {
+			int d = members[i];
+			int best = 0;
+			double bestDistance = 1e30;
+			for(int c=0; c < clusters; c++) {
+				double r = 0;
+				for(int k=0; k < FEATURES; k++)
+					r += pow(x[d][k] - centre[c][k], 2);
+				if(r < bestDistance) {
+					bestDistance = r;
+					best = c;
+				}
+			}
+			if(group[d] != best) {
+				group[d] = best;
+				changed = true;
+			}
+		}
+		if(!changed)
+			break;
+		vector<int> size(clusters, 0);
+		for(int c=0; c < clusters; c++)
+			centre[c].assign(FEATURES, 0);
+		for(size_t i=0; i < members.size(); i++) {
+			int d = members[i];
+			size[group[d]]++;
+			for(int k=0; k < FEATURES; k++)
+				centre[group[d]][k] += x[d][k];
+		}
+		for(int c=0; c < clusters; c++) {
+			for(int k=0; k < FEATURES; k++)
+				centre[c][k] = (size[c] > 0) ? centre[c][k] / size[c] : 1e30;		// an emptied cluster attracts no more days
+		}
+	}
+
+	// the day nearest each centre represents its cluster
+	vector<int> medoid(clusters, -1);
+	vector<double> medoidDistance(clusters, 1e30);
+	for(size_t i=0; i < members.size(); i++) {
+		int d = members[i];
+		double r = 0;
+		for(int k=0; k < FEATURES; k++)
+			r += pow(x[d][k] - centre[group[d]][k], 2);
+		if(r < medoidDistance[group[d]]) {
+			medoidDistance[group[d]] = r;
+			medoid[group[d]] = d;
+		}
+	}
+
+	weight.assign(DAYS, 0);
+	simulate.assign(DAYS, false);
+	for(size_t i=0; i < members.size(); i++) {
+		int d = members[i];
+		weight[medoid[group[d]]]++;
+	}
+	for(size_t i=0; i < extreme.size(); i++)
+		weight[extreme[i]] = 1;
+	representedDays = 0;
+	simulatedDays = 0;
+	for(int d=0; d < DAYS; d++) {
+		if(weight[d] > 0) {
+			representedDays++;
+			for(int w = max(0, d - warmupDays); w <= d; w++)
+				simulate[w] = true;
+		}
+	}
+	for(int d=0; d < DAYS; d++)
+		simulatedDays += simulate[d];
+}
+
+/*
+* track - adds an annual total to reweight
+* @param total - the total, added up every simulated minute
+* @param kWhFactor - kWh per unit of the total if it is part of the energy use, 0 otherwise
+*/
+void RepresentativeDays::track(double* total, double kWhFactor) {
+	totals.push_back(total);
+	totalStart.push_back(0);
+	energyFactor.push_back(kWhFactor);
+}
+
+/*
+* track - adds an annual minute count to reweight
+* @param count - the count
+*/
+void RepresentativeDays::track(long int* count) {
+	counts.push_back(count);
+	countStart.push_back(0);
+}
+
+/*
+* simulated - whether a day is simulated
+* @param day - day of the year (1 - 365)
+* @return false for days that only keep the weather and schedules in step
+*/
+bool RepresentativeDays::simulated(int day) {
+	return simulate[day - 1];
+}
+
+/*
+* beginDay - keeps the totals at the start of a simulated day
+*/
+void RepresentativeDays::beginDay() {
+	for(size_t i=0; i < totals.size(); i++)
+		totalStart[i] = *totals[i];
+	for(size_t i=0; i < counts.size(); i++)
+		countStart[i] = *counts[i];
+}
+
+/*
+* endDay - counts what the day added to the totals for all the days it represents
+* @param day - day of the year (1 - 365)
+*/
+void RepresentativeDays::endDay(int day) {
+	int w = weight[day - 1];
+
+	dayEnergy[day - 1] = 0;
+	for(size_t i=0; i < totals.size(); i++) {
+		double added = *totals[i] - totalStart[i];
+		dayEnergy[day - 1] += energyFactor[i] * added;
+		*totals[i] += (w - 1) * added;
+	}
+	for(size_t i=0; i < counts.size(); i++)
+		*counts[i] += (w - 1) * (*counts[i] - countStart[i]);
+}
+
+/*
+* energyError - estimated error of the annual energy use from simulating only the representative days
+* The daily energy of the representative days is regressed on heating and cooling degree days and solar. The
+* regression summed over the year less its sum over the representative days with their weights is the error from the
+* clusters not following the weather, and the scatter about the regression is the error from the days of a cluster
+* differing from the day that represents it, which adds up to the variance of n(n - 1) days for a cluster of n days.
+* @return one standard deviation of the error (kWh)
+*/
+double RepresentativeDays::energyError() {
+	const int P = 4;
+	vector< vector<double> > A(P, vector<double>(P + 1, 0));
+	vector<double> scale(P), f(P);
+	int samples = 0;
+
+	if(features.empty())
+		return 0;
+
+	vector< vector<double> > g(DAYS, vector<double>(P));
+	for(int d=0; d < DAYS; d++) {
+		g[d][0] = 1;
+		g[d][1] = max(BALANCE_TEMP - features[d][0], 0.0);
+		g[d][2] = max(features[d][0] - BALANCE_TEMP, 0.0);
+		g[d][3] = features[d][3];
+	}
+	for(int d=0; d < DAYS; d++) {
+		if(weight[d] == 0)
+			continue;
+		samples++;
+		for(int i=0; i < P; i++) {
+			for(int j=0; j < P; j++)
+				A[i][j] += g[d][i] * g[d][j];
+			A[i][P] += g[d][i] * dayEnergy[d];
+		}
+	}
+	for(int i=0; i < P; i++)
+		scale[i] = (A[i][i] > 0) ? 1 / sqrt(A[i][i]) : 0;
+	for(int i=0; i < P; i++) {
+		for(int j=0; j < P; j++)
+			A[i][j] *= scale[i] * scale[j];
+		A[i][i] += 1e-9;						// degree days that are zero on every representative day
+		A[i][P] *= scale[i];
+	}
+	vector<double> coef = gauss(A);
+	for(int i=0; i < P; i++)
+		coef[i] *= scale[i];
+
+	double bias = 0, residual = 0, pairs = 0;
+	for(int d=0; d < DAYS; d++) {
+		double fit = 0;
+		for(int i=0; i < P; i++)
+			fit += coef[i] * g[d][i];
+		bias += fit - weight[d] * fit;
+		if(weight[d] > 0) {
+			residual += pow(dayEnergy[d] - fit, 2);
+			pairs += weight[d] * (weight[d] - 1.0);
+		}
+	}
+	double variance = (samples > P) ? residual / (samples - P) * pairs : 0;
+	return sqrt(bias * bias + variance);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#ifndef repdays_h
+#define repdays_h
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/*
+* RepresentativeDays
+*
+* Fast annual estimates from a few simulated days. The days of the weather year are clustered on their daily weather
+* (mean, maximum and minimum temperature, solar, humidity and wind) and the day nearest the centre of each cluster is
+* simulated for all the days in its cluster. The coldest and hottest days are kept as days of their own. Each
+* representative day is preceded by a few simulated warmup days so the house starts it from a state that fits the
+* weather, the other days only keep the weather and schedules in step.
+* The annual totals the simulation adds up are reweighted at the end of every simulated day: a representative day
+* counts for its cluster and a warmup day not at all.
+*/
+class RepresentativeDays {
+	private:
+		vector< vector<double> > features;		// daily weather features, one row per day
+		vector<int> weight;							// days represented by each day of the year, 0 for days not represented
+		vector<bool> simulate;						// representative days and their warmup days
+		vector<double> dayEnergy;					// simulated energy of each representative day (kWh)
+		vector<double*> totals;						// annual totals reweighted at the end of each simulated day
+		vector<double> totalStart;
+		vector<double> energyFactor;				// kWh per unit of each total, 0 for totals that are not energy
+		vector<long int*> counts;					// annual minute counts reweighted at the end of each simulated day
+		vector<long int> countStart;
+
+		void readFeatures(string fileName, int terrain, double eaveHeight);
+
+	public:
+		int representedDays;							// days simulated for their cluster
+		int simulatedDays;							// representative and warmup days
+
+		RepresentativeDays();
+		void select(string fileName, int terrain, double eaveHeight, int clusters, int warmupDays);
+		void track(double* total, double kWhFactor = 0);
+		void track(long int* count);
+		bool simulated(int day);
+		void beginDay();
+		void endDay(int day);
+		double energyError();
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "sorption.h"
+#include "constants.h"
+#include "vecmath.h"
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+// the isotherm divided by B7 is the monic cubic mc^3 + a1 mc^2 + a2 mc + a3, a3 = (B4 - W / f) / B7
+const double a1 = B6 / B7;
+const double a2 = B5 / B7;
+const double q = (3 * a2 - a1 * a1) / 9;			// > 0 so the cubic has one real root
+const double q3 = q * q * q;
+const double r0 = (9 * a1 * a2 - 2 * a1 * a1 * a1) / 54;	// r = r0 - a3 / 2
+
+/*
+* sorptionFactor - temperature factor of the isotherm
+* @param temp - temperature (deg K)
+* @return exp((temp - C_TO_K) / B3)
+*/
+double sorptionFactor(double temp) {
+	return exp((temp - C_TO_K) / B3);
+}
+
+/*
+* sorptionHumidityRatio - humidity ratio in equilibrium with the wood
+* @param mc - wood moisture content
+* @param factor - sorptionFactor() of the wood temperature
+* @return humidity ratio (kg/kg)
+*/
+double sorptionHumidityRatio(double mc, double factor) {
+	return factor * (B4 + B5 * mc + B6 * mc * mc + B7 * mc * mc * mc);
+}
+
+/*
+* sorptionSlope - derivative of the isotherm with respect to mc, without the temperature factor
+* @param mc - wood moisture content
+* @return B5 + 2 B6 mc + 3 B7 mc^2
+*/
+double sorptionSlope(double mc) {
+	return B5 + 2 * B6 * mc + 3 * B7 * mc * mc;
+}
+
+/*
+* sorptionVaporPressure - vapor pressure in equilibrium with the wood
+* @param mc - wood moisture content
+* @param factor - sorptionFactor() of the wood temperature
+* @param pressure - atmospheric pressure (Pa)
+* @return vapor pressure (Pa)
+*/
+double sorptionVaporPressure(double mc, double factor, double pressure) {
+	double w = sorptionHumidityRatio(mc, factor);
+	return (w * pressure / (0.622 * (1 + w / 0.622)));
+}
+
+/*
+* sorptionMoistureContent - inverse of the isotherm, the real root of the cubic by Cardano's formula
+* @param pw - vapor pressure (Pa)
+* @param factor - sorptionFactor() of the wood temperature
+* @param pressure - atmospheric pressure (Pa)
+* @return wood moisture content
+*/
+double sorptionMoistureContent(double pw, double factor, double pressure) {
+	double W = 0.622 * pw / (pressure - pw);
+	double r = r0 - (B4 - W / factor) / B7 / 2;
+	double root = sqrt(q3 + r * r);		// > |r|
+	return cbrt(r + root) - cbrt(root - r) - a1 / 3;
+}
+
+/*
+* sorptionMoistureContents - sorptionMoistureContent for a table of nodes, the cube roots are exp(log(x) / 3) on
+* vectors, which agree with the scalar function to within 1e-14 of moisture content (test_sorption.cpp)
+* @param count - number of nodes
+* @param pw - vapor pressures (Pa)
+* @param factor - sorptionFactor() of the node temperatures
+* @param pressure - atmospheric pressure (Pa)
+* @param mc - returns the wood moisture contents
+*/
+void sorptionMoistureContents(int count, const double* pw, const double* factor, double pressure, double* mc) {
+	for(int i=0; i < count; i += VEC_LANES) {
+		int left = count - i;
+		vdouble p = load(pw + i, left, 0);
+		vdouble W = 0.622 * p / (pressure - p);
+		vdouble r = r0 - (B4 - W / load(factor + i, left, 1)) / B7 / 2;
+		vdouble root = r * r + q3;
+		for(int k=0; k < VEC_LANES; k++)
+			root[k] = sqrt(root[k]);
+		store(mc + i, left, vexp(vlog(r + root) / 3) - vexp(vlog(root - r) / 3) - a1 / 3);
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef sorption_h
+#define sorption_h
+
+/*
+* Sorption isotherm of the wood nodes (Cleary 1985)
+*
+* The humidity ratio of air in equilibrium with wood of moisture content mc at temperature T is
+* W = f(T) * (B4 + B5 mc + B6 mc^2 + B7 mc^3) with f(T) = exp((T - C_TO_K) / B3). f only depends on the node
+* temperature, so it is found once with sorptionFactor() and passed to the rest, which are then only arithmetic, a
+* square root and cube roots. sorptionMoistureContents() inverts the isotherm for a table of nodes on vectors of
+* doubles (vecmath.h).
+*/
+
+// humidity ratio constants (from Cleary 1985)
+const double B3 =  15.8;		// was MCA
+const double B4 = -0.0015;	// was MCB
+const double B5 =  0.053;		// was MCC
+const double B6 = -0.184;		// was MCD
+const double B7 =  0.233;		// was MCE
+
+double sorptionFactor(double temp);
+double sorptionHumidityRatio(double mc, double factor);
+double sorptionSlope(double mc);
+double sorptionVaporPressure(double mc, double factor, double pressure);
+double sorptionMoistureContent(double pw, double factor, double pressure);
+void sorptionMoistureContents(int count, const double* pw, const double* factor, double pressure, double* mc);
+
+#endif
@@ -0,0 +1,262 @@
+#include "surrogate.h"
+#include "gauss.h"
+#include <algorithm>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+const int STATE_FEATURES = 21;
+const int FLOW_FEATURES = 10;
+const double RIDGE = 1e-9;				// regularization of the scaled normal equations for features that barely vary
+const double STATE_MARGIN[RS_STATES] = { 5, 5, 5, 0.002, 0.002 };	// how far the states are trusted outside the range seen in training
+
+/*
+* Surrogate - Surrogate class constructor
+*/
+Surrogate::Surrogate() {
+	stateNormal.assign(STATE_FEATURES, vector<double>(STATE_FEATURES + RS_STATES, 0));
+	flowNormal.assign(FLOW_FEATURES, vector<double>(FLOW_FEATURES + RF_FLOWS, 0));
+	for(int i=0; i < RS_STATES; i++)
+		errorSum[i] = 0;
+	flowMin.assign(RF_FLOWS, 0);
+	flowMax.assign(RF_FLOWS, 0);
+	stateMin.assign(RS_STATES, 0);
+	stateMax.assign(RS_STATES, 0);
+	fitted = false;
+	trainingDays = 0;
+	reducedDays = 0;
+	fallbackDays = 0;
+	validationMinutes = 0;
+}
+
+/*
+* stateFeatures - terms the change of the states in a minute is linear in
+* Temperatures are differences so the conductances are fitted directly, the airflow terms carry heat and moisture
+* between the zones and outside.
+* @param state - state at the start of the minute
+* @param input - inputs of the minute
+* @param flow - airflows of the minute
+* @param f - returns the features
+*/
+void Surrogate::stateFeatures(double* state, double* input, double* flow, vector<double>& f) {
+	double tOut = input[RI_TOUT];
+	double hrOut = input[RI_HROUT];
+
+	f.resize(STATE_FEATURES);
+	f[0] = 1;
+	f[1] = state[RS_ATTIC] - tOut;
+	f[2] = state[RS_HOUSE] - tOut;
+	f[3] = state[RS_MASS] - state[RS_HOUSE];
+	f[4] = state[RS_ATTIC] - state[RS_HOUSE];
+	f[5] = input[RI_ROOFSOLAR];
+	f[6] = input[RI_SOLGAIN];
+	f[7] = input[RI_SENSIBLE];
+	f[8] = input[RI_LATENT];
+	f[9] = input[RI_GAINS];
+	f[10] = flow[RF_HOUSEIN] * (tOut - state[RS_HOUSE]);
+	f[11] = flow[RF_CEILING] * (state[RS_ATTIC] - state[RS_HOUSE]);
+	f[12] = flow[RF_ATTICIN] * (tOut - state[RS_ATTIC]);
+	f[13] = input[RI_WIND] * (tOut - state[RS_ATTIC]);
+	f[14] = input[RI_AH] * (state[RS_ATTIC] - state[RS_HOUSE]);
+	f[15] = state[RS_HRATTIC] - hrOut;
+	f[16] = state[RS_HRHOUSE] - hrOut;
+	f[17] = state[RS_HRHOUSE] - state[RS_HRATTIC];
+	f[18] = flow[RF_HOUSEIN] * (hrOut - state[RS_HRHOUSE]);
+	f[19] = flow[RF_CEILING] * (state[RS_HRATTIC] - state[RS_HRHOUSE]);
+	f[20] = flow[RF_ATTICIN] * (hrOut - state[RS_HRATTIC]);
+}
+
+/*
+* flowFeatures - terms the lumped airflows are linear in: stack and wind drivers and the fan flows
+* @param state - state at the start of the minute
+* @param input - inputs of the minute
+* @param f - returns the features
+*/
+void Surrogate::flowFeatures(double* state, double* input, vector<double>& f) {
+	double dtHouse = state[RS_HOUSE] - input[RI_TOUT];
+	double dtAttic = state[RS_ATTIC] - input[RI_TOUT];
+
+	f.resize(FLOW_FEATURES);
+	f[0] = 1;
+	f[1] = dtHouse;
+	f[2] = sqrt(abs(dtHouse));
+	f[3] = dtAttic;
+	f[4] = sqrt(abs(dtAttic));
+	f[5] = input[RI_WIND];
+	f[6] = input[RI_WIND] * input[RI_WIND];
+	f[7] = input[RI_FANIN];
+	f[8] = input[RI_FANOUT];
+	f[9] = input[RI_AH];
+}
+
+/*
+* accumulate - adds a sample to the normal equations
+* @param normal - normal equations, features x (features + outputs)
+* @param f - features of the sample
+* @param y - outputs of the sample
+*/
+void Surrogate::accumulate(vector< vector<double> >& normal, vector<double>& f, vector<double>& y) {
+	int n = f.size();
+
+	for(int i=0; i < n; i++) {
+		for(int j=0; j < n; j++)
+			normal[i][j] += f[i] * f[j];
+		for(size_t k=0; k < y.size(); k++)
+			normal[i][n + k] += f[i] * y[k];
+	}
+}
+
+/*
+* solve - least squares coefficients of each output from the normal equations
+* The features are scaled to unit size first as they range from humidity ratios to Watts.
+* @param normal - normal equations, features x (features + outputs)
+* @param coef - returns the coefficients, outputs x features
+*/
+void Surrogate::solve(vector< vector<double> >& normal, vector< vector<double> >& coef) {
+	int n = normal.size();
+	int outputs = normal[0].size() - n;
+	vector<double> scale(n);
+	vector< vector<double> > A(n, vector<double>(n + 1));
+
+	for(int i=0; i < n; i++)
+		scale[i] = (normal[i][i] > 0) ? 1 / sqrt(normal[i][i]) : 0;
+
+	coef.assign(outputs, vector<double>(n, 0));
+	for(int k=0; k < outputs; k++) {
+		for(int i=0; i < n; i++) {
+			for(int j=0; j < n; j++)
+				A[i][j] = scale[i] * scale[j] * normal[i][j] + (i == j ? RIDGE : 0);
+			A[i][n] = scale[i] * normal[i][n + k];
+		}
+		vector<double> x = gauss(A);
+		for(int i=0; i < n; i++)
+			coef[k][i] = scale[i] * x[i];
+	}
+}
+
+/*
+* record - keeps a minute of the full model for training
+* @param startState - state at the start of the minute
+* @param input - inputs of the minute
+* @param flow - airflows of the minute
+* @param endState - state at the end of the minute
+*/
+void Surrogate::record(double* startState, double* input, double* flow, double* endState) {
+	dayStart.push_back(vector<double>(startState, startState + RS_STATES));
+	dayInput.push_back(vector<double>(input, input + RI_INPUTS));
+	dayFlow.push_back(vector<double>(flow, flow + RF_FLOWS));
+	dayEnd.push_back(vector<double>(endState, endState + RS_STATES));
+}
+
+/*
+* endDay - validates the current fit on the day just recorded and then adds the day to the fit
+* The validation run stops where the model leaves the range it is trusted in, as the reduced order days do.
+*/
+void Surrogate::endDay() {
+	vector<double> f, y(RS_STATES), flow(RF_FLOWS);
+	int minutes = dayStart.size();
+
+	if(minutes == 0)
+		return;
+
+	if(fitted) {
+		vector<double> state = dayStart[0];
+		for(int m=0; m < minutes; m++) {
+			flows(&state[0], &dayInput[m][0], &flow[0]);
+			if(!step(&state[0], &dayInput[m][0], &flow[0]))
+				break;
+			for(int i=0; i < RS_STATES; i++)
+				errorSum[i] += pow(state[i] - dayEnd[m][i], 2);
+			validationMinutes++;
+		}
+	}
+
+	for(int m=0; m < minutes; m++) {
+		for(int k=0; k < RF_FLOWS; k++) {
+			if(!fitted && m == 0) {
+				flowMin[k] = dayFlow[m][k];
+				flowMax[k] = dayFlow[m][k];
+			}
+			flowMin[k] = min(flowMin[k], dayFlow[m][k]);
+			flowMax[k] = max(flowMax[k], dayFlow[m][k]);
+		}
+		for(int i=0; i < RS_STATES; i++) {
+			if(!fitted && m == 0) {
+				stateMin[i] = dayStart[m][i];
+				stateMax[i] = dayStart[m][i];
+			}
+			stateMin[i] = min(stateMin[i], min(dayStart[m][i], dayEnd[m][i]));
+			stateMax[i] = max(stateMax[i], max(dayStart[m][i], dayEnd[m][i]));
+		}
+		for(int i=0; i < RS_STATES; i++)
+			y[i] = dayEnd[m][i] - dayStart[m][i];
+		stateFeatures(&dayStart[m][0], &dayInput[m][0], &dayFlow[m][0], f);
+		accumulate(stateNormal, f, y);
+		flowFeatures(&dayStart[m][0], &dayInput[m][0], f);
+		accumulate(flowNormal, f, dayFlow[m]);
+	}
+	solve(stateNormal, stateCoef);
+	solve(flowNormal, flowCoef);
+	fitted = true;
+	trainingDays++;
+
+	dayStart.clear();
+	dayInput.clear();
+	dayFlow.clear();
+	dayEnd.clear();
+}
+
+/*
+* flows - lumped airflows from the fit, limited to the range seen in training as the fit is not meant to extrapolate
+* @param state - current state
+* @param input - inputs of the minute
+* @param flow - returns the airflows
+*/
+void Surrogate::flows(double* state, double* input, double* flow) {
+	vector<double> f;
+
+	flowFeatures(state, input, f);
+	for(int k=0; k < RF_FLOWS; k++) {
+		flow[k] = 0;
+		for(int i=0; i < FLOW_FEATURES; i++)
+			flow[k] += flowCoef[k][i] * f[i];
+		flow[k] = max(flowMin[k], min(flow[k], flowMax[k]));
+	}
+}
+
+/*
+* step - advances the reduced order model one minute
+* @param state - state at the start of the minute, returns the state at the end
+* @param input - inputs of the minute
+* @param flow - airflows of the minute, from flows()
+* @return false if the new state is outside the range seen in training by more than STATE_MARGIN, when the fit is
+* not to be trusted and the full model has to take over
+*/
+bool Surrogate::step(double* state, double* input, double* flow) {
+	vector<double> f;
+
+	stateFeatures(state, input, flow, f);
+	for(int k=0; k < RS_STATES; k++) {
+		for(int i=0; i < STATE_FEATURES; i++)
+			state[k] += stateCoef[k][i] * f[i];
+	}
+	state[RS_HRATTIC] = max(state[RS_HRATTIC], 0.0);
+	state[RS_HRHOUSE] = max(state[RS_HRHOUSE], 0.0);
+
+	for(int k=0; k < RS_STATES; k++) {
+		if(!(state[k] >= stateMin[k] - STATE_MARGIN[k] && state[k] <= stateMax[k] + STATE_MARGIN[k]))
+			return false;
+	}
+	return true;
+}
+
+/*
+* rmsError - root mean square error of a state over all validation minutes
+* @param state - surrogateState
+* @return error in the units of the state
+*/
+double Surrogate::rmsError(int state) {
+	return validationMinutes > 0 ? sqrt(errorSum[state] / validationMinutes) : 0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#ifndef surrogate_h
+#define surrogate_h
+#include <vector>
+
+using namespace std;
+
+// States of the reduced order model, taken from the full model every minute of the training days
+enum surrogateState {
+	RS_ATTIC = 0,		// attic air temperature (deg K)
+	RS_HOUSE,			// house air temperature (deg K)
+	RS_MASS,				// house mass temperature (deg K)
+	RS_HRATTIC,			// attic humidity ratio (kg/kg)
+	RS_HRHOUSE,			// house humidity ratio (kg/kg)
+	RS_STATES
+};
+
+// Inputs of the reduced order model, known before the heat and mass transport is solved
+enum surrogateInput {
+	RI_TOUT = 0,		// outdoor temperature (deg K)
+	RI_HROUT,			// outdoor humidity ratio (kg/kg)
+	RI_WIND,				// local wind speed (m/s)
+	RI_ROOFSOLAR,		// solar on the north and south roof (W/m2)
+	RI_SOLGAIN,			// solar gain through the windows (W)
+	RI_SENSIBLE,		// heating (+ve) or cooling (-ve) into the supply air, including evaporation from the coil (W)
+	RI_LATENT,			// latent capacity of the coil (W)
+	RI_GAINS,			// internal gains including fan and dehumidifier heat (W)
+	RI_FANIN,			// fan flow into the house (m3/s)
+	RI_FANOUT,			// fan flow out of the house (m3/s)
+	RI_AH,				// air handler mass flow (kg/s)
+	RI_INPUTS
+};
+
+// Lumped airflows of the reduced order model
+enum surrogateFlow {
+	RF_IN = 0,			// all mass flow into the house (kg/s)
+	RF_HOUSEIN,			// envelope mass flow into the house (kg/s)
+	RF_HOUSEOUT,		// envelope mass flow out of the house (kg/s)
+	RF_CEILING,			// ceiling mass flow, +ve from the attic to the house (kg/s)
+	RF_ATTICIN,			// attic envelope mass flow in (kg/s)
+	RF_ATTICOUT,		// attic envelope mass flow out (kg/s)
+	RF_FLUE,				// flue mass flow (kg/s)
+	RF_PINT,				// house pressure (Pa)
+	RF_FLOWS
+};
+
+/*
+* Surrogate
+*
+* Reduced order model of the attic and house for screening runs. The full model is run on training days and the
+* lumped model is fitted to it by least squares: each airflow is linear in the stack and wind drivers and the fan flows,
+* and each state changes by a linear combination of its conductances to the other states and outside, the solar, equipment
+* and internal gains, and the heat and moisture carried by the fitted airflows. This is a three capacitance thermal model
+* (attic, house air, house mass) plus attic and house moisture, with the coefficients taken from the data rather than
+* the building description so it follows whatever the full model does for each building.
+* Before a training day is added to the fit the model is run freely over it from the full model state at the start of
+* the day, which gives its error against the full model on data it has not seen. Where the reduced order model leaves
+* the range of states it was trained on the full model takes over for the rest of the day, which also trains it there.
+*/
+class Surrogate {
+	private:
+		vector< vector<double> > stateNormal;		// normal equations of the state fit (features x features+1 per state)
+		vector< vector<double> > flowNormal;		// normal equations of the airflow fit
+		vector< vector<double> > stateCoef;			// fitted change of each state per minute for each feature
+		vector< vector<double> > flowCoef;			// fitted airflow for each feature
+		vector<double> flowMin, flowMax;				// range of each airflow in training
+		vector<double> stateMin, stateMax;			// range of each state in training
+		vector< vector<double> > dayStart;			// state at the start of each minute of the current training day
+		vector< vector<double> > dayInput;			// inputs of each minute of the current training day
+		vector< vector<double> > dayFlow;			// airflows of each minute of the current training day
+		vector< vector<double> > dayEnd;				// state at the end of each minute of the current training day
+		double errorSum[RS_STATES];					// sum of the squared validation errors
+
+		void stateFeatures(double* state, double* input, double* flow, vector<double>& f);
+		void flowFeatures(double* state, double* input, vector<double>& f);
+		void accumulate(vector< vector<double> >& normal, vector<double>& f, vector<double>& y);
+		void solve(vector< vector<double> >& normal, vector< vector<double> >& coef);
+
+	public:
+		bool fitted;										// true once there is a fit to run the reduced order model with
+		int trainingDays;
+		int reducedDays;
+		int fallbackDays;									// reduced order days the full model took over part way through
+		int validationMinutes;
+
+		Surrogate();
+		void record(double* startState, double* input, double* flow, double* endState);
+		void endDay();
+		void flows(double* state, double* input, double* flow);
+		bool step(double* state, double* input, double* flow);
+		double rmsError(int state);
+};
+
+#endif
@@ -0,0 +1,717 @@
+/* Humidity control strategies HumidityControl<TYPE>::ventilate compared with the humidity_control() function they were
+	written from, and the thermostat, economizer and dehumidifier humidistat compared with the code inline in main()
+*/
+#include <iostream>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+#include "control.h"
+#include "constants.h"
+
+using namespace std;
+
+// to compile: make test_control, make test builds and runs all the tests
+
+// the humidity_control() function of humidity_control.cpp before the strategies were compiled, with the climate data
+// of the settings as globals, HumContType, hcFlag and the hour's occupancy as parameters, the RIVEC v6 peak periods
+// of main() and rivecOn starting off as it did there
+double wCutoff, wDiffMaxNeg, wDiffMaxPos, W25[12], W75[12], doseTarget, HiDose, HiMonthDose, LowMonthDose, expLimit;
+int FirstCut, SecondCut, HiMonths[3], LowMonths[3];
+
+int humidity_control(int HumContType, int hcFlag, double HROut, double HRHouse, double RHhouse, double relExp, double relDose,
+	int hour, int month, int AHflag, int occupied) {
+	int rivecOn = 0;
+	double relExpTarget;		//This is a relative expsoure value target. It varies between 0 and 2.5, depending on magnitude of indoor-outdoor humidity ratio difference.
+	double doseTargetTmp;
+	int peakStart = (hcFlag == 1) ? 4 : 14;
+	int peakEnd = (hcFlag == 1) ? 8 : 18;
+	int peakFlag = 0;
+
+//	Cooling system tie-in.
+	if(HumContType == 1){
+		if(hcFlag == 2){ //test if we're in cooling season
+			if(AHflag == 2){
+				rivecOn = 1;
+			} else
+				if(relExp >= 2.5 || relDose > 1.0){ //have to with high exp
+					rivecOn = 1;
+				} else { //otherwise off
+					rivecOn = 0;
+				}
+		} else //if NOT in cooling season
+			if(relExp >= 0.95 || relDose > 1.0){ //have to with high exp
+					rivecOn = 1;
+				} else { //otherwise off
+					rivecOn = 0;
+				}
+		}
+
+//	Fixed control.
+//	Indoor and Outdoor sensor based control.
+	if(HumContType == 2){
+		if(RHhouse >= 55){ //Engage increased or decreased ventilation only if house RH is >60 (or 55% maybe?).
+			if(HROut > HRHouse){ //do not want to vent. Add some "by what amount" deadband value.
+				if(relExp >= 2.5 || relDose > 1.0){ //have to with high exp
+					rivecOn = 1;
+				} else { //otherwise off
+					rivecOn = 0;
+				}
+			} else { //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+				if(relExp >= 0.50 || relDose > 1.0){ //control to exp = 0.5. Need to change this value based on weighted avg results.
+					rivecOn = 1; //OR we can change the does calculation based on expected periods of contol function (i.e., 1-week,1-month, etc.)
+				} else {
+					rivecOn = 0;
+				}
+			}
+		} else {
+			if(relExp >= 0.95 || relDose > 1.0){
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Fixed control + cooling system tie-in.
+//	Indoor and Outdoor sensor based control.
+	if(HumContType == 3){
+		if(RHhouse >= 55){ //Engage increased or decreased ventilation only if house RH is >60 (or 55% maybe?).
+			if(HROut > HRHouse){ //do not want to vent. Add some "by what amount" deadband value.
+				if(AHflag == 2){
+					rivecOn = 1;
+				} else
+					if(relExp >= 2.5 || relDose > 1.0){ //have to with high exp
+						rivecOn = 1;
+					} else { //otherwise off
+						rivecOn = 0;
+					}
+			} else { //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+				if(relExp >= 0.50 || relDose > 1.0){ //control to exp = 0.5. Need to change this value based on weighted avg results.
+					rivecOn = 1; //OR we can change the does calculation based on expected periods of contol function (i.e., 1-week,1-month, etc.)
+				} else {
+					rivecOn = 0;
+				}
+			}
+		} else {
+			if(relExp >= 0.95 || relDose > 1.0){
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Proportional control.
+//	Indoor and Outdoor sensor based control.
+	if(HumContType == 4) {
+		if(RHhouse >= 55) {
+			if(HROut > HRHouse){ //More humid outside than inside, want to under-vent.
+				relExpTarget = 1 + (2.5-1) * abs((HRHouse-HROut) / (wDiffMaxNeg)); //wDiffMax has to be an avergaed value, because in a real-world controller you would not know this.
+				if(relExpTarget > 2.5){
+					relExpTarget = 2.5;
+				}
+				if(relExp >= relExpTarget || relDose > 1){ //relDose may be over a 1-week or 2-week time span...
+					rivecOn = 1;
+				} else { //otherwise off
+					rivecOn = 0;
+				}
+			} else { // More humid inside than outside, want to over-vent
+				relExpTarget = 1 - abs((HRHouse- HROut) / (wDiffMaxPos));
+				if(relExpTarget < 0){
+					relExpTarget = 0;
+				}
+				if(relExp >= relExpTarget || relDose > 1){ //
+					rivecOn = 1;
+				} else {
+					rivecOn = 0;
+				}
+			}
+		} else {
+			if(relExp >= 0.95 || relDose > 1){
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Proportional control + cooling system tie-in.
+//	Indoor and Outdoor sensor based control.
+	if(HumContType == 5) {
+		if(RHhouse >= 55) {
+			if(HROut > HRHouse) { //More humid outside than inside, want to under-vent.
+				relExpTarget = 1 + (2.5-1) * abs((HRHouse-HROut) / (wDiffMaxNeg)); //wDiffMax has to be an avergaed value, because in a real-world controller you would not know this.
+				if(relExpTarget > 2.5) {
+					relExpTarget = 2.5;
+				}
+				if(AHflag == 2) {
+					rivecOn = 1;
+				} else if(relExp >= relExpTarget || relDose > 1) { //relDose may be over a 1-week or 2-week time span...
+					rivecOn = 1;
+				} else { //otherwise off
+					rivecOn = 0;
+				}
+			} else { // More humid inside than outside, want to over-vent
+				relExpTarget = 1 - abs((HRHouse- HROut) / (wDiffMaxPos));
+				if(relExpTarget < 0) {
+					relExpTarget = 0;
+				}
+				if(relExp >= relExpTarget || relDose > 1) {
+					rivecOn = 1;
+				} else {
+					rivecOn = 0;
+				}
+			}
+		} else {
+			if(relExp >= 0.95 || relDose > 1) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Monthly Seasonal Control
+//	Monthly timer-based control, based on mean HRdiff by month. doseTargets are based on weighted average targeting dose = 1.5 during low-ventilation months, targeting annual dose of 0.98.
+	if(HumContType == 6) {
+		if(month <= FirstCut || month >= SecondCut) { //High ventilation months with net-humidity transport from inside to outside.
+			if(relDose > doseTarget) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		} else { //Low ventilation months with net-humidity transport from outside to inside.
+			if(relExp >= 2.5 || relDose > HiDose) { //Brennan changed from fixed 1.5 to variable HiDose value.
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Fixed control + cooling system tie-in + Monthly Seasonal Control.
+//	Indoor and Outdoor sensor based control.
+	if(HumContType == 7) {
+		if(HROut > HRHouse) { //do not want to vent.
+			if(AHflag == 2) {
+				rivecOn = 1;
+			} else if(relExp >= 2.5 || relDose > HiDose) {
+				rivecOn = 1;
+			} else { //otherwise off
+				rivecOn = 0;
+			}
+		} else { //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+			if(relDose > doseTarget) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Fixed control + cooling system tie-in + Monthly Seasonal Control.
+//	Indoor and Outdoor sensor based control.
+	if(HumContType == 7) {
+		if(HROut > HRHouse) { //do not want to vent.
+			if(RHhouse >= 55){
+			if(AHflag == 2) {
+				rivecOn = 1;
+			} else if(relExp >= 2.5 || relDose > HiDose) {
+				rivecOn = 1;
+			} else { //otherwise off
+				rivecOn = 0;
+			}
+			}
+			else if(relExp >= 0.95 || relDose > 1){
+				rivecOn = 1;
+			}
+			else{
+				rivecOn = 0;
+			}
+		}
+		else { //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+			if(relDose > doseTarget) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Monthly Seasonal controller + time of day
+//	Monthly timer-based control, based on mean HRdiff by month. doseTargets are based on weighted average
+//	targeting dose = 1.5 during low-ventilation months, targeting annual dose of 0.98.
+	if(HumContType == 8) {
+		if(month <= FirstCut || month >= SecondCut) { //High ventilation months with net-humidity transport from inside to outside.
+			if(hour >= 3 && hour <= 7) { //Was 3 and 7. Maybe change this to the warmest hours of the day.
+				rivecOn = 1; //Relatively dry time of day, vent more.
+			} else {
+				if(relDose > doseTarget) {
+					rivecOn = 1;
+				} else {
+					rivecOn = 0;
+				}
+			}
+		} else { //Low ventilation months with net-humidity transport from outside to inside.
+			if(hour >= 14 && hour <= 18) { //Brennan changed from 12 and 6, to 14 to 18. Always vent during peak cooling period.
+				rivecOn = 1;
+			} else if(hour >= 7 && hour <= 11){
+				rivecOn = 0;
+			} else {
+				if(relExp >= 2.5 || relDose > HiDose) {
+					rivecOn = 1;
+				} else {
+					rivecOn = 0;
+				}
+			}
+		}
+	}
+
+//	Fixed control + Monthly Seasonal Control.
+//	Indoor and Outdoor sensor based control.
+	if(HumContType == 9) {
+		if(HROut > HRHouse) { //do not want to vent. Add some "by what amount" deadband value.
+			if(relExp >= 2.5 || relDose > HiDose) { //have to with high exp 0.61
+				rivecOn = 1;
+			} else { //otherwise off
+				rivecOn = 0;
+			}
+		} else { //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+			if(relDose > doseTarget) { //control to exp = 0.5. Need to change this value based on weighted avg results.
+				rivecOn = 1; //OR we can change the does calculation based on expected periods of contol function (i.e., 1-week,1-month, etc.)
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Fixed control + Monthly Seasonal Control.
+//	Indoor and Outdoor sensor based control.
+	if(HumContType == 9) {
+		if(HROut > HRHouse) { //do not want to vent. Add some "by what amount" deadband value.
+			if(RHhouse >= 55) {
+			if(relExp >= 2.5 || relDose > HiDose) { //have to with high exp 0.61
+				rivecOn = 1;
+			}
+			else { //otherwise off
+				rivecOn = 0;
+			}
+			}
+			else if(relExp >= 0.95 || relDose > 1){
+				rivecOn = 1;
+			}
+			else{
+				rivecOn = 0;
+			}
+		}
+		else if(relDose > doseTarget){ //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+			rivecOn = 1; //OR we can change the does calculation based on expected periods of contol function (i.e., 1-week,1-month, etc.)
+		}
+		else {
+			rivecOn = 0;
+		}
+	}
+
+
+//	The real opportunities for control based on outside are when the outside value is changing rapidly. Sharp increases, decrease ventilation. Sharp decreases, increase ventilation.
+//	Need to undervent at above the 75th percentile and overvent below the 25th percentile based on a per month basis.
+//	Outdoor-only sensor based control
+	if(HumContType == 10) {
+		if(HROut > 0.012) { //If humid outside, reduce ventilation.
+			if(relExp >= 2.5 || relDose > 1) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		} else { //If dry outside, increase vnetilation.
+			if(relExp >= 0.95 || relDose > 1) { //but we do if exp is high
+				rivecOn = 1;
+			} else {
+				rivecOn = 0; //otherwise don't vent under high humidity condition.
+			}
+		}
+	}
+
+//	Monthly Advanced Seasonal Control
+//	Monthly timer-based control, based on mean HRdiff by month.
+//	doseTargets are based on weighted average targeting dose = 1.5 during low-ventilation months, targeting annual dose of 0.98.
+//	Setting the appropriate Dose Target based on the month
+	if(HumContType == 11) {
+		double doseTargetTmp;
+		if(month == HiMonths[0] || month == HiMonths[1] || month == HiMonths[2]){
+			doseTargetTmp = HiMonthDose;
+		} else if(month == LowMonths[0] || month == LowMonths[1]  || month == LowMonths[2]) {
+			doseTargetTmp = LowMonthDose;
+		} else if(month > FirstCut && month < SecondCut) {
+			doseTargetTmp = HiDose; //Brennan changed from fixed 1.5 to HiDose.
+		} else {
+			doseTargetTmp = doseTarget;
+		}
+		if(doseTargetTmp >= HiDose) {
+			if(relExp >= 2.5 || relDose > doseTargetTmp) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+		else {
+			if(relDose > doseTargetTmp) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Consider combining 8 and 12 - Monthly + Time of day + Cooling tie-in.
+//	Monthly Seasonal Control + Cooling system tie-in.
+//	Indoor and Outdoor sensor based control.
+	if(HumContType == 12) {
+		double doseTargetTmp;
+		if(month <= FirstCut || month >= SecondCut) {
+			doseTargetTmp = doseTarget;
+		} else {
+			doseTargetTmp = HiDose;
+		}
+		if(AHflag == 2) {
+				rivecOn = 1;
+		} else if(doseTargetTmp >= HiDose) {
+			if(relExp >= 2.5 || relDose > doseTargetTmp) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		} else {
+			if(relDose > doseTargetTmp) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Outdoor-only sensor based control, with variable dose targets
+	if(HumContType == 13) {
+		if(HROut >= wCutoff) { //If humid outside, reduce ventilation.
+			if(relExp >= 2.5 || relDose > 1.45) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		} else { //If dry outside, increase ventilation.
+			if(relDose > 0.45) { //but we do if exp is high
+				rivecOn = 1;
+			} else {
+				rivecOn = 0; //otherwise don't vent under high humidity condition.
+			}
+		}
+	}
+
+//	Outdoor-only sensor based control, control based on 25th and 75th percentile monthly values for each month and climate zone.
+	if(HumContType == 14) {
+		if(HROut >= W75[month-1]) { //If humid outside, reduce ventilation.
+			if(relExp >= 2.5 || relDose > 1.5) {
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		} else if (HROut <= W25[month-1]) { //If dry outside, increase vnetilation.
+			if(relDose > 0.5) { //but we do if exp is high
+				rivecOn = 1;
+			} else {
+				rivecOn = 0; //otherwise don't vent under high humidity condition.
+			}
+		} else {
+			if(relExp >= 0.95 || relDose > 1.0){ //Need to reduce this target to make equivalence work out...
+				rivecOn = 1;
+			} else {
+				rivecOn = 0;
+			}
+		}
+	}
+
+//	Monthly Advanced Seasonal Control + Fixed Control + Cooling System Tie_in
+//	Monthly timer-based control, based on mean HRdiff by month. doseTargets are based on weighted average targeting dose = 1.5 during low-ventilation months, targeting annual dose of 0.98.
+//	Setting the appropriate Dose Target based on the month
+	if(HumContType == 15) {
+		if(month == HiMonths[0] || month == HiMonths[1]  || month == HiMonths[2] ||
+			month == LowMonths[0] || month == LowMonths[1]  || month == LowMonths[2]) {
+			doseTargetTmp = HiMonthDose;
+			if(HROut > HRHouse) { //do not want to vent. Add some "by what amount" deadband value.
+				if(AHflag == 2) {
+					rivecOn = 1;
+				} else if(relExp >= 2.5 || relDose > LowMonthDose) { //have to with high exp
+					rivecOn = 1;
+				} else { //otherwise off
+					rivecOn = 0;
+				}
+			} else { //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+				if(relDose > HiMonthDose) { //control to exp = 0.5. Need to change this value based on weighted avg results.
+					rivecOn = 1; //OR we can change the does calculation based on expected periods of contol function (i.e., 1-week,1-month, etc.)
+				} else {
+					rivecOn = 0;
+				}
+			}
+		} else {
+			if(HROut > HRHouse) { //do not want to vent. Add some "by what amount" deadband value.
+				if(AHflag == 2) {
+					rivecOn = 1;
+				} else if(relExp >= 2.5 || relDose > 1.5) { //have to with high exp
+					rivecOn = 1;
+				} else { //otherwise off
+					rivecOn = 0;
+				}
+			} else { //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+				if(relDose > doseTarget) { //control to exp = 0.5. Need to change this value based on weighted avg results.
+					rivecOn = 1; //OR we can change the does calculation based on expected periods of contol function (i.e., 1-week,1-month, etc.)
+				} else {
+					rivecOn = 0;
+				}
+			}
+		}
+	}
+
+//	Monthly Advanced Seasonal Control + Fixed Control
+//	Monthly timer-based control, based on mean HRdiff by month. doseTargets are based on weighted average targeting dose = 1.5 during low-ventilation months, targeting annual dose of 0.98.
+//	Setting the appropriate Dose Target based on the month
+	if(HumContType == 16) {
+		if(month == HiMonths[0] || month == HiMonths[1]  || month == HiMonths[2] ||
+			month == LowMonths[0] || month == LowMonths[1]  || month == LowMonths[2]) {
+			doseTargetTmp = HiMonthDose;
+			if(HROut > HRHouse) { //do not want to vent. Add some "by what amount" deadband value.
+				if(relExp >= 2.5 || relDose > LowMonthDose) { //have to with high exp
+					rivecOn = 1;
+				} else { //otherwise off
+					rivecOn = 0;
+				}
+			} else { //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+				if(relDose > HiMonthDose) { //control to exp = 0.5. Need to change this value based on weighted avg results.
+					rivecOn = 1; //OR we can change the does calculation based on expected periods of contol function (i.e., 1-week,1-month, etc.)
+				} else {
+					rivecOn = 0;
+				}
+			}
+		} else {
+			if(HROut > HRHouse) { //do not want to vent. Add some "by what amount" deadband value.
+				if(relExp >= 2.5 || relDose > 1.5) { //have to with high exp
+					rivecOn = 1;
+				} else { //otherwise off
+					rivecOn = 0;
+				}
+			} else { //want to vent due to high indoor humidity, so maybe we just let it run, without relExp control?
+				if(relDose > doseTarget) { //control to exp = 0.5. Need to change this value based on weighted avg results.
+					rivecOn = 1; //OR we can change the does calculation based on expected periods of contol function (i.e., 1-week,1-month, etc.)
+				} else {
+					rivecOn = 0;
+				}
+			}
+		}
+	}
+
+//	Rivec control of number 50 fan type, algorithm v6
+	if(HumContType == 0) {
+		if(occupied) {				            	// Base occupied
+			if(relExp >= 0.95 || relDose >= 1.0)
+				rivecOn = 1;
+		} else {						                	// Base unoccupied
+			if(relExp >= expLimit)
+				rivecOn = 1;
+		}
+		if(hour >= peakStart && hour < peakEnd && peakFlag == 0) {		// PEAK Time Period
+			rivecOn = 0;												// Always off
+			if(relExp >= expLimit)
+				rivecOn = 1;
+		}
+	}
+
+	return rivecOn;
+}
+
+// the heating and cooling thermostat inline in main()
+int inlineThermostat(int hcFlag, double tempHouse, double setpoint, int AHflag, int& set) {
+	if(hcFlag == 1) {
+		if(tempHouse > (setpoint + .5))
+			AHflag = 0;
+		if(AHflag == 0 || AHflag == 100) {
+			if(tempHouse <= (setpoint - .5))
+				set = 1;
+			else
+				set = 0;
+		}
+		if(tempHouse < (setpoint - .5))
+			AHflag = 1;
+		if(tempHouse >= (setpoint - .5) && tempHouse <= (setpoint + .5)) {
+			if(set == 1)
+				AHflag = 1;
+			else
+				AHflag = 0;
+		}
+	} else {
+		if(tempHouse < (setpoint - .5))
+			AHflag = 0;
+		if(AHflag == 0 || AHflag == 100) {
+			if(tempHouse >= (setpoint + .5))
+				set = 1;
+			else
+				set = 0;
+		}
+		if(tempHouse >= (setpoint + .5)) {
+			AHflag = 2;
+		}
+		if(tempHouse < (setpoint + .5) && tempHouse >= (setpoint - .5)) {
+			if(set == 1)
+				AHflag = 2;
+			else
+				AHflag = 0;
+		}
+	}
+	return AHflag;
+}
+
+// the dehumidifier control of Dehumidifier::run()
+double inlineHumidistat(double rhIn, double setPoint, double deadBand, double onTime) {
+	if(onTime > 0) {
+		if(rhIn < setPoint - deadBand) {
+			onTime = 0;
+		} else {
+			onTime += STEP_MINUTES;
+		}
+	} else {
+		if(rhIn > setPoint + deadBand) {
+			onTime = STEP_MINUTES;
+		}
+	}
+	return onTime;
+}
+
+// climate data of a humidity control file, with months that fall in each of the monthly strategy branches
+void setClimate(ControlSettings& s) {
+	const double w25[12] = { .003, .003, .004, .006, .009, .012, .014, .014, .011, .007, .005, .003 };
+	const double w75[12] = { .005, .005, .007, .010, .013, .016, .018, .018, .015, .011, .008, .005 };
+	s.wCutoff = .012;
+	s.wDiffMaxNeg = .004;
+	s.wDiffMaxPos = .005;
+	for(int i = 0; i < 12; i++) {
+		s.W25[i] = w25[i];
+		s.W75[i] = w75[i];
+	}
+	s.FirstCut = 4;
+	s.SecondCut = 10;
+	s.doseTarget = .6;
+	s.HiDose = 1.5;
+	s.HiMonths[0] = 1;
+	s.HiMonths[1] = 2;
+	s.HiMonths[2] = 12;
+	s.LowMonths[0] = 6;
+	s.LowMonths[1] = 7;
+	s.LowMonths[2] = 8;
+	s.HiMonthDose = .45;
+	s.LowMonthDose = 1.7;
+
+	wCutoff = s.wCutoff;
+	wDiffMaxNeg = s.wDiffMaxNeg;
+	wDiffMaxPos = s.wDiffMaxPos;
+	for(int i = 0; i < 12; i++) {
+		W25[i] = s.W25[i];
+		W75[i] = s.W75[i];
+	}
+	FirstCut = s.FirstCut;
+	SecondCut = s.SecondCut;
+	doseTarget = s.doseTarget;
+	HiDose = s.HiDose;
+	for(int i = 0; i < 3; i++) {
+		HiMonths[i] = s.HiMonths[i];
+		LowMonths[i] = s.LowMonths[i];
+	}
+	HiMonthDose = s.HiMonthDose;
+	LowMonthDose = s.LowMonthDose;
+	expLimit = s.expLimit;
+}
+
+typedef int (*strategy)(const ControlSettings& settings, const ControlInputs& in);
+
+int main() {
+	const strategy strategies[] = { HumidityControl<0>::ventilate, HumidityControl<1>::ventilate,
+		HumidityControl<2>::ventilate, HumidityControl<3>::ventilate, HumidityControl<4>::ventilate,
+		HumidityControl<5>::ventilate, HumidityControl<6>::ventilate, HumidityControl<7>::ventilate,
+		HumidityControl<8>::ventilate, HumidityControl<9>::ventilate, HumidityControl<10>::ventilate,
+		HumidityControl<11>::ventilate, HumidityControl<12>::ventilate, HumidityControl<13>::ventilate,
+		HumidityControl<14>::ventilate, HumidityControl<15>::ventilate, HumidityControl<16>::ventilate };
+	const int numTypes = sizeof(strategies) / sizeof(strategies[0]);
+	// values on and either side of the limits the strategies test, the hours at the edges of the time of day periods
+	const int hours[] = { 0, 3, 4, 7, 8, 11, 12, 14, 17, 18, 22 };
+	const double relExps[] = { 0, .5, .7, .95, 2.5, 5, 6 };
+	const double relDoses[] = { .3, .45, .5, .6, 1, 1.45, 1.5, 1.7 };
+	const double HROuts[] = { .004, .0105, .012, .013, .017 };
+	const double HRHouses[] = { .005, .0125 };
+	const double RHHouses[] = { 50, 55 };
+	ControlSettings settings(3, 5);
+	long decisions = 0;
+	int errors = 0;
+
+	setClimate(settings);
+	for(int type = 0; type < numTypes; type++) {
+		int typeErrors = 0;
+		for(int month = 1; month <= 12; month++)
+		for(int hour : hours)
+		for(int hcFlag = 1; hcFlag <= 2; hcFlag++)
+		for(int AHflag = 0; AHflag <= 2; AHflag += 2)
+		for(int occupied = 0; occupied <= 1; occupied++)
+		for(double relExp : relExps)
+		for(double relDose : relDoses)
+		for(double HROut : HROuts)
+		for(double HRHouse : HRHouses)
+		for(double RHHouse : RHHouses) {
+			ControlInputs in = { hour, month, occupied, hcFlag, AHflag, 0, relExp, relDose, HROut, HRHouse, RHHouse };
+			int rivecOn = strategies[type](settings, in);
+			int expected = humidity_control(type, hcFlag, HROut, HRHouse, RHHouse, relExp, relDose, hour, month, AHflag,
+				occupied);
+			if(rivecOn != expected && typeErrors++ < 5) {
+				cout << "HumidityControl<" << type << "> month=" << month << " hour=" << hour << " hcFlag=" << hcFlag
+					<< " AHflag=" << AHflag << " occupied=" << occupied << " relExp=" << relExp << " relDose=" << relDose
+					<< " HROut=" << HROut << " HRHouse=" << HRHouse << " RH=" << RHHouse << ": " << rivecOn
+					<< " humidity_control()=" << expected << endl;
+			}
+			decisions++;
+		}
+		errors += typeErrors;
+	}
+	cout << "Humidity control: " << numTypes << " strategies, " << decisions << " decisions, " << errors
+		<< " differ from humidity_control()" << endl;
+
+	// the thermostat and humidistat keep state between steps, so they are stepped along a house temperature and RH
+	// that cross their dead bands both ways
+	int equipmentErrors = 0;
+	for(int hcFlag = 1; hcFlag <= 2; hcFlag++) {
+		const double setpoint = (hcFlag == 1) ? 294.15 : 297.15;
+		int AHflag = 0, AHflagInline = 0, set = 0, setInline = 0;
+		for(int i = 0; i < 400; i++) {
+			double tempHouse = setpoint + 1.5 * sin(i * .05) + ((i % 7 == 0) ? .5 : 0);
+			AHflag = (hcFlag == 1) ? DeadBandThermostat::heating(tempHouse, setpoint, AHflag, set)
+				: DeadBandThermostat::cooling(tempHouse, setpoint, AHflag, set);
+			AHflagInline = inlineThermostat(hcFlag, tempHouse, setpoint, AHflagInline, setInline);
+			if(AHflag != AHflagInline || set != setInline)
+				equipmentErrors++;
+			// the economizer runs when the air handler is off, the house warm and the outside cooler
+			double tempOut = tempHouse - 5 + (i % 11);
+			int econoFlag = TemperatureEconomizer::run(AHflag, hcFlag, tempHouse, tempOut);
+			double econodt = tempHouse - tempOut;
+			int econoInline = (AHflag == 0 && econodt >= 3.33 && tempHouse > 294.15 && hcFlag == 2) ? 1 : 0;
+			if(econoFlag != econoInline)
+				equipmentErrors++;
+		}
+	}
+	double onTime = 0, onTimeInline = 0;
+	for(int i = 0; i < 400; i++) {
+		double rhIn = 60 + 6 * sin(i * .07);
+		onTime = DeadBandHumidistat::onTime(rhIn, 60, 2.5, onTime);
+		onTimeInline = inlineHumidistat(rhIn, 60, 2.5, onTimeInline);
+		if(onTime != onTimeInline)
+			equipmentErrors++;
+	}
+	cout << "Thermostat, economizer and humidistat: " << equipmentErrors << " steps differ from the inline code" << endl;
+	errors += equipmentErrors;
+
+	cout << (errors ? "FAILED" : "PASSED") << endl;
+	return errors ? 1 : 0;
+}
@@ -1,9 +1,7 @@
-#include <sstream>
+/* Compressor::run() and idle() compared with the cooling capacity, EER and SHR equations inline in main() they replaced,
+	and the dehumidifier control against its set point and dead band
+*/
 #include <iostream>
-#include <fstream>
-#include <iomanip>		// RAD: so far used only for setprecission() in cmd output
-#include <time.h>
-#include <vector>
 #ifdef __APPLE__
    #include <cmath>        // needed for mac g++
 #endif
@@ -13,43 +11,170 @@
 
 using namespace std;
 
-int main() {
+// to compile: make test_equip, make test builds and runs all the tests
+
+const double AH_FLOW_PER_TON = 400 * .0004719;	// air handler flow (m3/s per ton)
+const double FAN_HEAT = 500;					// air handler fan heat (Watts)
+const double CAP_ADJUST_TIME = 4;				// minutes the capacity ramps up over
 
-/*
-	Compressor centralAC(12.0, 3.0, 1.0);	// 12 SEER, 3 ton
+// State and outputs of the inline cooling model of main()
+struct Inline {
+	double compressorPower;
+	double capacityc;
+	double latcap;
+	double evapcap;
+	double SHR;
+	double Mcoil;
+};
 
-	double hrReturn = 0.008;
-	double tReturn = 273 + 20;
-	double tOut = 273 + 30;
-	double fanFlow = 400 * 3 * .0004719;
-	double fanHeat = 500;
-	double mAH = fanFlow * airDensityRef;
+// the cooling step inline in main() before the Compressor class, AHflag 2 cools, 100 runs the fan only, 0 is off
+void inlineCooling(Inline& s, int AHflag, double EERari, double capacityari, double capacityraw, double charge, double qAH_cool,
+	double HRReturn, double tempReturn, double dryBulb, double AHfanHeat, double mAH, double compTime, double cCapAdjustTime) {
+	double Mcoilprevious = s.Mcoil;
+	double qAH_cfm = qAH_cool / .0004719;
+	double qAHcorr = 1.62 - .62 * qAH_cfm / (400 * capacityraw) + .647 * log(qAH_cfm / (400 * capacityraw));
+	double capacity = 0;
+	double EER;
+	double chargecapd, chargeeerd, chargecapw, chargeeerw;
 
-	for(int i = 0; i<20; i++) {
-		float power = centralAC.run(1, hrReturn, tReturn, tOut, fanFlow, fanHeat, mAH);
-		cout << "Power=" << power << " Sensible=" << centralAC.capacitySensible << " Latent=" << centralAC.capacityLatent << " condensate=" << centralAC.condensate << endl;
+	s.compressorPower = 0;
+	s.capacityc = 0;
+	s.evapcap = 0;
+	s.latcap = 0;
+	if(AHflag == 2) {
+		double Toutf = KtoF(dryBulb);
+		s.SHR = 1 - 50 * (HRReturn - .005);
+		if(s.SHR < .25)
+			s.SHR = .25;
+		if(s.SHR > 1)
+			s.SHR = 1;
+		if(s.SHR == 1) {
+			chargecapd = (charge < .725) ? 1.2 + (charge - 1) : .925;
+			chargeeerd = (charge < 1) ? 1.04 + (charge - 1) * .65 : 1.04 - (charge - 1) * .35;
+			capacity = (capacityari * 1000) * .91 * qAHcorr * chargecapd * ((-.00007) * pow((Toutf - 82),2) - .0067 * (Toutf - 82) + 1);
+			EER = EERari * qAHcorr * chargeeerd * ((-.00007) * pow((Toutf - 82),2) - .0085 * (Toutf - 82) + 1);
+		} else {
+			chargecapw = (charge < .85) ? 1 + (charge - .85) : 1;
+			if(charge < .85) {
+				chargeeerw = 1 + (charge - .85) * .9;
+			} else if(charge <= 1) {
+				chargeeerw = 1;
+			} else {
+				chargeeerw = 1 - (charge - 1) * .35;
+			}
+			double hret = .24 * ((tempReturn - 273.15) * 9 / 5 + 32) + HRReturn * (1061 + .444 * ((tempReturn - 273.15) * 9 / 5 + 32));
+			hret += AHfanHeat / mAH / 2326.;
+			capacity = capacityari * 1000 * (1 + (hret - 30) * .025) * qAHcorr * chargecapw * ((-.00007) * pow((Toutf - 95),2) - .0067 * (Toutf - 95) + 1);
+			EER = EERari * qAHcorr * chargeeerw * ((-.00007) * pow((Toutf - 95),2) - .0085 * (Toutf - 95) + 1);
+		}
+		s.compressorPower = capacity / EER;
+		if(compTime > 0) {
+			s.SHR = s.SHR + (3 - compTime) / 3.0 * (1 - s.SHR);
+		}
+		if(compTime > 0 && compTime < cCapAdjustTime) {
+			capacity *= (compTime / cCapAdjustTime);
+		}
+		s.capacityc = s.SHR * capacity / 3.413;
+		s.capacityc = s.capacityc - AHfanHeat;
 	}
-	for(int i = 0; i<30; i++) {
-		float power = centralAC.run(0, hrReturn, tReturn, tOut, fanFlow, fanHeat, mAH);
-		cout << "Power=" << power << " Sensible=" << centralAC.capacitySensible << " Latent=" << centralAC.capacityLatent << " condensate=" << centralAC.condensate << endl;
+
+	if(AHflag == 2 && s.SHR < 1) {
+		s.latcap = (1 - s.SHR) * capacity / 3.413;
+		s.Mcoil = Mcoilprevious + s.latcap / 2501000 * dtau;
+	} else if((AHflag == 2 || AHflag == 100) && s.Mcoil > 0) {
+		s.latcap = -.3 * capacityraw / 1800 * 2501000;
+		s.evapcap = s.latcap;
+		s.Mcoil = Mcoilprevious - .3 * capacityraw / 1800 * dtau;
 	}
-*/
+	if(s.Mcoil < 0)
+		s.Mcoil = 0;
+	if(s.Mcoil > .3 * capacityraw)
+		s.Mcoil = .3 * capacityraw;
+}
 
-	double cap = 100;
-	double fact = 2.5;
-	double rhSetpoint = 60;
+// counts an output that differs from the inline one
+int check(const char* name, double model, double expected, double charge, double tOut, double hrReturn, double compTime) {
+	if(model == expected)
+		return 0;
+	cout << name << "=" << model << " inline=" << expected << " charge=" << charge << " Tout=" << tOut
+		<< " hrReturn=" << hrReturn << " compTime=" << compTime << endl;
+	return 1;
+}
+
+int main() {
+	const double EERari = 12;
+	const double capacityari = 36;
+	const double tons = 3;
+	const double charges[] = { .7, .8, .9, 1, 1.1 };
+	const double tOuts[] = { 15, 24, 30, 35, 41, 46 };			// deg C
+	const double hrReturns[] = { .003, .005, .006, .009, .012, .02 };	// dry coil up to .005
+	const double compTimes[] = { 1, 2, 3, 3.5, 0, 0 };			// minutes, a start then steady running
+	const double tReturn = 24 + C_TO_K;
+	const double fanFlow = AH_FLOW_PER_TON * tons * .9;
+	const double mAH = fanFlow * airDensityRef;
+	int errors = 0;
+	int steps = 0;
+
+	for(double charge : charges) {
+		Compressor centralAC(EERari, capacityari, tons, charge, CAP_ADJUST_TIME);
+		Inline base = { 0, 0, 0, 0, 0, 0 };
+
+		centralAC.setAirflow(fanFlow);
+		for(double tOut : tOuts) {
+			for(double hrReturn : hrReturns) {
+				// a compressor cycle then the fan drying the coil and the air handler off
+				for(int i = 0; i < 10; i++) {
+					int AHflag = (i < 6) ? 2 : (i < 9) ? 100 : 0;
+					double compTime = (i < 6) ? compTimes[i] : 0;
+					double power = 0;
+
+					if(AHflag == 2) {
+						power = centralAC.run(hrReturn, tReturn, tOut + C_TO_K, FAN_HEAT, mAH, compTime);
+					} else {
+						centralAC.idle(AHflag == 100);
+					}
+					inlineCooling(base, AHflag, EERari, capacityari, tons, charge, fanFlow, hrReturn, tReturn, tOut + C_TO_K,
+						FAN_HEAT, mAH, compTime, CAP_ADJUST_TIME);
+
+					if(AHflag == 2) {
+						errors += check("power", power, base.compressorPower, charge, tOut, hrReturn, compTime);
+						errors += check("SHR", centralAC.SHR, base.SHR, charge, tOut, hrReturn, compTime);
+						errors += check("sensible", centralAC.capacitySensible, base.capacityc, charge, tOut, hrReturn, compTime);
+					} else {
+						errors += check("sensible", centralAC.capacitySensible, 0, charge, tOut, hrReturn, compTime);
+					}
+					errors += check("latent", centralAC.capacityLatent, base.latcap, charge, tOut, hrReturn, compTime);
+					errors += check("evaporation", centralAC.evaporation, base.evapcap, charge, tOut, hrReturn, compTime);
+					errors += check("coil", centralAC.coilMoisture, base.Mcoil, charge, tOut, hrReturn, compTime);
+					steps++;
+				}
+			}
+		}
+	}
+	cout << "Compressor: " << steps << " steps, " << errors << " outputs differ from the inline equations" << endl;
+
+	// the dehumidifier starts above the set point plus the dead band and stops below it less the dead band
+	const double rhSetpoint = 60;
+	const double deadBand = 2.5;
 	double rhIn = 50;
 	double tIn = 27 + C_TO_K;
-	
-	Dehumidifier dh(cap, fact, rhSetpoint);
-	
-	for(int m=0; m<60; m++) {
-		if(dh.run(rhIn, tIn)) {
-			rhIn -= 1;
-		} else {
-			rhIn += 1;
+	bool on = false;
+	int dhErrors = 0;
+	Dehumidifier dh(100, 2.5, rhSetpoint, deadBand);
+
+	for(int m = 0; m < 60; m++) {
+		bool expected = on ? (rhIn >= rhSetpoint - deadBand) : (rhIn > rhSetpoint + deadBand);
+		on = dh.run(rhIn, tIn);
+		if(on != expected || (on && (dh.condensate <= 0 || dh.power <= 0)) || (!on && dh.power != 0)) {
+			cout << "Dehumidifier minute " << m << " RH=" << rhIn << " on=" << on << " condensate=" << dh.condensate
+				<< " power=" << dh.power << endl;
+			dhErrors++;
 		}
-		cout << m << " RH=" << rhIn << " lat=" << dh.moisture << " sen=" << dh.sensible << " power=" << dh.power << endl;
+		rhIn += on ? -1 : 1;
 	}
-	
-}
\ No newline at end of file
+	cout << "Dehumidifier: " << dhErrors << " steps off its control" << endl;
+	errors += dhErrors;
+
+	cout << (errors ? "FAILED" : "PASSED") << endl;
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,237 @@
+/* Sensitivities of the attic and house heat balance from Dual numbers
+	compared with central finite differences of the double calculation,
+	and variants of the house run in lanes compared with running each of them on its own,
+	and the heat balance compiled for the layout of the test house compared with the general one,
+	and HeatModel steps compared with calling sub_heat,
+	and the ideal loads of a HeatModel holding the house at a setpoint
+*/
+#include <iostream>
+#include <iomanip>
+#include <ctime>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+#include "heat.h"
+#include "constants.h"
+#include "lanes.h"
+
+using namespace std;
+
+// to compile: make test_heat, make test builds and runs all the tests
+
+const int NUM_PARAMS = 4;
+const char* paramName[NUM_PARAMS] = { "ceilRval", "supRval", "mCeiling", "mSupLeak" };
+const int LANES = 4;
+// variants of the house, with the ceiling flow both ways and an uninsulated ceiling to take both sides of the branches
+const double laneParams[NUM_PARAMS][LANES] = { { 5.3, 2, 8, 0 }, { 1.4, 0.7, 1.4, 2.1 }, { 0.02, -0.03, 0.05, -0.01 },
+	{ 0.05, 0, 0.1, 0.02 } };
+
+/*
+* heatHour - runs the heat balance for an hour of a cooling afternoon with fixed flows
+* @param p - ceiling R-value, supply duct R-value, ceiling mass flow, supply leak mass flow
+* @param house - returns the house air temperature (deg K)
+* @param attic - returns the attic air temperature (deg K)
+* LAYOUT - sub_heat instance to run, the test house has no roof insulation, ducts in the attic and no radiant barrier
+*/
+template <class T, int LAYOUT = HL_GENERAL> void heatHour(T* p, T& house, T& attic) {
+	T tempOld[ATTIC_NODES], b[ATTIC_NODES];
+	SparseMatrixT<T> A;
+	HeatCoefficients<T> coef;
+	zone_struct* zone = 0;
+
+	T tempOut = 308, windSpeed = 2, ssolrad = 600, nsolrad = 300, skyCover = 0.1;
+	T AL4 = 0.05, atticVolume = 250, houseVolume = 500, floorArea = 200, planArea = 200, roofPitch = 20;
+	T ductLocation = 0, mAH = 0.5, mSupReg = 0.5 - p[3], mRetReg = 0.45, mRetLeak = -0.05, mSupLeak = p[3];
+	T mCeiling = p[2], supRval = p[1], retRval = 1.4, ceilRval = p[0];
+	T supDiameter = 0.3, retDiameter = 0.4, supThickness = 0.001, retThickness = 0.001, supLength = 20, retLength = 10;
+	T supVel = 5, retVel = 4, HROUT = 0.008, uaSolAir = 30, uaTOut = 60;
+	T matticenvin = 0.3, matticenvout = -0.3, mHouseIN = 0.05, mHouseOUT = -0.05 - p[2];
+	T mSupAHoff = 0, mRetAHoff = 0, solgain = 500, tsolair = 320, mFanCycler = 0, roofPeakHeight = 5;
+	T mERV_AH = 0, ERV_SRE = 0, mHRV = 0, HRV_ASE = 0, mHRV_AH = 0;
+	T capacityc = 8000, capacityh = 0, evapcap = 0, internalGains = 600;
+	T airDensityIN = 1.2, airDensityOUT = 1.15, airDensityATTIC = 1.1, airDensitySUP = 1.25, airDensityRET = 1.2;
+	T storyHeight = 2.5, innerNorthH, innerSouthH, bulkH;
+	int pRef = 101325, roofType = 1, AHflag = 1, numStories = 1;
+
+	for(int i=0; i < ATTIC_NODES; i++)
+		tempOld[i] = 300;
+	tempOld[14] = 285;
+	tempOld[15] = 297;
+
+	for(int minute=0; minute < 60; minute++) {
+		sub_heat<T, LAYOUT>(tempOut, mCeiling, AL4, windSpeed, ssolrad, nsolrad, tempOld, atticVolume, houseVolume, skyCover, b,
+			floorArea, roofPitch, ductLocation, mSupReg, mRetReg, mRetLeak, mSupLeak, mAH, supRval, retRval, supDiameter,
+			retDiameter, supThickness, retThickness, supVel, retVel, pRef, HROUT, uaSolAir, uaTOut, matticenvin, matticenvout,
+			mHouseIN, mHouseOUT, planArea, mSupAHoff, mRetAHoff, solgain, tsolair, mFanCycler, roofPeakHeight, retLength,
+			supLength, roofType, T(3), T(0), ceilRval, T(1.5), AHflag, mERV_AH, ERV_SRE, mHRV, HRV_ASE, mHRV_AH, capacityc,
+			capacityh, evapcap, internalGains, airDensityIN, airDensityOUT, airDensityATTIC, airDensitySUP, airDensityRET,
+			numStories, storyHeight, T(0), innerNorthH, innerSouthH, bulkH, T(400), T(120), 0, 0, zone, A, coef, dtau);
+		for(int i=0; i < ATTIC_NODES; i++)
+			tempOld[i] = b[i];
+	}
+	house = tempOld[15];
+	attic = tempOld[0];
+}
+
+/*
+* heatHourModel - heatHour with a HeatModel for the test house
+* @param p - ceiling R-value, supply duct R-value, ceiling mass flow, supply leak mass flow
+* @param house - returns the house air temperature (deg K)
+* @param attic - returns the attic air temperature (deg K)
+* @param setpoint - cooling setpoint the house is held at with no air conditioner, 0 to run the air conditioner
+* @param load - returns the ideal load of the last step (W)
+* @param residual - returns the largest difference from the setpoint over the steps of the held house air and of the
+*	house air left free with the ideal load added to the internal gains (K)
+*/
+void heatHourModel(double* p, double& house, double& attic, double setpoint=0, double* load=0, double* residual=0) {
+	double tempOld[ATTIC_NODES], b[ATTIC_NODES];
+	HeatModel<double> model(250, 500, 200, 200, 20, 5, 0.05, 0, p[1], 1.4, 0.3, 0.4, 0.001, 0.001, 20, 10, 1, 3, 0, p[0],
+		1.5, 1, 2.5, 400, 120, 0);
+	HeatModel<double> free(250, 500, 200, 200, 20, 5, 0.05, 0, p[1], 1.4, 0.3, 0.4, 0.001, 0.001, 20, 10, 1, 3, 0, p[0],
+		1.5, 1, 2.5, 400, 120, 0);
+	double bFree[ATTIC_NODES];
+
+	double tempOut = 308, windSpeed = 2, ssolrad = 600, nsolrad = 300, skyCover = 0.1;
+	double mAH = 0.5, mSupReg = 0.5 - p[3], mRetReg = 0.45, mRetLeak = -0.05, mSupLeak = p[3], mCeiling = p[2];
+	double supVel = 5, retVel = 4, HROUT = 0.008, uaSolAir = 30, uaTOut = 60;
+	double matticenvin = 0.3, matticenvout = -0.3, mHouseIN = 0.05, mHouseOUT = -0.05 - p[2];
+	double mSupAHoff = 0, mRetAHoff = 0, solgain = 500, tsolair = 320, mFanCycler = 0;
+	double mERV_AH = 0, ERV_SRE = 0, mHRV = 0, HRV_ASE = 0, mHRV_AH = 0;
+	double capacityc = 8000, capacityh = 0, evapcap = 0, internalGains = 600;
+	double airDensityIN = 1.2, airDensityOUT = 1.15, airDensityATTIC = 1.1, airDensitySUP = 1.25, airDensityRET = 1.2;
+	double innerNorthH, innerSouthH, bulkH;
+	int pRef = 101325, AHflag = 1;
+	double largestResidual = 0;
+
+	if(setpoint > 0) {
+		model.idealLoads(setpoint, false);
+		capacityc = 0;
+		AHflag = 0;
+	}
+	for(int i=0; i < ATTIC_NODES; i++)
+		tempOld[i] = 300;
+	tempOld[14] = 285;
+	tempOld[15] = 297;
+
+	for(int i=0; i < (int) (3600 / dtau + .5); i++) {
+		model.step(tempOut, mCeiling, windSpeed, ssolrad, nsolrad, tempOld, skyCover, b, mSupReg, mRetReg, mRetLeak, mSupLeak,
+			mAH, supVel, retVel, pRef, HROUT, uaSolAir, uaTOut, matticenvin, matticenvout, mHouseIN, mHouseOUT, mSupAHoff,
+			mRetAHoff, solgain, tsolair, mFanCycler, AHflag, mERV_AH, ERV_SRE, mHRV, HRV_ASE, mHRV_AH, capacityc, capacityh,
+			evapcap, internalGains, airDensityIN, airDensityOUT, airDensityATTIC, airDensitySUP, airDensityRET, 0,
+			innerNorthH, innerSouthH, bulkH, 0, 0, dtau);
+		if(setpoint > 0) {
+			// the load is what the house air balance is short, as a gain it keeps the free house air on the setpoint, after
+			// the first step that pulls it 2 K onto the setpoint and stops the sub_heat iterations at another attic temperature
+			double gains = internalGains + model.idealLoad;
+			free.step(tempOut, mCeiling, windSpeed, ssolrad, nsolrad, tempOld, skyCover, bFree, mSupReg, mRetReg, mRetLeak,
+				mSupLeak, mAH, supVel, retVel, pRef, HROUT, uaSolAir, uaTOut, matticenvin, matticenvout, mHouseIN, mHouseOUT,
+				mSupAHoff, mRetAHoff, solgain, tsolair, mFanCycler, AHflag, mERV_AH, ERV_SRE, mHRV, HRV_ASE, mHRV_AH, capacityc,
+				capacityh, evapcap, gains, airDensityIN, airDensityOUT, airDensityATTIC, airDensitySUP, airDensityRET, 0,
+				innerNorthH, innerSouthH, bulkH, 0, 0, dtau);
+			largestResidual = max(largestResidual, abs(model.idealResidual));
+			if(i > 0)
+				largestResidual = max(largestResidual, abs(bFree[15] - setpoint));
+		}
+		for(int i=0; i < ATTIC_NODES; i++)
+			tempOld[i] = b[i];
+	}
+	house = tempOld[15];
+	attic = tempOld[0];
+	if(load)
+		*load = model.idealLoad;
+	if(residual)
+		*residual = largestResidual;
+}
+
+int main() {
+	double p[NUM_PARAMS] = { 5.3, 1.4, 0.02, 0.05 };
+	Dual<NUM_PARAMS> pDual[NUM_PARAMS];
+	Dual<NUM_PARAMS> houseDual, atticDual;
+	int errors = 0;
+
+	for(int i=0; i < NUM_PARAMS; i++)
+		pDual[i] = Dual<NUM_PARAMS>(p[i], i);
+	heatHour(pDual, houseDual, atticDual);
+
+	cout << setprecision(6);
+	cout << "House " << houseDual << " K, attic " << atticDual << " K" << endl;
+	cout << "Parameter\tdHouse (AD)\tdHouse (FD)\tdAttic (AD)\tdAttic (FD)" << endl;
+	for(int i=0; i < NUM_PARAMS; i++) {
+		double h = 1e-6 * p[i];
+		double pUp[NUM_PARAMS], pDown[NUM_PARAMS];
+		double houseUp, atticUp, houseDown, atticDown;
+		for(int k=0; k < NUM_PARAMS; k++) {
+			pUp[k] = p[k];
+			pDown[k] = p[k];
+		}
+		pUp[i] += h;
+		pDown[i] -= h;
+		heatHour(pUp, houseUp, atticUp);
+		heatHour(pDown, houseDown, atticDown);
+		double dHouse = (houseUp - houseDown) / (2 * h);
+		double dAttic = (atticUp - atticDown) / (2 * h);
+
+		cout << paramName[i] << "\t" << houseDual.d[i] << "\t" << dHouse << "\t" << atticDual.d[i] << "\t" << dAttic << endl;
+		if(abs(houseDual.d[i] - dHouse) > 1e-4 * (abs(dHouse) + 1e-3) || abs(atticDual.d[i] - dAttic) > 1e-4 * (abs(dAttic) + 1e-3))
+			errors++;
+	}
+
+	// lanes against each variant on its own, the lanes iterate until all of them have converged so they can differ
+	// by a fraction of the iteration tolerance
+	Lanes<LANES> pLanes[NUM_PARAMS], houseLanes, atticLanes;
+	for(int i=0; i < NUM_PARAMS; i++) {
+		for(int l=0; l < LANES; l++)
+			pLanes[i][l] = laneParams[i][l];
+	}
+	clock_t start = clock();
+	heatHour(pLanes, houseLanes, atticLanes);
+	double laneTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	double serialTime = 0;
+	cout << "Lane\tHouse (lanes)\tHouse (own)\tAttic (lanes)\tAttic (own)" << endl;
+	for(int l=0; l < LANES; l++) {
+		double pLane[NUM_PARAMS], house, attic;
+		for(int i=0; i < NUM_PARAMS; i++)
+			pLane[i] = laneParams[i][l];
+		start = clock();
+		heatHour(pLane, house, attic);
+		serialTime += (double) (clock() - start) / CLOCKS_PER_SEC;
+		cout << l << "\t" << houseLanes[l] << "\t" << house << "\t" << atticLanes[l] << "\t" << attic << endl;
+		if(abs(houseLanes[l] - house) > 0.05 || abs(atticLanes[l] - attic) > 0.05)
+			errors++;
+	}
+	cout << LANES << " variants: " << serialTime << " s one at a time, " << laneTime << " s in lanes" << endl;
+
+	// the layout instance does the same arithmetic as the general one
+	double houseLayout, atticLayout, houseGeneral, atticGeneral;
+	const int REPEATS = 20;
+	start = clock();
+	for(int i=0; i < REPEATS; i++)
+		heatHour<double, 0>(p, houseLayout, atticLayout);
+	double layoutTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	for(int i=0; i < REPEATS; i++)
+		heatHour<double, HL_GENERAL>(p, houseGeneral, atticGeneral);
+	double generalTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	cout << "Layout " << heatLayout(0, 0, 0) << ": house " << houseLayout << " K, attic " << atticLayout << " K in " << layoutTime
+		<< " s, general: house " << houseGeneral << " K, attic " << atticGeneral << " K in " << generalTime << " s" << endl;
+	if(heatLayout(0, 0, 0) != 0 || houseLayout != houseGeneral || atticLayout != atticGeneral)
+		errors++;
+
+	// the model keeps the building between steps and does the same arithmetic as sub_heat
+	double houseModel, atticModel;
+	heatHourModel(p, houseModel, atticModel);
+	cout << "HeatModel: house " << houseModel << " K, attic " << atticModel << " K" << endl;
+	if(houseModel != houseLayout || atticModel != atticLayout)
+		errors++;
+
+	// ideal loads hold the house on the setpoint with the cooling that takes
+	double houseIdeal, atticIdeal, load, residual;
+	heatHourModel(p, houseIdeal, atticIdeal, 295, &load, &residual);
+	cout << "Ideal loads: house " << houseIdeal << " K, attic " << atticIdeal << " K, cooling load " << -load
+		<< " W, largest residual " << residual << " K" << endl;
+	if(residual > IDEAL_TOLERANCE || abs(houseIdeal - 295) > IDEAL_TOLERANCE || load >= 0)
+		errors++;
+
+	cout << (errors ? "FAILED" : "PASSED") << endl;
+	return errors;
+}
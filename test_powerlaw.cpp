@@ -0,0 +1,92 @@
+/* Power law kernels compared with libm pow() over the pressure differences and exponents of the leakage elements,
+	and timed against a pow() call per element on runs of elements the size of a zone, the vector kernels have to be
+	faster than pow()
+*/
+#include <iostream>
+#include <ctime>
+#include <vector>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+#include "powerlaw.h"
+
+using namespace std;
+
+// to compile: make test_powerlaw, make test builds and runs all the tests
+
+const double MAX_ERROR = 1e-14;		// relative, the rounding of log C + n log|dP| is magnified by its size
+
+int main() {
+	const int N = 20000;
+	vector<double> dP(N), n(N), CIns(N), COuts(N), logCIn(N), logCOut(N), m(N), dmdP(N), a(N);
+	double CIn = 0.012, COut = 0.011;
+	double flowError = 0, slopeError = 0, powerError = 0;
+	int errors = 0;
+
+	// dP from 1e-6 to 1e4 Pa both ways, n from 0.5 to 1
+	for(int i=0; i < N; i++) {
+		dP[i] = ((i % 2) ? -1 : 1) * pow(10, -6 + 10.0 * i / N);
+		n[i] = 0.5 + 0.5 * (i % 17) / 16;
+		CIns[i] = CIn;
+		COuts[i] = COut;
+		logCIn[i] = logCoefficient(CIn);
+		logCOut[i] = logCoefficient(COut);
+	}
+	dP[0] = 0;
+	CIns[2] = 0;
+	logCIn[2] = logCoefficient(0);
+	powerLawFlows(N, dP.data(), n.data(), CIns.data(), COuts.data(), logCIn.data(), logCOut.data(), m.data(), dmdP.data());
+	powerLaw(N, dP.data(), n.data(), a.data());
+
+	for(int i=0; i < N; i++) {
+		double C = (dP[i] >= 0) ? CIn : -COut;
+		if(i == 2)
+			C = 0;
+		double mPow = C * pow(abs(dP[i]), n[i]);
+		double dmdPPow = (dP[i] != 0) ? n[i] * mPow / dP[i] : 0;
+		double aPow = pow(abs(dP[i]), n[i]);
+
+		if(mPow == 0) {
+			if(m[i] != 0 || dmdP[i] != 0)
+				errors++;
+		} else {
+			flowError = max(flowError, abs(m[i] / mPow - 1));
+			slopeError = max(slopeError, abs(dmdP[i] / dmdPPow - 1));
+		}
+		if(aPow == 0) {
+			if(a[i] != 0)
+				errors++;
+		} else {
+			powerError = max(powerError, abs(a[i] / aPow - 1));
+		}
+	}
+	cout << "Largest relative error against pow(): flow " << flowError << ", derivative " << slopeError << ", |dP|^n "
+		<< powerError << endl;
+	if(flowError > MAX_ERROR || slopeError > MAX_ERROR || powerError > MAX_ERROR)
+		errors++;
+
+	// runs of 8 elements, about the leaks of one zone
+	const int RUN = 8;
+	const int REPEATS = 200;
+	clock_t start = clock();
+	for(int r=0; r < REPEATS; r++) {
+		for(int i=0; i + RUN <= N; i += RUN)
+			powerLawFlows(RUN, &dP[i], &n[i], &CIns[i], &COuts[i], &logCIn[i], &logCOut[i], &m[i], &dmdP[i]);
+	}
+	double kernelTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	for(int r=0; r < REPEATS; r++) {
+		for(int i=0; i < N; i++) {
+			m[i] = (dP[i] >= 0) ? CIn * pow(dP[i], n[i]) : -COut * pow(-dP[i], n[i]);
+			dmdP[i] = (dP[i] != 0) ? n[i] * m[i] / dP[i] : 0;
+		}
+	}
+	double powTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	cout << REPEATS * N << " flows: " << kernelTime << " s in the kernel, " << powTime << " s with pow()"
+		<< (POWER_LAW_VECTORS ? "" : " (the kernel calls pow() in this build)") << endl;
+	if(POWER_LAW_VECTORS && kernelTime > powTime)
+		errors++;
+
+	cout << (errors ? "FAILED" : "PASSED") << endl;
+	return errors;
+}
@@ -0,0 +1,78 @@
+/* Batched and table saturation vapor pressures compared with saturationVaporPressure() from -100 C to 100 C,
+	and the throughput of each
+*/
+#include <iostream>
+#include <ctime>
+#include <vector>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+#include "psychro.h"
+#include "constants.h"
+
+using namespace std;
+
+// to compile: make test_psychro, make test builds and runs all the tests
+
+const double MAX_BATCH_ERROR = 5e-14;	// relative, the terms of the exponent cancel to a few times smaller
+const double MAX_TABLE_ERROR = 5e-7;
+
+int main() {
+	const int N = 20001;
+	vector<double> temp(N), exact(N), batch(N), table(N);
+	double batchError = 0, tableError = 0, tableErrorAbove = 0;
+	int errors = 0;
+
+	for(int i=0; i < N; i++)
+		temp[i] = C_TO_K - 100 + 200.0 * i / (N - 1);
+	for(int i=0; i < N; i++)
+		exact[i] = saturationVaporPressure(temp[i]);
+	saturationVaporPressures(N, temp.data(), batch.data());
+	for(int i=0; i < N; i++)
+		table[i] = fastSaturationVaporPressure(temp[i]);
+
+	for(int i=0; i < N; i++) {
+		batchError = max(batchError, abs(batch[i] / exact[i] - 1));
+		tableError = max(tableError, abs(table[i] / exact[i] - 1));
+		if(temp[i] >= C_TO_K - 40)
+			tableErrorAbove = max(tableErrorAbove, abs(table[i] / exact[i] - 1));
+	}
+	cout << "Largest relative error against saturationVaporPressure(): batched " << batchError << ", table " << tableError
+		<< " (" << tableErrorAbove << " above -40 C)" << endl;
+	if(batchError > MAX_BATCH_ERROR || tableError > MAX_TABLE_ERROR)
+		errors++;
+
+	// throughput on the 14 nodes of the moisture model
+	const int NODES = 14;
+	const int REPEATS = 100;
+	double sum = 0;
+	clock_t start = clock();
+	for(int r=0; r < REPEATS; r++) {
+		for(int i=0; i + NODES <= N; i++)
+			for(int k=0; k < NODES; k++)
+				batch[k] = saturationVaporPressure(temp[i + k]);
+		sum += batch[0];
+	}
+	double scalarTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	for(int r=0; r < REPEATS; r++) {
+		for(int i=0; i + NODES <= N; i++)
+			saturationVaporPressures(NODES, &temp[i], &batch[0]);
+		sum += batch[0];
+	}
+	double batchTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	for(int r=0; r < REPEATS; r++) {
+		for(int i=0; i + NODES <= N; i++)
+			for(int k=0; k < NODES; k++)
+				batch[k] = fastSaturationVaporPressure(temp[i + k]);
+		sum += batch[0];
+	}
+	double tableTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	double calls = (double) REPEATS * (N - NODES + 1) * NODES;
+	cout << "Million calls per second: saturationVaporPressure " << calls / scalarTime / 1e6 << ", batched "
+		<< calls / batchTime / 1e6 << ", table " << calls / tableTime / 1e6 << " (" << sum << ")" << endl;
+
+	cout << (errors ? "FAILED" : "PASSED") << endl;
+	return errors;
+}
@@ -0,0 +1,86 @@
+/* Inverse of the wood sorption isotherm with cube roots and on vectors compared with the pow() solution it replaced,
+	and the time each takes for the six wood nodes
+*/
+#include <iostream>
+#include <ctime>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+#include "sorption.h"
+#include "constants.h"
+
+using namespace std;
+
+// to compile: make test_sorption, make test builds and runs all the tests
+
+const double MAX_ERROR = 1e-14;		// moisture content, the cubic roots cancel to a few times smaller
+const int NODES = 6;
+
+// the cubic solution of Moisture::mc_cubic() before the sorption functions
+double mcPow(double pw, int pressure, double temp) {
+	double W = 0.622 * pw / (pressure - pw);
+	const double a1 = B6 / B7;
+	const double a2 = B5 / B7;
+	double a3 = (B4 - W / exp((temp - C_TO_K) / B3)) / B7;
+	double q = (3 * a2 - pow(a1, 2)) / 9;
+	double r = (9 * a1 * a2 - 27 * a3 - 2 * pow(a1, 3)) / 54;
+	double disc = pow(q, 3) + pow(r, 2);
+	double s = pow(r + pow(disc, 0.5), 1.0/3.0);
+	double t = -pow(abs(r - pow(disc,0.5)), 1.0/3.0);
+	return (s + t - a1 / 3);
+}
+
+int main() {
+	const int pressure = 101325;
+	double scalarError = 0, vectorError = 0, roundTrip = 0;
+	double pw[NODES], temp[NODES], factor[NODES], mc[NODES];
+	int errors = 0;
+
+	// moisture contents from 3% to 30% at -30 to 70 C
+	for(int i=0; i <= 100; i++) {
+		for(int k=0; k < NODES; k++) {
+			temp[k] = C_TO_K - 30 + i + 3 * k;
+			factor[k] = sorptionFactor(temp[k]);
+			pw[k] = sorptionVaporPressure(0.03 + 0.045 * k + 0.0004 * i, factor[k], pressure);
+		}
+		sorptionMoistureContents(NODES, pw, factor, pressure, mc);
+		for(int k=0; k < NODES; k++) {
+			double reference = mcPow(pw[k], pressure, temp[k]);
+			double scalar = sorptionMoistureContent(pw[k], factor[k], pressure);
+			scalarError = max(scalarError, abs(scalar - reference));
+			vectorError = max(vectorError, abs(mc[k] - reference));
+			roundTrip = max(roundTrip, abs(scalar - (0.03 + 0.045 * k + 0.0004 * i)));
+		}
+	}
+	cout << "Largest difference from the pow() solution: cube roots " << scalarError << ", vectors "
+		<< vectorError << ", largest moisture content error " << roundTrip << endl;
+	if(scalarError > MAX_ERROR || vectorError > MAX_ERROR || roundTrip > MAX_ERROR)
+		errors++;
+
+	const int REPEATS = 200000;
+	double sum = 0;
+	clock_t start = clock();
+	for(int r=0; r < REPEATS; r++) {
+		for(int k=0; k < NODES; k++)
+			sum += mcPow(pw[k] + r * 1e-6, pressure, temp[k]);
+	}
+	double powTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	for(int r=0; r < REPEATS; r++) {
+		for(int k=0; k < NODES; k++)
+			sum += sorptionMoistureContent(pw[k] + r * 1e-6, factor[k], pressure);
+	}
+	double scalarTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	for(int r=0; r < REPEATS; r++) {
+		pw[0] += 1e-6;
+		sorptionMoistureContents(NODES, pw, factor, pressure, mc);
+		sum += mc[0];
+	}
+	double vectorTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+	cout << REPEATS << " x " << NODES << " nodes: " << powTime << " s with pow(), " << scalarTime << " s with cube roots, "
+		<< vectorTime << " s on vectors (" << sum << ")" << endl;
+
+	cout << (errors ? "FAILED" : "PASSED") << endl;
+	return errors;
+}
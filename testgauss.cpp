@@ -23,6 +23,7 @@ int main() {
 	 double Array[16][16] = {0};
 	 double b[16] = {0};
     int n;
+    SparseMatrix S;
     cin >> n;
 
     vector<double> line(n+1,0);
@@ -41,6 +42,16 @@ int main() {
         b[i] = A[i][n];
     }
 
+    S.resize(n);
+    vector<double> bSparse(n);
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<n; j++) {
+            if (A[i][j] != 0)
+                S[i][j] = A[i][j];
+        }
+        bSparse[i] = A[i][n];
+    }
+
     // Print input
     print(A);
 
@@ -49,6 +60,7 @@ int main() {
     x = gauss(A);
 
 	 MatSEqn(Array, b);
+    S.solve(bSparse);
 
     // Print result
     cout << "Gauss Result:\t";
@@ -56,6 +68,11 @@ int main() {
         cout << x[i] << " ";
     }
     cout << endl;
+    cout << "Sparse Result:\t";
+    for (int i=0; i<n; i++) {
+        cout << bSparse[i] << " ";
+    }
+    cout << endl;
     cout << "MatSEqn Result:\t";
     for (int i=0; i<n; i++) {
         cout << b[i] << " ";
@@ -0,0 +1,97 @@
+#include "timestep.h"
+#include <algorithm>
+#ifdef __APPLE__
+   #include <cmath>        // needed for mac g++
+#endif
+
+using namespace std;
+
+/*
+* TimeStep - TimeStep class constructor
+* @param maxLength - longest step (simulation steps), 1 or less gives fixed steps
+* @param tolerance - local error allowed in any node temperature per step (K)
+*/
+TimeStep::TimeStep(int maxLength, double tolerance) {
+	this->maxLength = (maxLength > 1) ? maxLength : 1;
+	this->tolerance = tolerance;
+	nextLength = 1;
+	lastLength = 0;
+	length = 0;
+	elapsed = 0;
+	steps = 0;
+}
+
+/*
+* begin - decides whether a new step starts this minute, called after the controls have run
+* @param eventInputs - discrete inputs of this minute, any change from the start of the step ends the step
+* @param minutesLeft - simulation steps left in the hour
+* @return true if the equations have to be solved for a new step of length minutes
+*/
+bool TimeStep::begin(vector<double>& eventInputs, int minutesLeft) {
+	bool event = (eventInputs != events);
+
+	if(!event && elapsed < length)
+		return false;
+
+	if(event) {
+		events = eventInputs;
+		lastLength = 0;							// rates before the event say nothing about the next step
+		length = 1;
+	} else {
+		length = nextLength;
+	}
+	if(length > minutesLeft)
+		length = minutesLeft;
+	elapsed = 0;
+	steps++;
+	return true;
+}
+
+/*
+* solved - records the solution of a step and estimates the length of the next one
+* @param startTemps - node temperatures at the start of the step (deg K)
+* @param endTemps - node temperatures at the end of the step (deg K)
+*/
+void TimeStep::solved(vector<double>& startTemps, vector<double>& endTemps) {
+	double curvature = 0;
+
+	start = startTemps;
+	end = endTemps;
+	if(lastRate.size() != start.size())
+		lastLength = 0;
+	lastRate.resize(start.size());
+	for(size_t i=0; i < start.size(); i++) {
+		double rate = (end[i] - start[i]) / length;
+		if(lastLength > 0)
+			curvature = max(curvature, abs(rate - lastRate[i]) / ((length + lastLength) / 2.0));
+		lastRate[i] = rate;
+	}
+
+	if(lastLength == 0) {
+		nextLength = 1;
+	} else if(curvature > 0) {
+		double h = sqrt(2 * tolerance / curvature);
+		nextLength = (h < maxLength) ? (int) h : maxLength;
+	} else {
+		nextLength = maxLength;
+	}
+	nextLength = min(nextLength, 2 * length);
+	nextLength = max(1, min(nextLength, maxLength));
+	lastLength = length;
+}
+
+/*
+* advance - moves on one minute in the current step
+* @param temps - returns the node temperatures at the end of the minute (deg K)
+*/
+void TimeStep::advance(vector<double>& temps) {
+	elapsed++;
+	if(elapsed >= length) {
+		temps = end;
+	} else {
+		double f = (double) elapsed / length;
+		temps.resize(start.size());
+		for(size_t i=0; i < start.size(); i++)
+			temps[i] = start[i] + (end[i] - start[i]) * f;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#ifndef timestep_h
+#define timestep_h
+#include <vector>
+
+using namespace std;
+
+/*
+* TimeStep
+*
+* Adaptive step control for the heat and moisture balances. The controls and outputs still run every minute but
+* the airflow, heat and moisture equations are only solved at the start of each step, for the whole step, and the
+* node temperatures of the minutes in between are interpolated.
+* The step length comes from the local truncation error of the backward Euler heat balance, (h^2 / 2) * |T''|,
+* with T'' estimated from the temperature rates of the last two steps. A change in any of the discrete inputs
+* (air handler, fans, dehumidifier...) ends the step and restarts the control from one minute steps.
+* Steps do not cross the hour so weather and schedule changes always start a new step.
+* Lengths are counted in simulation steps of STEP_SECONDS, which are minutes in the default build.
+*/
+class TimeStep {
+	private:
+		int maxLength;					// longest step (simulation steps), 1 for the original fixed minute steps
+		double tolerance;				// local error allowed in any node temperature per step (K)
+		int nextLength;				// step length from the error estimate (simulation steps)
+		int lastLength;				// length of the last solved step (simulation steps), 0 if there is no rate history
+		vector<double> lastRate;	// node temperature rates of the last solved step (K/simulation step)
+		vector<double> events;		// discrete inputs at the start of the step
+		vector<double> start;		// node temperatures at the start of the step
+		vector<double> end;			// node temperatures at the end of the step
+
+	public:
+		int length;						// length of the current step (simulation steps)
+		int elapsed;					// simulation steps of the current step done so far
+		int steps;						// number of steps solved
+
+		TimeStep(int maxLength, double tolerance);
+		bool begin(vector<double>& eventInputs, int minutesLeft);
+		void solved(vector<double>& startTemps, vector<double>& endTemps);
+		void advance(vector<double>& temps);
+};
+
+#endif
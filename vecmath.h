@@ -0,0 +1,122 @@
+#pragma once
+#ifndef vecmath_h
+#define vecmath_h
+
+#include <cstring>
+#include <cstdint>
+
+/*
+* Vector math
+*
+* exp and log on short vectors of doubles (GCC/clang vector extensions) for the batched kernels of the power law flows
+* and the psychrometrics. Only included by the kernel source files, which are compiled with KERNELFLAGS so the
+* vectors go in the machine's vector registers. vexp and vlog agree with libm to a few units in the last place.
+*/
+
+// doubles in each vector, the width of the vector registers the compiler is allowed to use
+#ifdef __AVX__
+const int VEC_LANES = 4;
+#else
+const int VEC_LANES = 2;
+#endif
+typedef double vdouble __attribute__((vector_size(VEC_LANES * sizeof(double))));
+typedef int64_t vint __attribute__((vector_size(VEC_LANES * sizeof(double))));
+
+// ln 2 split so k ln 2 is exact for the exponents of a double
+const double LN2_HI = 6.93147180369123816490e-01;
+const double LN2_LO = 1.90821492927058770002e-10;
+const double LOG2_E = 1.44269504088896338700e+00;
+const double SQRT2 = 1.41421356237309514547e+00;
+const double EXP_MIN = -708;		// exp() below this is taken as 0, it is below the smallest normal double
+
+// minimax coefficients of the log polynomial in s^2 (fdlibm e_log.c)
+const double Lg1 = 6.666666666666735130e-01;
+const double Lg2 = 3.999999999940941908e-01;
+const double Lg3 = 2.857142874366239149e-01;
+const double Lg4 = 2.222219843214978396e-01;
+const double Lg5 = 1.818357216161805012e-01;
+const double Lg6 = 1.531383769920937332e-01;
+const double Lg7 = 1.479819860511658591e-01;
+
+/*
+* vlog - natural log of positive normal doubles
+* x = 2^k m with sqrt(1/2) <= m < sqrt(2), log(m) = log(1 + f) from the fdlibm polynomial in s = f / (2 + f)
+*/
+static inline vdouble vlog(vdouble x) {
+	vint bits = (vint) x;
+	vint k = ((bits >> 52) & 0x7ff) - 1023;
+	vdouble m = (vdouble) ((bits & 0x000fffffffffffffLL) | 0x3ff0000000000000LL);
+	vint high = (m > SQRT2);				// -1 where true
+	m = (vdouble) ((vint) m + (high & -0x0010000000000000LL));
+	k = k - high;
+
+	vdouble f = m - 1;
+	vdouble s = f / (2 + f);
+	vdouble z = s * s;
+	vdouble w = z * z;
+	vdouble R = w * (Lg2 + w * (Lg4 + w * Lg6)) + z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+	vdouble hfsq = 0.5 * f * f;
+	vdouble dk = __builtin_convertvector(k, vdouble);
+	return dk * LN2_HI - ((hfsq - (s * (hfsq + R) + dk * LN2_LO)) - f);
+}
+
+/*
+* vexp - exp of doubles, 0 below EXP_MIN
+* y = k ln2 + r with |r| <= ln2 / 2, exp(r) from its Taylor series to r^13 and 2^k put into the exponent bits
+*/
+static inline vdouble vexp(vdouble y) {
+	vdouble zero = {0};
+	vdouble yc = (y < EXP_MIN) ? zero + EXP_MIN : y;
+	vdouble t = yc * LOG2_E + 0.5;
+	vdouble kd = __builtin_convertvector(__builtin_convertvector(t, vint), vdouble);
+	kd = (kd > t) ? kd - 1 : kd;			// conversion rounds towards 0
+	vdouble r = (yc - kd * LN2_HI) - kd * LN2_LO;
+
+	vdouble p = zero + 1 / 6227020800.0;
+	p = 1 / 479001600.0 + r * p;
+	p = 1 / 39916800.0 + r * p;
+	p = 1 / 3628800.0 + r * p;
+	p = 1 / 362880.0 + r * p;
+	p = 1 / 40320.0 + r * p;
+	p = 1 / 5040.0 + r * p;
+	p = 1 / 720.0 + r * p;
+	p = 1 / 120.0 + r * p;
+	p = 1 / 24.0 + r * p;
+	p = 1 / 6.0 + r * p;
+	p = 0.5 + r * p;
+	p = 1 + r * p;
+	p = 1 + r * p;
+
+	vdouble e = (vdouble) ((vint) p + (__builtin_convertvector(kd, vint) << 52));
+	return (y < EXP_MIN) ? zero : e;
+}
+
+/*
+* load - next vector of a table, padded with fill past its end
+*/
+static inline vdouble load(const double* a, int count, double fill) {
+	vdouble v;
+	if(count >= VEC_LANES) {
+		memcpy(&v, a, sizeof(v));
+	} else {
+		double tail[VEC_LANES];
+		for(int i=0; i < VEC_LANES; i++)
+			tail[i] = (i < count) ? a[i] : fill;
+		memcpy(&v, tail, sizeof(v));
+	}
+	return v;
+}
+
+/*
+* store - vector into a table, only the first count values past its end
+*/
+static inline void store(double* a, int count, vdouble v) {
+	if(count >= VEC_LANES) {
+		memcpy(a, &v, sizeof(v));
+	} else {
+		for(int i=0; i < count; i++)
+			a[i] = v[i];
+	}
+}
+
+#endif
@@ -4,6 +4,8 @@
 #include <sstream>
 #include <vector>
 #include <string>
+#include <limits>
+#include <algorithm>
 #include "weather.h"
 #include "psychro.h"
 #include "constants.h"
@@ -212,6 +214,43 @@ weatherData Weather::readOneMinuteWeather() {
 	return result;
 }
 
+/*
+ * reopen - opens the weather file again at a position from position(), for a process forked from the one reading it
+ *          as the two would otherwise share the file offset
+ * @param fileName - name of weather file
+ * @param pos - position to carry on reading from
+ */
+void Weather::reopen(string fileName, streampos pos) {
+	weatherFile.close();
+	weatherFile.open(fileName);
+	if(!weatherFile) {
+		throw fileName;
+	}
+	weatherFile.seekg(pos);
+	}
+
+streampos Weather::position() {
+	return weatherFile.tellg();
+	}
+
+/*
+ * skipHours - moves on through the file as if the weather of a number of hours had been read, skipping the lines
+ *             without parsing them so a run can start part way through the year
+ * @param hours - hours to skip
+ */
+void Weather::skipHours(int hours) {
+	long lines = (type == 0) ? 60L * hours : hours - 2;	// the last two hourly rows are read to interpolate between
+
+	for(long i = 0; i < lines; i++) {
+		weatherFile >> ws;
+		weatherFile.ignore(numeric_limits<streamsize>::max(), '\n');
+		}
+	if(type != 0) {
+		for(int i = max(0, 2 - hours); i < 2; i++)
+			nextHour();
+		}
+	}
+
 weatherData Weather::readMinute(int minute) {
 weatherData current;
 
@@ -74,6 +74,9 @@ class Weather {
 		
 		Weather(int terrain, double eaveHeight);
 		void open(string fileName);
+		void reopen(string fileName, streampos pos);
+		streampos position();
+		void skipHours(int hours);
 		weatherData readMinute(int minute);
 		void nextHour();
 		void close();